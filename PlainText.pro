@@ -9,6 +9,8 @@ LIBS += -lz
 SOURCES += \
     src/main.cpp \
     src/engine/application.cpp \
+    src/engine/backupthread.cpp \
+    src/engine/binarysnapshot.cpp \
     src/engine/characterstats.cpp \
     src/engine/commandinterpreter.cpp \
     src/engine/commandregistry.cpp \
@@ -16,26 +18,41 @@ SOURCES += \
     src/engine/diskutil.cpp \
     src/engine/effect.cpp \
     src/engine/engine.cpp \
+    src/engine/filestoragebackend.cpp \
+    src/engine/fileutil.cpp \
     src/engine/gameeventmultipliermap.cpp \
     src/engine/gameexception.cpp \
     src/engine/gameobjectptr.cpp \
     src/engine/gameobjectsyncthread.cpp \
     src/engine/gamethread.cpp \
+    src/engine/gamethreadmetrics.cpp \
+    src/engine/journalstoragebackend.cpp \
+    src/engine/jsonreader.cpp \
+    src/engine/jsonwriter.cpp \
+    src/engine/latencyhistogram.cpp \
+    src/engine/lineofsightcache.cpp \
     src/engine/logthread.cpp \
     src/engine/logutil.cpp \
+    src/engine/messagebatch.cpp \
     src/engine/metatyperegistry.cpp \
     src/engine/modifier.cpp \
+    src/engine/parallelpropagator.cpp \
     src/engine/point3d.cpp \
+    src/engine/roomgraph.cpp \
     src/engine/scriptengine.cpp \
     src/engine/scriptfunction.cpp \
     src/engine/scriptfunctionmap.cpp \
     src/engine/session.cpp \
+    src/engine/storagebackend.cpp \
+    src/engine/tickgroup.cpp \
+    src/engine/timerwheel.cpp \
     src/engine/triggerregistry.cpp \
     src/engine/util.cpp \
     src/engine/vector3d.cpp \
     src/engine/commands/command.cpp \
     src/engine/commands/scriptcommand.cpp \
     src/engine/commands/admin/admincommand.cpp \
+    src/engine/commands/admin/backupcommand.cpp \
     src/engine/commands/admin/copyitemcommand.cpp \
     src/engine/commands/admin/copytriggerscommand.cpp \
     src/engine/commands/admin/execscriptcommand.cpp \
@@ -43,6 +60,7 @@ SOURCES += \
     src/engine/commands/admin/gettriggercommand.cpp \
     src/engine/commands/admin/listmethodscommand.cpp \
     src/engine/commands/admin/listpropscommand.cpp \
+    src/engine/commands/admin/metricscommand.cpp \
     src/engine/commands/admin/reloadscriptscommand.cpp \
     src/engine/commands/admin/removeitemcommand.cpp \
     src/engine/commands/admin/setclasscommand.cpp \
@@ -52,9 +70,12 @@ SOURCES += \
     src/engine/commands/admin/stopservercommand.cpp \
     src/engine/commands/admin/unsettriggercommand.cpp \
     src/engine/commands/api/apicommand.cpp \
+    src/engine/commands/api/backupstartcommand.cpp \
+    src/engine/commands/api/backupstatuscommand.cpp \
     src/engine/commands/api/datagetcommand.cpp \
     src/engine/commands/api/datasetcommand.cpp \
     src/engine/commands/api/logretrievecommand.cpp \
+    src/engine/commands/api/metricsgetcommand.cpp \
     src/engine/commands/api/objectdeletecommand.cpp \
     src/engine/commands/api/objectsetcommand.cpp \
     src/engine/commands/api/objectslistcommand.cpp \
@@ -69,6 +90,7 @@ SOURCES += \
     src/engine/events/deleteobjectevent.cpp \
     src/engine/events/event.cpp \
     src/engine/events/signinevent.cpp \
+    src/engine/events/tickevent.cpp \
     src/engine/events/timerevent.cpp \
     src/engine/gameevents/areaevent.cpp \
     src/engine/gameevents/floodevent.cpp \
@@ -96,6 +118,7 @@ SOURCES += \
     src/engine/gameobjects/weapon.cpp \
     src/engine/logmessages/commandlogmessage.cpp \
     src/engine/logmessages/errorlogmessage.cpp \
+    src/engine/logmessages/gamethreadstatslogmessage.cpp \
     src/engine/logmessages/logmessage.cpp \
     src/engine/logmessages/npctalklogmessage.cpp \
     src/engine/logmessages/playerdeathstatslogmessage.cpp \
@@ -105,15 +128,14 @@ SOURCES += \
     src/interface/httpserver.cpp \
     src/interface/telnetserver.cpp \
     src/interface/websocketserver.cpp \
-    3rdparty/qjson/json_driver.cpp \
-    3rdparty/qjson/json_parser.cpp \
-    3rdparty/qjson/json_scanner.cpp \
     3rdparty/qtiocompressor/qtiocompressor.cpp \
     3rdparty/qtwebsocket/QtWebSocket/QWsServer.cpp \
     3rdparty/qtwebsocket/QtWebSocket/QWsSocket.cpp \
 
 HEADERS += \
     src/engine/application.h \
+    src/engine/backupthread.h \
+    src/engine/binarysnapshot.h \
     src/engine/characterstats.h \
     src/engine/commandinterpreter.h \
     src/engine/commandregistry.h \
@@ -122,27 +144,44 @@ HEADERS += \
     src/engine/diskutil.h \
     src/engine/effect.h \
     src/engine/engine.h \
+    src/engine/filestoragebackend.h \
+    src/engine/fileutil.h \
     src/engine/foreach.h \
     src/engine/gameeventmultipliermap.h \
     src/engine/gameexception.h \
     src/engine/gameobjectptr.h \
+    src/engine/gameobjectsnapshot.h \
     src/engine/gameobjectsyncthread.h \
     src/engine/gamethread.h \
+    src/engine/gamethreadmetrics.h \
+    src/engine/journalstoragebackend.h \
+    src/engine/jsonreader.h \
+    src/engine/jsonwriter.h \
+    src/engine/latencyhistogram.h \
+    src/engine/lineofsightcache.h \
     src/engine/logthread.h \
     src/engine/logutil.h \
+    src/engine/messagebatch.h \
     src/engine/metatyperegistry.h \
     src/engine/modifier.h \
+    src/engine/mpscqueue.h \
+    src/engine/parallelpropagator.h \
     src/engine/point3d.h \
+    src/engine/roomgraph.h \
     src/engine/scriptengine.h \
     src/engine/scriptfunction.h \
     src/engine/scriptfunctionmap.h \
     src/engine/session.h \
+    src/engine/storagebackend.h \
+    src/engine/tickgroup.h \
+    src/engine/timerwheel.h \
     src/engine/triggerregistry.h \
     src/engine/util.h \
     src/engine/vector3d.h \
     src/engine/commands/command.h \
     src/engine/commands/scriptcommand.h \
     src/engine/commands/admin/admincommand.h \
+    src/engine/commands/admin/backupcommand.h \
     src/engine/commands/admin/copyitemcommand.h \
     src/engine/commands/admin/copytriggerscommand.h \
     src/engine/commands/admin/execscriptcommand.h \
@@ -150,6 +189,7 @@ HEADERS += \
     src/engine/commands/admin/gettriggercommand.h \
     src/engine/commands/admin/listmethodscommand.h \
     src/engine/commands/admin/listpropscommand.h \
+    src/engine/commands/admin/metricscommand.h \
     src/engine/commands/admin/reloadscriptscommand.h \
     src/engine/commands/admin/removeitemcommand.h \
     src/engine/commands/admin/setclasscommand.h \
@@ -159,9 +199,12 @@ HEADERS += \
     src/engine/commands/admin/stopservercommand.h \
     src/engine/commands/admin/unsettriggercommand.h \
     src/engine/commands/api/apicommand.h \
+    src/engine/commands/api/backupstartcommand.h \
+    src/engine/commands/api/backupstatuscommand.h \
     src/engine/commands/api/datagetcommand.h \
     src/engine/commands/api/datasetcommand.h \
     src/engine/commands/api/logretrievecommand.h \
+    src/engine/commands/api/metricsgetcommand.h \
     src/engine/commands/api/objectdeletecommand.h \
     src/engine/commands/api/objectsetcommand.h \
     src/engine/commands/api/objectslistcommand.h \
@@ -176,6 +219,7 @@ HEADERS += \
     src/engine/events/deleteobjectevent.h \
     src/engine/events/event.h \
     src/engine/events/signinevent.h \
+    src/engine/events/tickevent.h \
     src/engine/events/timerevent.h \
     src/engine/gameevents/areaevent.h \
     src/engine/gameevents/floodevent.h \
@@ -203,6 +247,7 @@ HEADERS += \
     src/engine/gameobjects/weapon.h \
     src/engine/logmessages/commandlogmessage.h \
     src/engine/logmessages/errorlogmessage.h \
+    src/engine/logmessages/gamethreadstatslogmessage.h \
     src/engine/logmessages/logmessage.h \
     src/engine/logmessages/npctalklogmessage.h \
     src/engine/logmessages/playerdeathstatslogmessage.h \
@@ -212,9 +257,6 @@ HEADERS += \
     src/interface/httpserver.h \
     src/interface/telnetserver.h \
     src/interface/websocketserver.h \
-    3rdparty/qjson/json_parser.hh \
-    3rdparty/qjson/json_driver.hh \
-    3rdparty/qjson/json_scanner.h \
     3rdparty/qtiocompressor/qtiocompressor.h \
     3rdparty/qtwebsocket/QtWebSocket/QWsServer.h \
     3rdparty/qtwebsocket/QtWebSocket/QWsSocket.h \
@@ -19,7 +19,7 @@ TellCommand.prototype.execute = function(player, command) {
     }
 
     var userName = this.takeWord().capitalized();
-    var other = Realm.getPlayer(userName);
+    var other = Realm.getLoadedPlayer(userName);
     if (!other || !other.isOnline()) {
         this.send("%1 is not online.", userName);
         return;
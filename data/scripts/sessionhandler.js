@@ -46,16 +46,36 @@ function SessionHandler() {
                     return;
                 }
 
-                var player = Realm.getPlayer(userName);
-                if (player) {
-                    this.setPlayer(player);
-                    this.setState("AskingPassword");
-                } else if (Realm.reservedNames().contains(userName)) {
-                    send("Yeah right, like I believe that...\n");
-                } else {
-                    signUpData.userName = userName;
-                    this.setState("AskingUserNameConfirmation");
-                }
+                // players that are not in memory are loaded in the background, so that other
+                // players don't have to wait for it
+                var handler = this;
+                this.setState("LoadingPlayer");
+                Realm.getPlayerAsync(userName, function(player) {
+                    if (handler.state !== handler.states["LoadingPlayer"]) {
+                        return;
+                    }
+
+                    if (player) {
+                        handler.setPlayer(player);
+                        handler.setState("AskingPassword");
+                    } else if (Realm.reservedNames().contains(userName)) {
+                        send("Yeah right, like I believe that...\n");
+                        handler.setState("AskingUserName");
+                    } else {
+                        signUpData.userName = userName;
+                        handler.setState("AskingUserNameConfirmation");
+                    }
+
+                    if (handler.state.prompt) {
+                        handler.state.prompt.call(handler);
+                    }
+                });
+            }
+        },
+
+        "LoadingPlayer": {
+            "processInput": function(input) {
+                // input is ignored until the player is loaded
             }
         },
 
@@ -437,8 +457,7 @@ function SessionHandler() {
             "processInput": function(input) {
                 var answer = input.toLower();
                 if (answer === "yes" || answer === "y") {
-                    var player = Realm.getPlayer(signUpData.userName);
-                    if (player) {
+                    if (Realm.hasPlayer(signUpData.userName)) {
                         send("Uh-oh, it appears someone has claimed your character name while " +
                              "you were creating yours. I'm terribly sorry, but it appears you " +
                              "will have to start over.\n");
@@ -446,8 +465,8 @@ function SessionHandler() {
                         return;
                     }
 
-                    player = Realm.createObject("Player");
-                    player.admin = Realm.players().isEmpty();
+                    var player = Realm.createObject("Player");
+                    player.admin = Realm.playerNames().isEmpty();
                     player.name = signUpData.userName;
                     player.race = signUpData.race;
                     player.characterClass = signUpData.characterClass;
@@ -77,7 +77,6 @@ var VisualUtil = (function() {
     function dividePortalsAndCharactersIntoGroups(character, room, strength) {
 
         var groups = deepClone(groupsTemplate);
-        var characters = [];
         for (var i = 0, length = room.portals.length; i < length; i++) {
             var portal = room.portals[i];
             if (portal.isHiddenFromRoom(room)) {
@@ -87,11 +86,6 @@ var VisualUtil = (function() {
             var position = portal.position.minus(room.position);
             var angle = Util.angleBetweenXYVectors(character.direction, position);
 
-            if (portal.canSeeThrough() && Math.abs(angle) < UNDER_QUART_PI) {
-                characters = characters.concat(charactersVisibleThroughPortal(character, room,
-                                                                              portal, strength));
-            }
-
             var name = portal.nameFromRoom(room);
             if (Util.isDirection(name) || name === "out") {
                 continue;
@@ -107,73 +101,44 @@ var VisualUtil = (function() {
                 groups["left"].push(portal);
             }
         }
+
+        var characters = charactersVisibleInDirection(room, character.direction, strength);
         if (characters.length > 0) {
             groups["characters"] = characters;
         }
         return groups;
     }
 
-    function charactersVisibleThroughPortal(character, sourceRoom, portal,
-                                            strength, excludedRooms) {
+    function charactersVisibleThroughPortal(character, sourceRoom, portal, strength) {
 
-        var room = portal.oppositeOf(sourceRoom);
-        var roomStrength = (strength || sourceRoom.eventMultiplier("Visual")) *
-                           portal.eventMultiplier("Visual") *
-                           room.eventMultiplier("Visual");
-        if (roomStrength < 0.1) {
+        if (!portal.canSeeThrough()) {
             return [];
         }
 
-        var vector1 = room.position.minus(sourceRoom.position);
-        var distance = vector1.vectorLength();
+        var direction = portal.position.minus(sourceRoom.position);
+        return charactersVisibleInDirection(sourceRoom, direction, strength);
+    }
 
-        var visitedRooms = excludedRooms || {};
-        visitedRooms[sourceRoom.id] = true;
-        visitedRooms[room.id] = true;
+    function charactersVisibleInDirection(room, direction, strength) {
 
         var characters = [];
-        room.characters.forEach(function(character) {
-            characters.push({
-                "character": character,
-                "strength": roomStrength,
-                "distance": distance
-            });
-        });
-
-        room.portals.forEach(function(nextPortal) {
-            if (!nextPortal.canSeeThrough()) {
-                return;
-            }
-
-            var nextRoom = nextPortal.oppositeOf(room);
-            if (nextRoom === sourceRoom || visitedRooms.hasOwnProperty(nextRoom.id)) {
-                return;
-            }
-
-            var vector2 = nextRoom.position.minus(room.position);
-
-            var flags = room.flags.split("|");
-            if (flags.contains("HasWalls")) {
-                if (vector1[0] !== vector2[0] || vector1[1] !== vector2[1]) {
-                    return;
-                }
-            } else {
-                var vector3 = nextRoom.position.minus(character.currentRoom.position);
-                var angle = Util.angleBetweenXYVectors(character.direction, vector3);
-                if (Math.abs(angle) > UNDER_QUART_PI) {
-                    return;
-                }
-            }
-
-            if ((flags.contains("HasCeiling") && vector2[2] > vector1[2]) ||
-                (flags.contains("HasFloor") && vector2[2] < vector1[2])) {
-                return;
+        var sightLines = room.visibleRooms(strength || room.eventMultiplier("Visual"));
+        for (var i = 0, length = sightLines.length; i < length; i++) {
+            var sightLine = sightLines[i];
+            var vector = sightLine.room.position.minus(room.position);
+            if (Math.abs(Util.angleBetweenXYVectors(direction, vector)) >= UNDER_QUART_PI) {
+                continue;
             }
 
-            characters.append(charactersVisibleThroughPortal(character, room, nextPortal,
-                                                             roomStrength, visitedRooms));
-        });
-
+            var distance = vector.vectorLength();
+            sightLine.room.characters.forEach(function(character) {
+                characters.push({
+                    "character": character,
+                    "strength": sightLine.strength,
+                    "distance": distance
+                });
+            });
+        }
         return characters;
     }
 
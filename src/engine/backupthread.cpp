@@ -0,0 +1,236 @@
+#include "backupthread.h"
+
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QSemaphore>
+
+#include "asyncreplyevent.h"
+#include "binarysnapshot.h"
+#include "gameexception.h"
+#include "gameobjectsyncthread.h"
+#include "jsonwriter.h"
+#include "logutil.h"
+#include "realm.h"
+#include "storagebackend.h"
+#include "util.h"
+
+
+// progress is reported every time another tenth of the objects is written
+static const int NUM_PROGRESS_REPORTS = 10;
+
+// stored players are copied in jobs of this many players, so that the sync thread is not kept
+// from writing modified objects for long
+static const int NUM_PLAYERS_PER_JOB = 100;
+
+
+class BackupThread::CopyStoredPlayersJob : public SyncJob {
+
+    public:
+        CopyStoredPlayersJob(BackupThread *backupThread, BinarySnapshotWriter *writer,
+                             int begin, int end, bool *succeeded, QSemaphore *semaphore) :
+            SyncJob(),
+            m_backupThread(backupThread),
+            m_writer(writer),
+            m_begin(begin),
+            m_end(end),
+            m_succeeded(succeeded),
+            m_semaphore(semaphore) {
+        }
+
+        // released on deletion rather than after running, so that the backup thread doesn't
+        // wait forever for a job that is discarded when the sync thread quits
+        virtual ~CopyStoredPlayersJob() {
+
+            m_semaphore->release();
+        }
+
+        virtual void run(StorageBackend *storageBackend) {
+
+            *m_succeeded = m_backupThread->copyStoredPlayers(storageBackend, m_writer,
+                                                             m_begin, m_end);
+        }
+
+    private:
+        BackupThread *m_backupThread;
+        BinarySnapshotWriter *m_writer;
+        int m_begin;
+        int m_end;
+        bool *m_succeeded;
+        QSemaphore *m_semaphore;
+};
+
+
+BackupThread::BackupThread(GameObjectSyncThread *syncThread) :
+    QThread(),
+    m_syncThread(syncThread),
+    m_recipientId(0),
+    m_numObjects(0),
+    m_numWrittenObjects(0) {
+}
+
+BackupThread::~BackupThread() {
+}
+
+bool BackupThread::startBackup(const QString &path, const QVector<GameObjectSnapshot> &snapshots,
+                               const QStringList &storedKeys, uint recipientId) {
+
+    if (isRunning()) {
+        return false;
+    }
+
+    m_path = path;
+    m_snapshots = snapshots;
+    m_storedKeys = storedKeys;
+    m_recipientId = recipientId;
+
+    m_mutex.lock();
+    m_loadedObjects.clear();
+    m_mutex.unlock();
+
+    m_numObjects = snapshots.size() + storedKeys.size();
+    m_numWrittenObjects = 0;
+
+    start(QThread::LowestPriority);
+    return true;
+}
+
+void BackupThread::addLoadedObject(const QString &key, const QString &jsonString) {
+
+    QMutexLocker locker(&m_mutex);
+    if (!m_loadedObjects.contains(key)) {
+        m_loadedObjects.insert(key, jsonString);
+    }
+}
+
+void BackupThread::run() {
+
+    QElapsedTimer timer;
+    timer.start();
+
+    if (writeBackup()) {
+        LogUtil::logInfo("Backup %1 written in %2 ms", m_path, QString::number(timer.elapsed()));
+        reportProgress(QString("Backup %1 completed.").arg(m_path));
+    } else {
+        reportProgress(QString("Backup %1 failed, see the error log for details.").arg(m_path));
+    }
+
+    // the snapshots keep old property values alive, so they should not outlive the backup
+    m_snapshots.clear();
+    m_storedKeys.clear();
+    m_savedIds.clear();
+    m_copiedKeys.clear();
+
+    m_mutex.lock();
+    m_loadedObjects.clear();
+    m_mutex.unlock();
+}
+
+bool BackupThread::writeBackup() {
+
+    BinarySnapshotWriter writer;
+    JsonWriter jsonWriter;
+
+    int progressStep = qMax(m_numObjects.load() / NUM_PROGRESS_REPORTS, 1);
+
+    for (const GameObjectSnapshot &snapshot : m_snapshots) {
+        jsonWriter.clear();
+        GameObject::writeJson(snapshot, jsonWriter);
+        writer.addObject(snapshot.objectType.toString(), snapshot.id, jsonWriter.toString());
+        m_savedIds.insert(snapshot.id);
+
+        if (++m_numWrittenObjects % progressStep == 0) {
+            reportProgress(QString("Backup %1: %2 of %3 objects written.")
+                           .arg(m_path).arg(m_numWrittenObjects.load())
+                           .arg(m_numObjects.load()));
+        }
+    }
+
+    // the jobs run after the objects that were enqueued before them are written, so players
+    // that were evicted right before the backup started are read back as they were evicted
+    for (int begin = 0; begin < m_storedKeys.size(); begin += NUM_PLAYERS_PER_JOB) {
+        int end = qMin(begin + NUM_PLAYERS_PER_JOB, m_storedKeys.size());
+        bool succeeded = false;
+        QSemaphore semaphore;
+        m_syncThread->enqueueJob(new CopyStoredPlayersJob(this, &writer, begin, end,
+                                                          &succeeded, &semaphore));
+        semaphore.acquire();
+        if (!succeeded) {
+            return false;
+        }
+    }
+
+    QString directory = QFileInfo(m_path).path();
+    if (!QDir(directory).exists() && !QDir().mkpath(directory)) {
+        LogUtil::logError("Could not create backup directory: %1", directory);
+        return false;
+    }
+
+    if (!writer.write(m_path)) {
+        LogUtil::logError("Could not write backup %1", m_path);
+        return false;
+    }
+
+    return true;
+}
+
+bool BackupThread::copyStoredPlayers(StorageBackend *storageBackend,
+                                     BinarySnapshotWriter *writer, int begin, int end) {
+
+    int progressStep = qMax(m_numObjects.load() / NUM_PROGRESS_REPORTS, 1);
+
+    QStringList keys = m_storedKeys.mid(begin, end - begin);
+    for (int i = 0; i < keys.size(); i++) {
+        uint id = keys[i].section('.', 1).toUInt();
+        if (m_copiedKeys.contains(keys[i]) || m_savedIds.contains(id)) {
+            continue;
+        }
+        m_copiedKeys.insert(keys[i]);
+
+        QString jsonString;
+        try {
+            bool found = storageBackend->readObject(keys[i], &jsonString);
+
+            // objects that were loaded after the snapshots were taken may have been written
+            // again since, so the strings they were loaded from take precedence
+            m_mutex.lock();
+            auto it = m_loadedObjects.constFind(keys[i]);
+            if (it != m_loadedObjects.constEnd()) {
+                jsonString = it.value();
+                found = true;
+            }
+            m_mutex.unlock();
+
+            if (!found) {
+                if (!keys[i].startsWith("player.")) {
+                    continue;
+                }
+                throw GameException(GameException::CouldNotOpenGameObjectFile, keys[i]);
+            }
+            Realm::appendItemKeys(GameObject::parseJson(jsonString), &keys);
+        } catch (const GameException &exception) {
+            LogUtil::logError("Could not write backup %1: %2", m_path, exception.what());
+            return false;
+        }
+
+        writer->addObject(Util::capitalize(keys[i].section('.', 0, 0)), id, jsonString);
+
+        // items are not included in the initial count, so they don't report progress
+        if (keys[i].startsWith("player.") && ++m_numWrittenObjects % progressStep == 0) {
+            reportProgress(QString("Backup %1: %2 of %3 objects written.")
+                           .arg(m_path).arg(m_numWrittenObjects.load())
+                           .arg(m_numObjects.load()));
+        }
+    }
+
+    return true;
+}
+
+void BackupThread::reportProgress(const QString &message) {
+
+    LogUtil::logDebug(message);
+
+    if (m_recipientId) {
+        Realm::instance()->enqueueEvent(new AsyncReplyEvent(m_recipientId, message));
+    }
+}
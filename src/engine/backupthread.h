@@ -0,0 +1,85 @@
+#ifndef BACKUPTHREAD_H
+#define BACKUPTHREAD_H
+
+#include <atomic>
+
+#include <QHash>
+#include <QMutex>
+#include <QSet>
+#include <QStringList>
+#include <QThread>
+#include <QVector>
+
+#include "gameobjectsnapshot.h"
+
+
+class BinarySnapshotWriter;
+class GameObjectSyncThread;
+class StorageBackend;
+
+/**
+ * Writes a backup of the entire realm into a single binary snapshot file.
+ *
+ * The game thread hands over snapshots of all objects in memory, all taken at the same event
+ * boundary, which are serialized on this thread while the game continues. Players that are not
+ * in memory are copied from the storage backend instead. The storage backend is only accessed
+ * from the sync thread, so they are copied there, in jobs of limited size. They cannot have been
+ * modified since the snapshots were taken, unless they are loaded in the meantime, in which case
+ * the realm passes the JSON strings it loaded them from through addLoadedObject().
+ */
+class BackupThread : public QThread {
+
+    Q_OBJECT
+
+    public:
+        explicit BackupThread(GameObjectSyncThread *syncThread);
+        virtual ~BackupThread();
+
+        /**
+         * Starts writing a backup to the given path. Returns false if another backup is still
+         * being written.
+         *
+         * @param snapshots Snapshots of all objects in memory that should be saved.
+         * @param storedKeys Keys of players that should be copied from storage, their items are
+         *                   looked up automatically.
+         * @param recipientId ID of a player to send progress reports to, or 0.
+         */
+        bool startBackup(const QString &path, const QVector<GameObjectSnapshot> &snapshots,
+                         const QStringList &storedKeys, uint recipientId = 0);
+
+        void addLoadedObject(const QString &key, const QString &jsonString);
+
+        const QString &path() const { return m_path; }
+
+        int numObjects() const { return m_numObjects; }
+        int numWrittenObjects() const { return m_numWrittenObjects; }
+
+    protected:
+        virtual void run();
+
+    private:
+        class CopyStoredPlayersJob;
+
+        GameObjectSyncThread *m_syncThread;
+
+        QString m_path;
+        QVector<GameObjectSnapshot> m_snapshots;
+        QStringList m_storedKeys;
+        uint m_recipientId;
+
+        QMutex m_mutex;
+        QHash<QString, QString> m_loadedObjects;
+
+        QSet<uint> m_savedIds;
+        QSet<QString> m_copiedKeys;
+
+        std::atomic<int> m_numObjects;
+        std::atomic<int> m_numWrittenObjects;
+
+        bool writeBackup();
+        bool copyStoredPlayers(StorageBackend *storageBackend, BinarySnapshotWriter *writer,
+                               int begin, int end);
+        void reportProgress(const QString &message);
+};
+
+#endif // BACKUPTHREAD_H
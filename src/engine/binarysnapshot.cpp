@@ -0,0 +1,447 @@
+#include "binarysnapshot.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+
+#include <QtEndian>
+
+#include "fileutil.h"
+
+
+static const int HeaderSize = 32;
+static const int ObjectEntrySize = 24;
+static const int PropertyEntrySize = 16;
+static const int StringEntrySize = 16;
+
+
+static void appendUInt32(QByteArray &data, quint32 value) {
+
+    uchar buffer[4];
+    qToLittleEndian(value, buffer);
+    data.append((const char *) buffer, 4);
+}
+
+static void appendUInt64(QByteArray &data, quint64 value) {
+
+    uchar buffer[8];
+    qToLittleEndian(value, buffer);
+    data.append((const char *) buffer, 8);
+}
+
+static bool unescapeJsString(const QString &jsonString, QString &string) {
+
+    if (jsonString.length() < 2 || !jsonString.startsWith('"') || !jsonString.endsWith('"')) {
+        return false;
+    }
+
+    // only the escape sequences generated by ConversionUtil::jsString() are recognized, anything
+    // else is left to the JSON parser
+    string.reserve(jsonString.length() - 2);
+    for (int i = 1; i < jsonString.length() - 1; i++) {
+        QChar character = jsonString[i];
+        if (character == '"') {
+            return false;
+        } else if (character == '\\') {
+            i++;
+            if (i == jsonString.length() - 1) {
+                return false;
+            }
+            character = jsonString[i];
+            if (character == 'n') {
+                string.append('\n');
+            } else if (character == '"' || character == '\\') {
+                string.append(character);
+            } else {
+                return false;
+            }
+        } else {
+            string.append(character);
+        }
+    }
+    return true;
+}
+
+
+BinarySnapshotWriter::BinarySnapshotWriter() {
+}
+
+void BinarySnapshotWriter::addObject(const QString &objectType, uint id,
+                                     const QString &jsonString) {
+
+    ObjectEntry object;
+    object.typeString = stringIndex(objectType.toLower());
+    object.id = id;
+    object.firstProperty = m_properties.size();
+    object.numProperties = 0;
+    object.jsonString = NoString;
+    object.reserved = 0;
+
+    QStringList lines = jsonString.split('\n');
+    bool canonical = (lines.size() >= 2 && lines.first() == "{" && lines.last() == "}");
+    for (int i = 1; canonical && i < lines.size() - 1; i++) {
+        if (!lines[i].isEmpty()) {
+            canonical = addProperty(lines[i]);
+        }
+    }
+
+    if (canonical) {
+        object.numProperties = m_properties.size() - object.firstProperty;
+    } else {
+        m_properties.resize(object.firstProperty);
+        object.jsonString = stringIndex(jsonString);
+    }
+
+    m_objects.append(object);
+}
+
+bool BinarySnapshotWriter::write(const QString &path) {
+
+    std::sort(m_objects.begin(), m_objects.end(),
+              [this](const ObjectEntry &a, const ObjectEntry &b) {
+        return a.typeString == b.typeString ? a.id < b.id :
+                                              m_strings[a.typeString] < m_strings[b.typeString];
+    });
+
+    quint64 stringDataOffset = HeaderSize + ObjectEntrySize * m_objects.size() +
+                               PropertyEntrySize * m_properties.size() +
+                               StringEntrySize * m_strings.size();
+
+    QByteArray data;
+    data.append("PTBS", 4);
+    appendUInt32(data, Version);
+    appendUInt32(data, m_objects.size());
+    appendUInt32(data, m_properties.size());
+    appendUInt32(data, m_strings.size());
+    appendUInt32(data, 0);
+    appendUInt64(data, stringDataOffset);
+
+    for (const ObjectEntry &object : m_objects) {
+        appendUInt32(data, object.typeString);
+        appendUInt32(data, object.id);
+        appendUInt32(data, object.firstProperty);
+        appendUInt32(data, object.numProperties);
+        appendUInt32(data, object.jsonString);
+        appendUInt32(data, object.reserved);
+    }
+
+    for (const PropertyEntry &property : m_properties) {
+        appendUInt32(data, property.nameString);
+        appendUInt32(data, property.type);
+        appendUInt64(data, property.value);
+    }
+
+    quint64 offset = 0;
+    for (const QString &string : m_strings) {
+        appendUInt64(data, offset);
+        appendUInt32(data, string.length());
+        appendUInt32(data, 0);
+        offset += 2 * string.length();
+    }
+
+    Q_ASSERT((quint64) data.size() == stringDataOffset);
+    for (const QString &string : m_strings) {
+        for (const QChar &character : string) {
+            uchar buffer[2];
+            qToLittleEndian(character.unicode(), buffer);
+            data.append((const char *) buffer, 2);
+        }
+    }
+
+    QFile file(path + ".new");
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) ||
+        file.write(data) != data.size() || !file.flush()) {
+        file.remove();
+        return false;
+    }
+    file.close();
+
+    return FileUtil::replaceFile(file.fileName(), path);
+}
+
+quint32 BinarySnapshotWriter::stringIndex(const QString &string) {
+
+    auto it = m_stringIndices.constFind(string);
+    if (it != m_stringIndices.constEnd()) {
+        return it.value();
+    }
+
+    quint32 index = m_strings.size();
+    m_strings.append(string);
+    m_stringIndices.insert(string, index);
+    return index;
+}
+
+bool BinarySnapshotWriter::addProperty(const QString &line) {
+
+    if (!line.startsWith("  \"")) {
+        return false;
+    }
+
+    int nameEnd = line.indexOf("\": ", 3);
+    if (nameEnd == -1) {
+        return false;
+    }
+
+    QString name = line.mid(3, nameEnd - 3);
+    if (name.contains('"') || name.contains('\\')) {
+        return false;
+    }
+
+    QString jsonString = line.mid(nameEnd + 3);
+    if (jsonString.endsWith(',')) {
+        jsonString.chop(1);
+    }
+    if (jsonString.isEmpty()) {
+        return false;
+    }
+
+    PropertyEntry property;
+    property.nameString = stringIndex(name);
+
+    bool isInt, isDouble;
+    qint64 intValue = jsonString.toLongLong(&isInt);
+    double doubleValue = jsonString.toDouble(&isDouble);
+    QString string;
+    if (jsonString == "true" || jsonString == "false") {
+        property.type = BoolValue;
+        property.value = (jsonString == "true");
+    } else if (isInt) {
+        property.type = IntValue;
+        property.value = (quint64) intValue;
+    } else if (isDouble) {
+        property.type = DoubleValue;
+        memcpy(&property.value, &doubleValue, sizeof(double));
+    } else if (unescapeJsString(jsonString, string)) {
+        property.type = StringValue;
+        property.value = stringIndex(string);
+    } else {
+        property.type = JsonValue;
+        property.value = stringIndex(jsonString);
+    }
+
+    m_properties.append(property);
+    return true;
+}
+
+
+BinarySnapshotReader::BinarySnapshotReader(const QString &path) :
+    m_file(path),
+    m_data(nullptr),
+    m_size(0),
+    m_numObjects(0),
+    m_numProperties(0),
+    m_numStrings(0),
+    m_objects(nullptr),
+    m_properties(nullptr),
+    m_strings(nullptr),
+    m_stringData(nullptr) {
+}
+
+BinarySnapshotReader::~BinarySnapshotReader() {
+
+    if (m_data) {
+        m_file.unmap(const_cast<uchar *>(m_data));
+    }
+}
+
+bool BinarySnapshotReader::open() {
+
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    m_size = m_file.size();
+    if (m_size < HeaderSize) {
+        return false;
+    }
+
+    m_data = m_file.map(0, m_size);
+    if (!m_data) {
+        return false;
+    }
+
+    if (memcmp(m_data, "PTBS", 4) != 0 || qFromLittleEndian<quint32>(m_data + 4) != Version) {
+        return false;
+    }
+
+    quint64 numObjects = qFromLittleEndian<quint32>(m_data + 8);
+    quint64 numProperties = qFromLittleEndian<quint32>(m_data + 12);
+    quint64 numStrings = qFromLittleEndian<quint32>(m_data + 16);
+    quint64 stringDataOffset = qFromLittleEndian<quint64>(m_data + 24);
+    if (stringDataOffset != HeaderSize + ObjectEntrySize * numObjects +
+                            PropertyEntrySize * numProperties + StringEntrySize * numStrings ||
+        stringDataOffset > (quint64) m_size) {
+        return false;
+    }
+
+    m_numObjects = numObjects;
+    m_numProperties = numProperties;
+    m_numStrings = numStrings;
+
+    m_objects = m_data + HeaderSize;
+    m_properties = m_objects + ObjectEntrySize * numObjects;
+    m_strings = m_properties + PropertyEntrySize * numProperties;
+    m_stringData = m_data + stringDataOffset;
+
+    // validate all references up front, so that accessors do not need to check anything
+    quint64 stringDataSize = m_size - stringDataOffset;
+    for (int i = 0; i < m_numStrings; i++) {
+        const uchar *entry = m_strings + StringEntrySize * i;
+        quint64 offset = qFromLittleEndian<quint64>(entry);
+        quint64 length = qFromLittleEndian<quint32>(entry + 8);
+        if (offset % 2 != 0 || offset > stringDataSize || 2 * length > stringDataSize - offset) {
+            return false;
+        }
+    }
+
+    for (int i = 0; i < m_numProperties; i++) {
+        PropertyEntry property = propertyEntry(i);
+        if (property.nameString >= numStrings ||
+            property.type < BoolValue || property.type > JsonValue ||
+            ((property.type == StringValue || property.type == JsonValue) &&
+             property.value >= numStrings)) {
+            return false;
+        }
+    }
+
+    for (int i = 0; i < m_numObjects; i++) {
+        ObjectEntry object = objectEntry(i);
+        if (object.typeString >= numStrings ||
+            (object.jsonString != NoString && object.jsonString >= numStrings) ||
+            object.firstProperty > numProperties ||
+            object.numProperties > numProperties - object.firstProperty) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+QString BinarySnapshotReader::objectType(int index) const {
+
+    return string(objectEntry(index).typeString);
+}
+
+uint BinarySnapshotReader::objectId(int index) const {
+
+    return objectEntry(index).id;
+}
+
+QString BinarySnapshotReader::objectKey(int index) const {
+
+    ObjectEntry object = objectEntry(index);
+    return QString("%1.%2").arg(string(object.typeString)).arg(object.id, 9, 10, QChar('0'));
+}
+
+int BinarySnapshotReader::indexOf(const QString &objectType, uint id) const {
+
+    QString type = objectType.toLower();
+
+    int low = 0, high = m_numObjects;
+    while (low < high) {
+        int middle = (low + high) / 2;
+        ObjectEntry object = objectEntry(middle);
+        QString middleType = string(object.typeString);
+        if (middleType < type || (middleType == type && object.id < id)) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+
+    if (low < m_numObjects) {
+        ObjectEntry object = objectEntry(low);
+        if (string(object.typeString) == type && object.id == id) {
+            return low;
+        }
+    }
+    return -1;
+}
+
+QString BinarySnapshotReader::objectJson(int index) const {
+
+    ObjectEntry object = objectEntry(index);
+    return object.jsonString == NoString ? QString() : string(object.jsonString);
+}
+
+QVariantMap BinarySnapshotReader::objectProperties(int index,
+                                                   QMap<QString, QString> *jsonProperties) const {
+
+    QVariantMap properties;
+
+    ObjectEntry object = objectEntry(index);
+    for (quint32 i = 0; i < object.numProperties; i++) {
+        PropertyEntry property = propertyEntry(object.firstProperty + i);
+        QString name = string(property.nameString);
+        switch (property.type) {
+            case BoolValue:
+                properties[name] = (property.value != 0);
+                break;
+            case IntValue: {
+                qint64 value = (qint64) property.value;
+                if (value >= INT_MIN && value <= INT_MAX) {
+                    properties[name] = (int) value;
+                } else {
+                    properties[name] = value;
+                }
+                break;
+            }
+            case DoubleValue: {
+                double value;
+                memcpy(&value, &property.value, sizeof(double));
+                properties[name] = value;
+                break;
+            }
+            case StringValue:
+                properties[name] = string(property.value);
+                break;
+            case JsonValue:
+                jsonProperties->insert(name, string(property.value));
+                break;
+        }
+    }
+
+    return properties;
+}
+
+BinarySnapshot::ObjectEntry BinarySnapshotReader::objectEntry(int index) const {
+
+    Q_ASSERT(index >= 0 && index < m_numObjects);
+    const uchar *entry = m_objects + ObjectEntrySize * index;
+
+    ObjectEntry object;
+    object.typeString = qFromLittleEndian<quint32>(entry);
+    object.id = qFromLittleEndian<quint32>(entry + 4);
+    object.firstProperty = qFromLittleEndian<quint32>(entry + 8);
+    object.numProperties = qFromLittleEndian<quint32>(entry + 12);
+    object.jsonString = qFromLittleEndian<quint32>(entry + 16);
+    object.reserved = 0;
+    return object;
+}
+
+BinarySnapshot::PropertyEntry BinarySnapshotReader::propertyEntry(int index) const {
+
+    Q_ASSERT(index >= 0 && index < m_numProperties);
+    const uchar *entry = m_properties + PropertyEntrySize * index;
+
+    PropertyEntry property;
+    property.nameString = qFromLittleEndian<quint32>(entry);
+    property.type = qFromLittleEndian<quint32>(entry + 4);
+    property.value = qFromLittleEndian<quint64>(entry + 8);
+    return property;
+}
+
+QString BinarySnapshotReader::string(quint32 index) const {
+
+    const uchar *entry = m_strings + StringEntrySize * index;
+    quint64 offset = qFromLittleEndian<quint64>(entry);
+    int length = qFromLittleEndian<quint32>(entry + 8);
+
+    QString result(length, Qt::Uninitialized);
+    const uchar *data = m_stringData + offset;
+    for (int i = 0; i < length; i++) {
+        result[i] = QChar(qFromLittleEndian<quint16>(data + 2 * i));
+    }
+    return result;
+}
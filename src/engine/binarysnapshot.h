@@ -0,0 +1,139 @@
+#ifndef BINARYSNAPSHOT_H
+#define BINARYSNAPSHOT_H
+
+#include <QFile>
+#include <QHash>
+#include <QMap>
+#include <QStringList>
+#include <QVariantMap>
+#include <QVector>
+
+
+/**
+ * Binary snapshot of all game objects, used to speed up loading the realm.
+ *
+ * A snapshot is a single file that can be memory-mapped, consisting of (all integers are
+ * little-endian):
+ *
+ *  - a 32-byte header containing the magic "PTBS", the format version and the table sizes,
+ *  - an object table sorted by object type and ID, with for every object the range of its
+ *    properties in the property table,
+ *  - a property table of fixed-size records, holding booleans, integers and doubles inline and
+ *    referring to the string table for strings and for values that are still JSON encoded,
+ *  - a string table with the offset and length of every (deduplicated) string,
+ *  - the string data, encoded as UTF-16.
+ *
+ * Snapshots are generated from the JSON strings produced by GameObject::toJsonString(). Objects
+ * that are not in the one-property-per-line layout of that function are stored as a complete
+ * JSON string instead.
+ */
+class BinarySnapshot {
+
+    public:
+        enum ValueType {
+            BoolValue = 1,
+            IntValue,
+            DoubleValue,
+            StringValue,
+            JsonValue
+        };
+
+        static const quint32 Version = 1;
+
+    protected:
+        struct ObjectEntry {
+            quint32 typeString;
+            quint32 id;
+            quint32 firstProperty;
+            quint32 numProperties;
+            quint32 jsonString;
+            quint32 reserved;
+        };
+
+        struct PropertyEntry {
+            quint32 nameString;
+            quint32 type;
+            quint64 value;
+        };
+
+        static const quint32 NoString = 0xffffffff;
+};
+
+
+class BinarySnapshotWriter : public BinarySnapshot {
+
+    public:
+        BinarySnapshotWriter();
+
+        void addObject(const QString &objectType, uint id, const QString &jsonString);
+
+        /**
+         * Writes the snapshot to a temporary file first, and only replaces the file at the given
+         * path when writing succeeded.
+         */
+        bool write(const QString &path);
+
+    private:
+        QVector<ObjectEntry> m_objects;
+        QVector<PropertyEntry> m_properties;
+
+        QStringList m_strings;
+        QHash<QString, quint32> m_stringIndices;
+
+        quint32 stringIndex(const QString &string);
+        bool addProperty(const QString &line);
+};
+
+
+class BinarySnapshotReader : public BinarySnapshot {
+
+    public:
+        BinarySnapshotReader(const QString &path);
+        ~BinarySnapshotReader();
+
+        /**
+         * Maps the snapshot into memory and validates all its tables. Returns false if the file
+         * could not be opened, has a different version or is corrupt.
+         */
+        bool open();
+
+        int numObjects() const { return m_numObjects; }
+
+        QString objectType(int index) const;
+        uint objectId(int index) const;
+        QString objectKey(int index) const;
+
+        int indexOf(const QString &objectType, uint id) const;
+
+        /**
+         * Returns the JSON string of an object that was stored as a whole, or an empty string if
+         * the object was stored property by property.
+         */
+        QString objectJson(int index) const;
+
+        /**
+         * Returns the properties of an object. Properties that are still JSON encoded are
+         * returned through jsonProperties instead.
+         */
+        QVariantMap objectProperties(int index, QMap<QString, QString> *jsonProperties) const;
+
+    private:
+        QFile m_file;
+        const uchar *m_data;
+        qint64 m_size;
+
+        int m_numObjects;
+        int m_numProperties;
+        int m_numStrings;
+
+        const uchar *m_objects;
+        const uchar *m_properties;
+        const uchar *m_strings;
+        const uchar *m_stringData;
+
+        ObjectEntry objectEntry(int index) const;
+        PropertyEntry propertyEntry(int index) const;
+        QString string(quint32 index) const;
+};
+
+#endif // BINARYSNAPSHOT_H
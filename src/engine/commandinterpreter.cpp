@@ -1,5 +1,6 @@
 #include "commandinterpreter.h"
 
+#include <QElapsedTimer>
 #include <QRegExp>
 #include <QStringList>
 
@@ -16,7 +17,13 @@
 
 CommandInterpreter::CommandInterpreter(QObject *parent) :
     QObject(parent),
-    m_registry(nullptr) {
+    m_registry(nullptr),
+    m_slowCommandThreshold(100000) {
+
+    QByteArray slowCommandThreshold = qgetenv("PT_SLOW_COMMAND_THRESHOLD");
+    if (!slowCommandThreshold.isEmpty()) {
+        m_slowCommandThreshold = qMax(slowCommandThreshold.toLongLong(), Q_INT64_C(0)) * 1000;
+    }
 }
 
 CommandInterpreter::~CommandInterpreter() {
@@ -47,7 +54,7 @@ void CommandInterpreter::execute(Character *character, const QString &_command)
         }
         if (Util::isDirection(commandName)) {
             words.prepend("go");
-            m_registry->command("go")->execute(character, words.join(" "));
+            executeCommand(m_registry->command("go"), "go", character, words.join(" "));
             return;
         } else {
             Room *currentRoom = character->currentRoom().cast<Room *>();
@@ -67,7 +74,7 @@ void CommandInterpreter::execute(Character *character, const QString &_command)
             }
             if (matchedPortal) {
                 words.prepend("go");
-                m_registry->command("go")->execute(character, words.join(" "));
+                executeCommand(m_registry->command("go"), "go", character, words.join(" "));
                 return;
             }
         }
@@ -75,7 +82,7 @@ void CommandInterpreter::execute(Character *character, const QString &_command)
         QStringList commands;
 
         if (m_registry->contains(commandName)) {
-            m_registry->command(commandName)->execute(character, command);
+            executeCommand(m_registry->command(commandName), commandName, character, command);
             return;
         } else {
             for (const QString &name : m_registry->commandNames()) {
@@ -88,12 +95,14 @@ void CommandInterpreter::execute(Character *character, const QString &_command)
         if (character->isPlayer() && qobject_cast<Player *>(character)->isAdmin()) {
             if (commandName.startsWith("api-")) {
                 if (m_registry->apiCommandsContains(commandName)) {
-                    m_registry->apiCommand(commandName)->execute(character, command);
+                    executeCommand(m_registry->apiCommand(commandName), commandName, character,
+                                   command);
                     return;
                 }
             } else {
                 if (m_registry->adminCommandsContains(commandName)) {
-                    m_registry->adminCommand(commandName)->execute(character, command);
+                    executeCommand(m_registry->adminCommand(commandName), commandName, character,
+                                   command);
                     return;
                 } else {
                     for (const QString &name : m_registry->adminCommandNames()) {
@@ -108,9 +117,10 @@ void CommandInterpreter::execute(Character *character, const QString &_command)
         if (commands.length() == 1) {
             commandName = commands[0];
             if (m_registry->contains(commandName)) {
-                m_registry->command(commandName)->execute(character, command);
+                executeCommand(m_registry->command(commandName), commandName, character, command);
             } else if (m_registry->adminCommandsContains(commandName)) {
-                m_registry->adminCommand(commandName)->execute(character, command);
+                executeCommand(m_registry->adminCommand(commandName), commandName, character,
+                               command);
             }
         } else if (commands.length() > 1) {
             character->send("Command is not unique.");
@@ -135,3 +145,26 @@ void CommandInterpreter::execute(Character *character, const QString &_command)
         }
     }
 }
+
+void CommandInterpreter::resetCommandLatencies() {
+
+    m_commandLatencies.clear();
+}
+
+void CommandInterpreter::executeCommand(Command *command, const QString &commandName,
+                                        Character *character, const QString &commandLine) {
+
+    QElapsedTimer timer;
+    timer.start();
+
+    command->execute(character, commandLine);
+
+    qint64 elapsed = timer.nsecsElapsed() / 1000;
+    m_commandLatencies[commandName].record(elapsed);
+
+    if (m_slowCommandThreshold > 0 && elapsed >= m_slowCommandThreshold) {
+        LogUtil::logInfo("Slow command (%1 ms) by %2: %3",
+                         QString::number(elapsed / 1000.0, 'f', 1), character->name(),
+                         commandLine);
+    }
+}
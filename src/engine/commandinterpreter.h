@@ -1,10 +1,14 @@
 #ifndef COMMANDINTERPRETER_H
 #define COMMANDINTERPRETER_H
 
+#include <QMap>
 #include <QObject>
 
+#include "latencyhistogram.h"
+
 
 class Character;
+class Command;
 class CommandRegistry;
 
 class CommandInterpreter : public QObject {
@@ -19,8 +23,25 @@ class CommandInterpreter : public QObject {
 
         void execute(Character *character, const QString &command);
 
+        /**
+         * Execution times of all commands that have been executed, in microseconds, by command
+         * name.
+         */
+        const QMap<QString, LatencyHistogram> &commandLatencies() const {
+            return m_commandLatencies;
+        }
+        void resetCommandLatencies();
+
+        qint64 slowCommandThreshold() const { return m_slowCommandThreshold; }
+
     private:
         CommandRegistry *m_registry;
+
+        QMap<QString, LatencyHistogram> m_commandLatencies;
+        qint64 m_slowCommandThreshold;
+
+        void executeCommand(Command *command, const QString &commandName, Character *character,
+                            const QString &commandLine);
 };
 
 #endif // COMMANDINTERPRETER_H
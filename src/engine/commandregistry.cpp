@@ -11,6 +11,7 @@
 #include "player.h"
 #include "util.h"
 #include "commands/scriptcommand.h"
+#include "commands/admin/backupcommand.h"
 #include "commands/admin/copyitemcommand.h"
 #include "commands/admin/copytriggerscommand.h"
 #include "commands/admin/execscriptcommand.h"
@@ -18,6 +19,7 @@
 #include "commands/admin/gettriggercommand.h"
 #include "commands/admin/listmethodscommand.h"
 #include "commands/admin/listpropscommand.h"
+#include "commands/admin/metricscommand.h"
 #include "commands/admin/reloadscriptscommand.h"
 #include "commands/admin/removeitemcommand.h"
 #include "commands/admin/setclasscommand.h"
@@ -26,9 +28,12 @@
 #include "commands/admin/settriggercommand.h"
 #include "commands/admin/stopservercommand.h"
 #include "commands/admin/unsettriggercommand.h"
+#include "commands/api/backupstartcommand.h"
+#include "commands/api/backupstatuscommand.h"
 #include "commands/api/datagetcommand.h"
 #include "commands/api/datasetcommand.h"
 #include "commands/api/logretrievecommand.h"
+#include "commands/api/metricsgetcommand.h"
 #include "commands/api/objectdeletecommand.h"
 #include "commands/api/objectsetcommand.h"
 #include "commands/api/objectslistcommand.h"
@@ -43,6 +48,7 @@
 CommandRegistry::CommandRegistry(QObject *parent) :
     QObject(parent) {
 
+    m_adminCommands.insert("backup", new BackupCommand(this));
     m_adminCommands.insert("copy-item", new CopyItemCommand(this));
     m_adminCommands.insert("copy-triggers", new CopyTriggersCommand(this));
     m_adminCommands.insert("exec-script", new ExecScriptCommand(this));
@@ -50,6 +56,7 @@ CommandRegistry::CommandRegistry(QObject *parent) :
     m_adminCommands.insert("get-trigger", new GetTriggerCommand(this));
     m_adminCommands.insert("list-methods", new ListMethodsCommand(this));
     m_adminCommands.insert("list-props", new ListPropsCommand(this));
+    m_adminCommands.insert("metrics", new MetricsCommand(this));
     m_adminCommands.insert("reload-scripts", new ReloadScriptsCommand(this));
     m_adminCommands.insert("remove-item", new RemoveItemCommand(this));
     m_adminCommands.insert("set-class", new SetClassCommand(this));
@@ -59,9 +66,12 @@ CommandRegistry::CommandRegistry(QObject *parent) :
     m_adminCommands.insert("stop-server", new StopServerCommand(this));
     m_adminCommands.insert("unset-trigger", new UnsetTriggerCommand(this));
 
+    m_apiCommands.insert("api-backup-start", new BackupStartCommand(this));
+    m_apiCommands.insert("api-backup-status", new BackupStatusCommand(this));
     m_apiCommands.insert("api-data-get", new DataGetCommand(this));
     m_apiCommands.insert("api-data-set", new DataSetCommand(this));
     m_apiCommands.insert("api-log-retrieve", new LogRetrieveCommand(this));
+    m_apiCommands.insert("api-metrics-get", new MetricsGetCommand(this));
     m_apiCommands.insert("api-object-delete", new ObjectDeleteCommand(this));
     m_apiCommands.insert("api-object-set", new ObjectSetCommand(this));
     m_apiCommands.insert("api-objects-list", new ObjectsListCommand(this));
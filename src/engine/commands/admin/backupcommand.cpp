@@ -0,0 +1,57 @@
+#include "backupcommand.h"
+
+#include "player.h"
+#include "realm.h"
+
+
+#define super AdminCommand
+
+BackupCommand::BackupCommand(QObject *parent) :
+    super(parent) {
+
+    setDescription("Write a consistent backup of the entire realm in the background. The "
+                   "backup is written to the backup directory in the data directory, using the "
+                   "given file name or a name based on the current time.\n"
+                   "\n"
+                   "Usage: backup [<file-name>]\n"
+                   "       backup status");
+}
+
+BackupCommand::~BackupCommand() {
+}
+
+void BackupCommand::execute(Character *character, const QString &command) {
+
+    super::prepareExecute(character, command);
+
+    const BackupThread &backupThread = realm()->backupThread();
+
+    QString fileName = takeWord();
+    if (fileName == "status") {
+        if (realm()->isTakingBackupSnapshots()) {
+            send(QString("Backup %1 in progress, snapshots of %2 of %3 objects taken.")
+                 .arg(realm()->backupPath()).arg(realm()->numBackupSnapshots())
+                 .arg(realm()->numBackupObjects()));
+        } else if (backupThread.isRunning()) {
+            send(QString("Backup %1 in progress, %2 of %3 objects written.")
+                 .arg(backupThread.path()).arg(backupThread.numWrittenObjects())
+                 .arg(backupThread.numObjects()));
+        } else {
+            send("No backup in progress.");
+        }
+        return;
+    }
+
+    QString path = Realm::backupFilePath(fileName);
+    if (path.isEmpty()) {
+        send("Invalid file name.");
+        return;
+    }
+
+    if (!realm()->startBackup(path, qobject_cast<Player *>(character))) {
+        send("Backup %1 is still in progress.", realm()->backupPath());
+        return;
+    }
+
+    send("Backup %1 started.", path);
+}
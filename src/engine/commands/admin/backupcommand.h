@@ -0,0 +1,18 @@
+#ifndef BACKUPCOMMAND_H
+#define BACKUPCOMMAND_H
+
+#include "admincommand.h"
+
+
+class BackupCommand : public AdminCommand {
+
+    Q_OBJECT
+
+    public:
+        BackupCommand(QObject *parent = 0);
+        virtual ~BackupCommand();
+
+        virtual void execute(Character *character, const QString &command);
+};
+
+#endif // BACKUPCOMMAND_H
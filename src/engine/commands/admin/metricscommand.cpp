@@ -0,0 +1,93 @@
+#include "metricscommand.h"
+
+#include <algorithm>
+
+#include <QPair>
+#include <QVector>
+
+#include "commandinterpreter.h"
+#include "realm.h"
+#include "util.h"
+
+
+static QString formatMilliseconds(qint64 microseconds) {
+
+    return QString::number(microseconds / 1000.0, 'f', 2).rightJustified(10);
+}
+
+
+#define super AdminCommand
+
+MetricsCommand::MetricsCommand(QObject *parent) :
+    super(parent) {
+
+    setDescription("Show the load of the game thread during the last minute, how many writes "
+                   "to storage the modifications of objects took, and how often every command "
+                   "was executed and how long it took, from the slowest to the fastest command. "
+                   "Use reset to start measuring the commands again.\n"
+                   "\n"
+                   "Usage: metrics [reset]");
+}
+
+MetricsCommand::~MetricsCommand() {
+}
+
+void MetricsCommand::execute(Character *player, const QString &command) {
+
+    super::prepareExecute(player, command);
+
+    CommandInterpreter *interpreter = realm()->commandInterpreter();
+
+    if (takeWord() == "reset") {
+        interpreter->resetCommandLatencies();
+        send("Command metrics reset.");
+        return;
+    }
+
+    GameThreadSample summary = realm()->gameThreadMetrics().summary(60);
+    send(Util::highlight("Game thread, last minute:"));
+    send(QString("  %1 events per second, busy %2% of the time, %3 events queued now\n"
+                 "  Queue depth at most %4, time in queue %5 ms on average, at most %6 ms\n"
+                 "  Timers late by at most %7 ms\n")
+         .arg(summary.eventsPerSecond()).arg(summary.utilization())
+         .arg(realm()->eventQueueDepth()).arg(summary.maxQueueDepth)
+         .arg(summary.averageQueueTime / 1000.0, 0, 'f', 2)
+         .arg(summary.maxQueueTime / 1000.0, 0, 'f', 2).arg(summary.maxTimerLateness));
+
+    const GameObjectSyncThread &syncThread = realm()->syncThread();
+    quint64 numWrites = syncThread.numWrites();
+    quint64 numModifications = syncThread.numModifications();
+    send(Util::highlight("Storage, since startup:"));
+    send(QString("  %1 writes for %2 modifications, %3 modifications per write\n")
+         .arg(numWrites).arg(numModifications)
+         .arg(numWrites > 0 ? (double) numModifications / numWrites : 0.0, 0, 'f', 2));
+
+    const QMap<QString, LatencyHistogram> &latencies = interpreter->commandLatencies();
+    if (latencies.isEmpty()) {
+        send("No commands have been executed yet.");
+        return;
+    }
+
+    // sorted by p99, from the slowest command to the fastest
+    QVector<QPair<qint64, QString> > commands;
+    for (auto it = latencies.constBegin(); it != latencies.constEnd(); ++it) {
+        commands.append(qMakePair(-it.value().percentile(99), it.key()));
+    }
+    std::sort(commands.begin(), commands.end());
+
+    send(Util::highlight(QString("Command").leftJustified(20) + "     Count    p50 ms    p99 ms"
+                         "    max ms"));
+    for (const auto &entry : commands) {
+        const LatencyHistogram &histogram = latencies[entry.second];
+        send(entry.second.leftJustified(20) +
+             QString::number(histogram.count()).rightJustified(10) +
+             formatMilliseconds(histogram.percentile(50)) +
+             formatMilliseconds(histogram.percentile(99)) +
+             formatMilliseconds(histogram.max()));
+    }
+
+    if (interpreter->slowCommandThreshold() > 0) {
+        send("\nCommands taking more than %1 ms are logged.",
+             QString::number(interpreter->slowCommandThreshold() / 1000));
+    }
+}
@@ -0,0 +1,18 @@
+#ifndef METRICSCOMMAND_H
+#define METRICSCOMMAND_H
+
+#include "admincommand.h"
+
+
+class MetricsCommand : public AdminCommand {
+
+    Q_OBJECT
+
+    public:
+        MetricsCommand(QObject *parent = 0);
+        virtual ~MetricsCommand();
+
+        virtual void execute(Character *character, const QString &command);
+};
+
+#endif // METRICSCOMMAND_H
@@ -1,6 +1,7 @@
 #include "apicommand.h"
 
 #include "conversionutil.h"
+#include "jsonwriter.h"
 #include "realm.h"
 
 
@@ -22,16 +23,22 @@ void ApiCommand::prepareExecute(Character *player, const QString &command) {
 
 void ApiCommand::sendReply(const QVariant &variant) {
 
-    QString data = ConversionUtil::toJsonString(variant);
-    if (data.isEmpty()) {
-        data = "\"\"";
+    JsonWriter data;
+    if (!data.writeVariant(variant)) {
+        data.writeRaw("\"\"", 2);
     }
-    send(QString("{ "
-                 "\"requestId\": \"%1\", "
-                 "\"errorCode\": 0, "
-                 "\"errorMessage\": \"\", "
-                 "\"data\": %2 "
-                 "}").arg(m_requestId, data));
+    sendReply(data);
+}
+
+void ApiCommand::sendReply(const JsonWriter &data) {
+
+    JsonWriter writer(data.size() + 128);
+    writer.writeRaw("{ \"requestId\": \"");
+    writer.writeRaw(m_requestId);
+    writer.writeRaw("\", \"errorCode\": 0, \"errorMessage\": \"\", \"data\": ");
+    writer.writeRaw(data.data());
+    writer.writeRaw(" }", 2);
+    send(writer.toString());
 }
 
 void ApiCommand::sendError(int errorCode, const QString &errorMessage) {
@@ -4,6 +4,8 @@
 #include "admincommand.h"
 
 
+class JsonWriter;
+
 class ApiCommand : public AdminCommand {
 
     Q_OBJECT
@@ -18,6 +20,7 @@ class ApiCommand : public AdminCommand {
         virtual void prepareExecute(Character *character, const QString &command);
 
         void sendReply(const QVariant &variant);
+        void sendReply(const JsonWriter &data);
         void sendError(int errorCode, const QString &errorMessage);
 
     private:
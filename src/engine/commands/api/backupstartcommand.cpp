@@ -0,0 +1,41 @@
+#include "backupstartcommand.h"
+
+#include "realm.h"
+
+
+#define super ApiCommand
+
+BackupStartCommand::BackupStartCommand(QObject *parent) :
+    super(parent) {
+
+    setDescription("Syntax: api-backup-start <request-id> [<file-name>]\n"
+                   "\n"
+                   "Starts writing a backup of the entire realm in the background, to the "
+                   "backup directory in the data directory, using the given file name or a name "
+                   "based on the current time. Returns the path of the backup, use "
+                   "api-backup-status to follow its progress.");
+}
+
+BackupStartCommand::~BackupStartCommand() {
+}
+
+void BackupStartCommand::execute(Character *character, const QString &command) {
+
+    super::prepareExecute(character, command);
+
+    QString path = Realm::backupFilePath(takeWord());
+    if (path.isEmpty()) {
+        sendError(400, "Invalid file name");
+        return;
+    }
+
+    // progress reports are plain text, so they are not sent to API clients
+    if (!realm()->startBackup(path)) {
+        sendError(409, "Another backup is still in progress");
+        return;
+    }
+
+    QVariantMap data;
+    data["path"] = path;
+    sendReply(data);
+}
@@ -0,0 +1,16 @@
+#ifndef BACKUPSTARTCOMMAND_H
+#define BACKUPSTARTCOMMAND_H
+
+#include "apicommand.h"
+
+
+class BackupStartCommand : public ApiCommand {
+
+    public:
+        BackupStartCommand(QObject *parent = 0);
+        virtual ~BackupStartCommand();
+
+        virtual void execute(Character *character, const QString &command);
+};
+
+#endif // BACKUPSTARTCOMMAND_H
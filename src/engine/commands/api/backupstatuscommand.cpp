@@ -0,0 +1,41 @@
+#include "backupstatuscommand.h"
+
+#include "realm.h"
+
+
+#define super ApiCommand
+
+BackupStatusCommand::BackupStatusCommand(QObject *parent) :
+    super(parent) {
+
+    setDescription("Syntax: api-backup-status <request-id>\n"
+                   "\n"
+                   "Returns whether a backup is in progress, and if so, its path, its stage and "
+                   "how many of its objects are done. In the \"snapshots\" stage, snapshots of "
+                   "the objects in memory are taken, in the \"writing\" stage, the backup is "
+                   "written to disk.");
+}
+
+BackupStatusCommand::~BackupStatusCommand() {
+}
+
+void BackupStatusCommand::execute(Character *character, const QString &command) {
+
+    super::prepareExecute(character, command);
+
+    QVariantMap data;
+    data["inProgress"] = realm()->isBackupInProgress();
+    if (realm()->isTakingBackupSnapshots()) {
+        data["path"] = realm()->backupPath();
+        data["stage"] = "snapshots";
+        data["numDone"] = realm()->numBackupSnapshots();
+        data["numObjects"] = realm()->numBackupObjects();
+    } else if (realm()->isBackupInProgress()) {
+        const BackupThread &backupThread = realm()->backupThread();
+        data["path"] = backupThread.path();
+        data["stage"] = "writing";
+        data["numDone"] = backupThread.numWrittenObjects();
+        data["numObjects"] = backupThread.numObjects();
+    }
+    sendReply(data);
+}
@@ -0,0 +1,16 @@
+#ifndef BACKUPSTATUSCOMMAND_H
+#define BACKUPSTATUSCOMMAND_H
+
+#include "apicommand.h"
+
+
+class BackupStatusCommand : public ApiCommand {
+
+    public:
+        BackupStatusCommand(QObject *parent = 0);
+        virtual ~BackupStatusCommand();
+
+        virtual void execute(Character *character, const QString &command);
+};
+
+#endif // BACKUPSTATUSCOMMAND_H
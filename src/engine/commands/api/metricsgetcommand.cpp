@@ -0,0 +1,95 @@
+#include "metricsgetcommand.h"
+
+#include "commandinterpreter.h"
+#include "commandregistry.h"
+#include "jsonwriter.h"
+#include "realm.h"
+#include "scriptcommand.h"
+
+
+static void writeSample(JsonWriter &writer, const GameThreadSample &sample) {
+
+    writer.writeRaw("{ \"timestamp\": ");
+    writer.writeInt(sample.timestamp);
+    writer.writeRaw(", \"eventsPerSecond\": ");
+    writer.writeInt(sample.eventsPerSecond());
+    writer.writeRaw(", \"utilization\": ");
+    writer.writeInt(sample.utilization());
+    writer.writeRaw(", \"maxQueueDepth\": ");
+    writer.writeInt(sample.maxQueueDepth);
+    writer.writeRaw(", \"averageQueueTime\": ");
+    writer.writeInt(sample.averageQueueTime);
+    writer.writeRaw(", \"maxQueueTime\": ");
+    writer.writeInt(sample.maxQueueTime);
+    writer.writeRaw(", \"maxTimerLateness\": ");
+    writer.writeInt(sample.maxTimerLateness);
+    writer.writeRaw(" }", 2);
+}
+
+
+#define super ApiCommand
+
+MetricsGetCommand::MetricsGetCommand(QObject *parent) :
+    super(parent) {
+
+    setDescription("Syntax: api-metrics-get <request-id>\n"
+                   "\n"
+                   "Returns the number of executions and the p50, p99 and maximum execution "
+                   "times, in microseconds, of every command, the samples of the load of the "
+                   "game thread, one per second, and the number of modifications of objects "
+                   "and writes to storage since startup. Queue times are in microseconds, timer "
+                   "lateness in milliseconds and utilization in percent.");
+}
+
+MetricsGetCommand::~MetricsGetCommand() {
+}
+
+void MetricsGetCommand::execute(Character *player, const QString &command) {
+
+    super::prepareExecute(player, command);
+
+    CommandRegistry *registry = realm()->commandRegistry();
+    const QMap<QString, LatencyHistogram> &latencies =
+            realm()->commandInterpreter()->commandLatencies();
+
+    JsonWriter data(128 + 96 * latencies.size() + 160 * GameThreadMetrics::NumSamples);
+    data.writeRaw("{ \"commands\": { ");
+    for (auto it = latencies.constBegin(); it != latencies.constEnd(); ++it) {
+        if (it != latencies.constBegin()) {
+            data.writeRaw(", ", 2);
+        }
+        const LatencyHistogram &histogram = it.value();
+        bool isScript = registry->contains(it.key()) &&
+                        qobject_cast<ScriptCommand *>(registry->command(it.key()));
+
+        data.writeString(it.key());
+        data.writeRaw(": { \"count\": ");
+        data.writeUInt(histogram.count());
+        data.writeRaw(", \"p50\": ");
+        data.writeInt(histogram.percentile(50));
+        data.writeRaw(", \"p99\": ");
+        data.writeInt(histogram.percentile(99));
+        data.writeRaw(", \"max\": ");
+        data.writeInt(histogram.max());
+        data.writeRaw(", \"script\": ");
+        data.writeBool(isScript);
+        data.writeRaw(" }", 2);
+    }
+    data.writeRaw(" }, \"gameThread\": { \"queueDepth\": ");
+    data.writeInt(realm()->eventQueueDepth());
+    data.writeRaw(", \"samples\": [ ");
+    QVector<GameThreadSample> samples = realm()->gameThreadMetrics().samples();
+    for (int i = 0; i < samples.size(); i++) {
+        if (i > 0) {
+            data.writeRaw(", ", 2);
+        }
+        writeSample(data, samples[i]);
+    }
+    const GameObjectSyncThread &syncThread = realm()->syncThread();
+    data.writeRaw(" ] }, \"storage\": { \"modifications\": ");
+    data.writeUInt(syncThread.numModifications());
+    data.writeRaw(", \"writes\": ");
+    data.writeUInt(syncThread.numWrites());
+    data.writeRaw(" } }", 4);
+    sendReply(data);
+}
@@ -0,0 +1,16 @@
+#ifndef METRICSGETCOMMAND_H
+#define METRICSGETCOMMAND_H
+
+#include "apicommand.h"
+
+
+class MetricsGetCommand : public ApiCommand {
+
+    public:
+        MetricsGetCommand(QObject *parent = 0);
+        virtual ~MetricsGetCommand();
+
+        virtual void execute(Character *character, const QString &command);
+};
+
+#endif // METRICSGETCOMMAND_H
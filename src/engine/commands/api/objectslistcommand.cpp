@@ -1,6 +1,7 @@
 #include "objectslistcommand.h"
 
 #include "gameobject.h"
+#include "jsonwriter.h"
 #include "realm.h"
 #include "util.h"
 
@@ -26,10 +27,24 @@ void ObjectsListCommand::execute(Character *player, const QString &command) {
         return;
     }
 
+    // every object is sent as a string containing its JSON representation
     QVector<GameObject *> objects = realm()->allObjects(objectType);
-    QStringList data;
-    for (GameObject *object : objects) {
-        data.append(object->toJsonString());
+    if (objects.isEmpty()) {
+        sendReply(QStringList());
+        return;
+    }
+
+    JsonWriter data(64 * objects.size());
+    JsonWriter objectWriter;
+    data.writeRaw("[ ", 2);
+    for (int i = 0; i < objects.size(); i++) {
+        if (i > 0) {
+            data.writeRaw(", ", 2);
+        }
+        objectWriter.clear();
+        objects[i]->writeJson(objectWriter);
+        data.writeString(objectWriter.data());
     }
+    data.writeRaw(" ]", 2);
     sendReply(data);
 }
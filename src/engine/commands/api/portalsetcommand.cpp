@@ -1,10 +1,9 @@
 #include "portalsetcommand.h"
 
-#include "qjson/json_driver.hh"
-
 #include "area.h"
 #include "conversionutil.h"
 #include "gameexception.h"
+#include "jsonreader.h"
 #include "point3d.h"
 #include "portal.h"
 #include "realm.h"
@@ -27,11 +26,10 @@ void PortalSetCommand::execute(Character *player, const QString &command) {
 
     super::prepareExecute(player, command);
 
-    bool error;
-    JSonDriver driver;
+    bool ok;
     QString jsonString = takeRest();
-    QVariantMap map = driver.parse(jsonString, &error).toMap();
-    if (error) {
+    QVariantMap map = JsonReader::parse(jsonString, &ok).toMap();
+    if (!ok) {
         throw GameException(GameException::InvalidGameObjectJson, jsonString);
     }
 
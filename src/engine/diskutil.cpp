@@ -24,11 +24,6 @@ bool DiskUtil::writeFile(const QString &path, const QString &content) {
     return (bytesWritten != -1);
 }
 
-bool DiskUtil::writeGameObject(const QString &objectType, uint id, const QString &content) {
-
-    return writeFile(gameObjectPath(objectType, id), content);
-}
-
 QString DiskUtil::dataDir() {
 
     static QString path;
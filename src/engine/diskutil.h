@@ -9,8 +9,6 @@ class DiskUtil {
     public:
         static bool writeFile(const QString &path, const QString &content);
 
-        static bool writeGameObject(const QString &objectType, uint id, const QString &content);
-
         static QString dataDir();
 
         static QStringList dataDirFileList(const QString &subdirectory = "/");
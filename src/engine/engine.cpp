@@ -8,6 +8,7 @@
 #include "gameexception.h"
 #include "httpserver.h"
 #include "logutil.h"
+#include "messagebatch.h"
 #include "realm.h"
 #include "scriptengine.h"
 #include "telnetserver.h"
@@ -24,7 +25,8 @@ Engine::Engine() :
     m_scriptEngine(nullptr),
     m_realm(nullptr),
     m_util(nullptr),
-    m_logUtil(nullptr) {
+    m_logUtil(nullptr),
+    m_messageBatchDispatcher(nullptr) {
 
     qsrand(QDateTime::currentMSecsSinceEpoch());
 }
@@ -39,6 +41,9 @@ bool Engine::start(Options options) {
         m_util = new Util();
         m_logUtil = new LogUtil();
 
+        // the sessions live in this thread, so this is where message batches are delivered
+        m_messageBatchDispatcher = new MessageBatchDispatcher();
+
         m_realm->setScriptEngine(m_scriptEngine);
         m_scriptEngine->setGlobalObject("CommandRegistry", m_realm->commandRegistry());
         m_scriptEngine->setGlobalObject("LogUtil", m_logUtil);
@@ -88,6 +93,7 @@ Engine::~Engine() {
     m_scriptEngine->unsetGlobalObject("TriggerRegistry");
     m_scriptEngine->unsetGlobalObject("Util");
 
+    delete m_messageBatchDispatcher;
     delete m_logUtil;
     delete m_util;
     delete m_realm;
@@ -8,6 +8,7 @@
 
 class HttpServer;
 class LogUtil;
+class MessageBatchDispatcher;
 class Realm;
 class ScriptEngine;
 class TelnetServer;
@@ -33,6 +34,8 @@ class Engine : public QObject {
         Realm *m_realm;
         Util *m_util;
         LogUtil *m_logUtil;
+
+        MessageBatchDispatcher *m_messageBatchDispatcher;
 };
 
 #endif // ENGINE_H
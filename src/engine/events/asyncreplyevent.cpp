@@ -2,11 +2,12 @@
 
 #include "logutil.h"
 #include "player.h"
+#include "realm.h"
 
 
-AsyncReplyEvent::AsyncReplyEvent(Player *recipient, const QString &reply) :
+AsyncReplyEvent::AsyncReplyEvent(uint recipientId, const QString &reply) :
     Event(),
-    m_recipient(recipient),
+    m_recipientId(recipientId),
     m_reply(reply) {
 }
 
@@ -15,12 +16,14 @@ AsyncReplyEvent::~AsyncReplyEvent() {
 
 void AsyncReplyEvent::process() {
 
-    if (!m_recipient) {
-        LogUtil::logDebug("Processing uninitialized async reply event. Skipped.");
+    GameObject *object = Realm::instance()->getObject(GameObjectType::Player, m_recipientId);
+    Player *recipient = qobject_cast<Player *>(object);
+    if (!recipient) {
+        LogUtil::logDebug("Recipient of async reply event no longer exists. Skipped.");
         return;
     }
 
-    m_recipient->send(m_reply);
+    recipient->send(m_reply);
 }
 
 QString AsyncReplyEvent::toString() const {
@@ -4,12 +4,10 @@
 #include "event.h"
 
 
-class Player;
-
 class AsyncReplyEvent : public Event {
 
     public:
-        AsyncReplyEvent(Player *recipient, const QString &reply);
+        AsyncReplyEvent(uint recipientId, const QString &reply);
         virtual ~AsyncReplyEvent();
 
         virtual void process();
@@ -17,7 +15,7 @@ class AsyncReplyEvent : public Event {
         virtual QString toString() const;
 
     private:
-        Player *m_recipient;
+        uint m_recipientId;
         QString m_reply;
 };
 
@@ -1,7 +1,8 @@
 #include "event.h"
 
 
-Event::Event() {
+Event::Event() :
+    m_enqueueTime(0) {
 }
 
 Event::~Event() {
@@ -2,6 +2,7 @@
 #define EVENT_H
 
 #include <QString>
+#include <QtGlobal>
 
 
 class Event {
@@ -13,6 +14,15 @@ class Event {
         virtual void process() = 0;
 
         virtual QString toString() const = 0;
+
+        /**
+         * Time at which the event was enqueued, in nanoseconds since the game thread started.
+         */
+        qint64 enqueueTime() const { return m_enqueueTime; }
+        void setEnqueueTime(qint64 enqueueTime) { m_enqueueTime = enqueueTime; }
+
+    private:
+        qint64 m_enqueueTime;
 };
 
 #endif // EVENT_H
@@ -0,0 +1,38 @@
+#include "tickevent.h"
+
+#include "gameexception.h"
+#include "gameobject.h"
+#include "logutil.h"
+#include "tickgroup.h"
+
+
+TickEvent::TickEvent(TickGroup *group) :
+    Event(),
+    m_group(group) {
+}
+
+TickEvent::~TickEvent() {
+}
+
+void TickEvent::process() {
+
+    for (GameObject *object : m_group->nextBucket()) {
+        if (!m_group->contains(object)) {
+            continue;
+        }
+
+        try {
+            object->invokeTimer(m_group->id());
+        } catch (const GameException &exception) {
+            LogUtil::logError("Game Exception: %1\n"
+                              "While processing tick #%2 on object %3:%4", exception.what(),
+                              QString::number(m_group->id()), object->objectType().toString(),
+                              QString::number(object->id()));
+        }
+    }
+}
+
+QString TickEvent::toString() const {
+
+    return QString("Tick #%1 on %2 objects").arg(m_group->id()).arg(m_group->size());
+}
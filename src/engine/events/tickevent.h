@@ -0,0 +1,23 @@
+#ifndef TICKEVENT_H
+#define TICKEVENT_H
+
+#include "event.h"
+
+
+class TickGroup;
+
+class TickEvent : public Event {
+
+    public:
+        TickEvent(TickGroup *group);
+        virtual ~TickEvent();
+
+        virtual void process();
+
+        virtual QString toString() const;
+
+    private:
+        TickGroup *m_group;
+};
+
+#endif // TICKEVENT_H
@@ -0,0 +1,68 @@
+#include "filestoragebackend.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+
+#include "diskutil.h"
+#include "logutil.h"
+
+
+FileStorageBackend::FileStorageBackend(const QString &directory) :
+    StorageBackend(),
+    m_directory(directory) {
+}
+
+FileStorageBackend::~FileStorageBackend() {
+}
+
+QDateTime FileStorageBackend::lastModified() {
+
+    // the directory itself is modified when files are added or removed
+    QDateTime lastModified = QFileInfo(m_directory).lastModified();
+
+    QFileInfoList entries = QDir(m_directory).entryInfoList(QDir::Files, QDir::Time);
+    if (!entries.isEmpty()) {
+        lastModified = qMax(lastModified, entries.first().lastModified());
+    }
+    return lastModified;
+}
+
+QStringList FileStorageBackend::objectKeys() {
+
+    QStringList entries = QDir(m_directory).entryList(QDir::Files);
+    return entries.filter(QRegExp("^[^.].*$")); // extra filter to remove files starting
+                                                // with a dot on Windows
+}
+
+bool FileStorageBackend::readObject(const QString &key, QString *jsonString) {
+
+    QFile file(m_directory + "/" + key);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    *jsonString = QString::fromUtf8(file.readAll());
+    return true;
+}
+
+bool FileStorageBackend::writeObject(const QString &key, const QString &jsonString) {
+
+    return DiskUtil::writeFile(m_directory + "/" + key, jsonString);
+}
+
+bool FileStorageBackend::patchObject(const QString &key, const QMap<QString, QString> &properties) {
+
+    QString jsonString;
+    if (!readObject(key, &jsonString)) {
+        LogUtil::logError("Could not open file %1 for patching", m_directory + "/" + key);
+        return false;
+    }
+
+    return writeObject(key, patchJson(jsonString, properties));
+}
+
+bool FileStorageBackend::removeObject(const QString &key) {
+
+    return QFile::remove(m_directory + "/" + key);
+}
@@ -0,0 +1,29 @@
+#ifndef FILESTORAGEBACKEND_H
+#define FILESTORAGEBACKEND_H
+
+#include "storagebackend.h"
+
+
+/**
+ * Storage backend that keeps every object in its own JSON file in the data directory.
+ */
+class FileStorageBackend : public StorageBackend {
+
+    public:
+        FileStorageBackend(const QString &directory);
+        virtual ~FileStorageBackend();
+
+        virtual QDateTime lastModified();
+
+        virtual QStringList objectKeys();
+        virtual bool readObject(const QString &key, QString *jsonString);
+
+        virtual bool writeObject(const QString &key, const QString &jsonString);
+        virtual bool patchObject(const QString &key, const QMap<QString, QString> &properties);
+        virtual bool removeObject(const QString &key);
+
+    private:
+        QString m_directory;
+};
+
+#endif // FILESTORAGEBACKEND_H
@@ -0,0 +1,37 @@
+#include "fileutil.h"
+
+#include <cstdio>
+#include <unistd.h>
+
+#include <QFile>
+#include <QFileInfo>
+
+#ifndef Q_OS_WIN
+#include <fcntl.h>
+#endif
+
+
+bool FileUtil::replaceFile(const QString &source, const QString &destination) {
+
+#ifdef Q_OS_WIN
+    QFile::remove(destination);
+#endif
+    if (::rename(QFile::encodeName(source).constData(),
+                 QFile::encodeName(destination).constData()) != 0) {
+        return false;
+    }
+
+#ifdef Q_OS_WIN
+    return true;
+#else
+    // the rename is recorded in the directory, which has to be synced for it to be durable
+    QString directory = QFileInfo(destination).absolutePath();
+    int fd = ::open(QFile::encodeName(directory).constData(), O_RDONLY | O_DIRECTORY);
+    if (fd == -1) {
+        return false;
+    }
+    bool synced = (fsync(fd) == 0);
+    ::close(fd);
+    return synced;
+#endif
+}
@@ -0,0 +1,21 @@
+#ifndef FILEUTIL_H
+#define FILEUTIL_H
+
+#include <QString>
+
+
+/**
+ * File operations that only depend on Qt Core, so that the utilities in src/utils/ can use them
+ * without pulling in the engine.
+ */
+class FileUtil {
+
+    public:
+        /**
+         * Atomically replaces the destination file with the source file. On POSIX systems, the
+         * directory is synced afterwards, so the new file survives a crash.
+         */
+        static bool replaceFile(const QString &source, const QString &destination);
+};
+
+#endif // FILEUTIL_H
@@ -32,7 +32,7 @@ void AreaEvent::visitRoom(Room *room, double strength) {
 
         Character *character = characterPtr.cast<Character *>();
         QString message = descriptionForStrengthAndCharacterInRoom(strength, character, room);
-        character->send(message);
+        messages().send(character, message);
 
         addAffectedCharacter(characterPtr);
     }
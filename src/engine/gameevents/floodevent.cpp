@@ -1,7 +1,7 @@
 #include "floodevent.h"
 
 #include "character.h"
-#include "portal.h"
+#include "realm.h"
 #include "room.h"
 #include "util.h"
 #include "vector3d.h"
@@ -41,26 +41,31 @@ void FloodEvent::visitRoom(Room *room, double strength) {
         }
 
         if (characterPtr->isPlayer()) {
-            characterPtr->send(message);
+            messages().send(characterPtr.cast<Character *>(), message);
         } else {
+            messages().flush();
             characterPtr->invokeTrigger("onflood", message);
         }
         addAffectedCharacter(characterPtr);
     }
 
-    for (const GameObjectPtr &portalPtr : room->portals()) {
-        Portal *portal = portalPtr.unsafeCast<Portal *>();
-        Room *room1 = portal->room().unsafeCast<Room *>();
-        Room *room2 = portal->room2().unsafeCast<Room *>();
-        Room *oppositeRoom = (room == room1 ? room2 : room1);
-        if (hasBeenVisited(oppositeRoom) || !portal->canPassThrough()) {
-            continue;
-        }
+    propagateOverEdges(room, strength);
+}
 
-        if (oppositeRoom->position().z > strength) {
-            continue;
-        }
+bool FloodEvent::propagatesThrough(Room *room, double strength, const RoomEdge &edge,
+                                   double *propagatedStrength) const {
 
-        addVisit(oppositeRoom, strength);
+    Q_UNUSED(room)
+
+    if (!edge.canPassThrough() || edge.oppositeRoom->position().z > strength) {
+        return false;
     }
+
+    *propagatedStrength = strength;
+    return true;
+}
+
+bool FloodEvent::supportsParallelPropagation() const {
+
+    return true;
 }
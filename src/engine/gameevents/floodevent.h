@@ -16,6 +16,10 @@ class FloodEvent : public GameEvent {
 
     protected:
         virtual void visitRoom(Room *room, double strength);
+
+        virtual bool propagatesThrough(Room *room, double strength, const RoomEdge &edge,
+                                       double *propagatedStrength) const;
+        virtual bool supportsParallelPropagation() const;
 };
 
 #endif // FLOODEVENT_H
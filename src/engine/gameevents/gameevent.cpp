@@ -7,22 +7,123 @@
 #include "floodevent.h"
 #include "movementsoundevent.h"
 #include "movementvisualevent.h"
+#include "parallelpropagator.h"
+#include "realm.h"
 #include "room.h"
 #include "soundevent.h"
 #include "speechevent.h"
 #include "visualevent.h"
 
 
+static const int MaxPooledVisitLists = 16;
+
+QVector<GameEvent::VisitList *> GameEvent::s_visitListPool;
+
+
+/**
+ * The rooms visited by an event, in the order in which they are visited.
+ *
+ * Whether a room has been visited is tracked in an array indexed by the graph index of the
+ * room. Instead of clearing the array for every event, an entry only counts when its epoch
+ * matches the epoch of the list, which is incremented every time the list is reused. Together
+ * with pooling the lists, this means propagating an event allocates nothing once the lists
+ * have grown to the size of the realm.
+ */
+class GameEvent::VisitList {
+
+    public:
+        struct RoomState {
+            quint32 epoch;
+            int visitIndex;
+        };
+
+        QVector<Visit> visits;
+        int numVisits;
+
+        QVector<RoomState> roomStates;
+        quint32 epoch;
+
+        VisitList() :
+            numVisits(0),
+            epoch(0) {
+        }
+
+        void reset() {
+
+            numVisits = 0;
+
+            epoch++;
+            if (epoch == 0) {
+                RoomState emptyState = { 0, 0 };
+                roomStates.fill(emptyState);
+                epoch = 1;
+            }
+        }
+
+        int indexOf(Room *room) const {
+
+            int roomIndex = room->graphIndex();
+            if (roomIndex == -1) {
+                // rooms outside the room graph are rare enough to just look them up
+                for (int i = 0; i < numVisits; i++) {
+                    if (visits[i].room == room) {
+                        return i;
+                    }
+                }
+                return -1;
+            }
+
+            if (roomIndex < roomStates.size() && roomStates[roomIndex].epoch == epoch) {
+                return roomStates[roomIndex].visitIndex;
+            }
+            return -1;
+        }
+
+        void append(Room *room, double strength) {
+
+            int roomIndex = room->graphIndex();
+            if (roomIndex != -1) {
+                if (roomIndex >= roomStates.size()) {
+                    RoomState emptyState = { 0, 0 };
+                    roomStates.fill(emptyState, room->realm()->roomGraph().numIndices());
+                    epoch = 1;
+                    for (int i = 0; i < numVisits; i++) {
+                        int index = visits[i].room->graphIndex();
+                        if (index != -1) {
+                            roomStates[index].epoch = epoch;
+                            roomStates[index].visitIndex = i;
+                        }
+                    }
+                }
+                roomStates[roomIndex].epoch = epoch;
+                roomStates[roomIndex].visitIndex = numVisits;
+            }
+
+            if (numVisits < visits.size()) {
+                visits[numVisits] = Visit(room, strength);
+            } else {
+                visits.append(Visit(room, strength));
+            }
+            numVisits++;
+        }
+};
+
+
 GameEvent::GameEvent(GameEventType eventType, Room *origin, double strength) :
     QObject(),
     m_eventType(eventType),
     m_origin(origin),
-    m_nextVisitIndex(0) {
+    m_visits(acquireVisitList()),
+    m_nextVisitIndex(0),
+    m_parallelPropagation(false),
+    m_visitsComplete(false) {
 
     addVisit(origin, strength);
 }
 
 GameEvent::~GameEvent() {
+
+    releaseVisitList(m_visits);
 }
 
 bool GameEvent::isSoundEvent() const {
@@ -93,15 +194,27 @@ void GameEvent::setAffectedCharacters(const GameObjectPtrList &affectedCharacter
     m_affectedCharacters = affectedCharacters;
 }
 
+void GameEvent::setParallelPropagation(bool parallelPropagation) {
+
+    m_parallelPropagation = parallelPropagation;
+}
+
 void GameEvent::fire() {
 
-    while (m_nextVisitIndex < m_visits.size()) {
-        Visit visit = m_visits.value(m_nextVisitIndex);
+    if (m_parallelPropagation && m_nextVisitIndex == 0 && m_visits->numVisits == 1 &&
+        m_origin->graphIndex() > -1 && supportsParallelPropagation()) {
+        propagateInParallel();
+    }
+
+    while (m_nextVisitIndex < m_visits->numVisits) {
+        Visit visit = m_visits->visits[m_nextVisitIndex];
         visitRoom(visit.room, visit.strength);
 
         m_nextVisitIndex++;
     }
 
+    m_messages.flush();
+
     deleteLater();
 }
 
@@ -168,30 +281,99 @@ QVector<QMetaProperty> GameEvent::storedMetaProperties() const {
 
 void GameEvent::addVisit(Room *room, double strength) {
 
-    int index = m_visitIndex.value(room);
-    if (index == 0) {
-        m_visits.append(Visit(room, strength));
-        m_visitIndex[room] = m_visits.size();
+    int index = m_visits->indexOf(room);
+    if (index == -1) {
+        m_visits->append(room, strength);
     } else {
-        index--;
-        if (m_visits[index].strength < strength) {
-            m_visits[index].strength = strength;
+        Visit &visit = m_visits->visits[index];
+        if (visit.strength < strength) {
+            visit.strength = strength;
         }
     }
 }
 
+void GameEvent::propagateOverEdges(Room *room, double strength) {
+
+    if (m_visitsComplete) {
+        return;
+    }
+
+    for (const RoomEdge &edge : room->realm()->roomGraph().edges(room)) {
+        if (hasBeenVisited(edge.oppositeRoom)) {
+            continue;
+        }
+
+        double propagatedStrength;
+        if (propagatesThrough(room, strength, edge, &propagatedStrength)) {
+            addVisit(edge.oppositeRoom, propagatedStrength);
+        }
+    }
+}
+
+bool GameEvent::propagatesThrough(Room *room, double strength, const RoomEdge &edge,
+                                  double *propagatedStrength) const {
+
+    Q_UNUSED(room)
+    Q_UNUSED(strength)
+    Q_UNUSED(edge)
+    Q_UNUSED(propagatedStrength)
+
+    return false;
+}
+
+bool GameEvent::supportsParallelPropagation() const {
+
+    return false;
+}
+
 bool GameEvent::hasBeenVisited(Room *room) const {
 
-    int index = m_visitIndex.value(room);
-    return index > 0;
+    return m_visits->indexOf(room) > -1;
 }
 
 double GameEvent::strengthForRoom(Room *room) const {
 
-    int index = m_visitIndex.value(room);
-    if (index > 0) {
-        return m_visits[index - 1].strength;
+    int index = m_visits->indexOf(room);
+    if (index > -1) {
+        return m_visits->visits[index].strength;
     } else {
         return 0.0;
     }
 }
+
+void GameEvent::propagateInParallel() {
+
+    // all side effects happen while visiting the rooms afterwards, in the same order as if the
+    // event had propagated on the game thread
+    ParallelPropagator &propagator = m_origin->realm()->parallelPropagator();
+    const QVector<RoomVisit> &visits = propagator.propagate(this, m_origin,
+                                                            m_visits->visits[0].strength);
+    for (int i = 1; i < visits.size(); i++) {
+        addVisit(visits[i].room, visits[i].strength);
+    }
+
+    m_visitsComplete = true;
+}
+
+GameEvent::VisitList *GameEvent::acquireVisitList() {
+
+    // events are only created on the game thread, but they may be created while another event
+    // is firing, so every live event needs a list of its own
+    VisitList *visits;
+    if (s_visitListPool.isEmpty()) {
+        visits = new VisitList();
+    } else {
+        visits = s_visitListPool.takeLast();
+    }
+    visits->reset();
+    return visits;
+}
+
+void GameEvent::releaseVisitList(VisitList *visits) {
+
+    if (s_visitListPool.size() < MaxPooledVisitLists) {
+        s_visitListPool.append(visits);
+    } else {
+        delete visits;
+    }
+}
@@ -4,14 +4,17 @@
 #include <QObject>
 #include <QScriptValue>
 #include <QString>
+#include <QVector>
 
 #include "gameobjectptr.h"
+#include "messagebatch.h"
 #include "metatyperegistry.h"
 
 
 class Character;
 class Room;
 class QScriptEngine;
+struct RoomEdge;
 
 
 PT_DEFINE_ENUM(GameEventType,
@@ -73,6 +76,16 @@ class GameEvent : public QObject {
         Q_PROPERTY(GameObjectPtrList affectedCharacters READ affectedCharacters
                                                         WRITE setAffectedCharacters)
 
+        /**
+         * Whether the rooms reached by the event are determined up-front by multiple threads,
+         * before any room is visited. Only events that support it propagate in parallel, which
+         * pays off only when they reach a very large number of rooms.
+         */
+        bool parallelPropagation() const { return m_parallelPropagation; }
+        void setParallelPropagation(bool parallelPropagation);
+        Q_PROPERTY(bool parallelPropagation READ parallelPropagation
+                                            WRITE setParallelPropagation STORED false)
+
         Q_INVOKABLE void fire();
 
         int numVisitedRooms() const;
@@ -91,7 +104,34 @@ class GameEvent : public QObject {
         bool hasBeenVisited(Room *room) const;
         double strengthForRoom(Room *room) const;
 
+        /**
+         * Messages for the players reached by the event, which are sent when the event is done.
+         * The batch should be flushed before invoking any triggers, so that whatever the
+         * triggers send arrives after the messages of the event itself.
+         */
+        MessageBatch &messages() { return m_messages; }
+
+        /**
+         * Adds visits for all rooms the event reaches through the edges of the given room,
+         * according to propagatesThrough(). Does nothing if the visits have been determined
+         * up-front already.
+         */
+        void propagateOverEdges(Room *room, double strength);
+
+        /**
+         * Returns whether the event propagates from a room it reached with the given strength
+         * through the given edge, and if so, with which strength it reaches the opposite room.
+         *
+         * When propagating in parallel, this is called from other threads, so implementations
+         * may only read from the room and the edge.
+         */
+        virtual bool propagatesThrough(Room *room, double strength, const RoomEdge &edge,
+                                       double *propagatedStrength) const;
+        virtual bool supportsParallelPropagation() const;
+
     private:
+        friend class ParallelPropagator;
+
         class Visit {
             public:
                 Room *room;
@@ -104,20 +144,33 @@ class GameEvent : public QObject {
                 }
         };
 
+        class VisitList;
+
         GameEventType m_eventType;
 
         Room *m_origin;
 
-        QVector<Visit> m_visits;
-        QHash<Room *, int> m_visitIndex;
+        VisitList *m_visits;
         int m_nextVisitIndex;
 
+        bool m_parallelPropagation;
+        bool m_visitsComplete;
+
         QString m_description;
         QString m_distantDescription;
         QString m_veryDistantDescription;
 
         GameObjectPtrList m_excludedCharacters;
         GameObjectPtrList m_affectedCharacters;
+
+        MessageBatch m_messages;
+
+        static QVector<VisitList *> s_visitListPool;
+
+        void propagateInParallel();
+
+        static VisitList *acquireVisitList();
+        static void releaseVisitList(VisitList *visits);
 };
 
 PT_DECLARE_METATYPE(GameEvent *)
@@ -5,6 +5,7 @@
 #include "logutil.h"
 #include "point3d.h"
 #include "portal.h"
+#include "realm.h"
 #include "room.h"
 #include "util.h"
 #include "vector3d.h"
@@ -127,14 +128,39 @@ QString MovementVisualEvent::descriptionForStrengthAndCharacterInRoom(double str
     return QString("%1 %2 %3%4 %5.").arg(prefix, subject, helperVerb, m_continuous, direction);
 }
 
-bool MovementVisualEvent::isWithinSight(Room *targetRoom, Room *sourceRoom) {
+void MovementVisualEvent::propagate(Room *room, double strength) {
 
-    if (sourceRoom == originRoom() || sourceRoom == m_destination) {
-        return true;
+    // the event is seen both from the origin and the destination, so unlike other visual
+    // events it cannot be looked up in the line-of-sight cache
+    bool isEndpoint = (room == originRoom() || room == m_destination);
+    Vector3D originVector = (room->position() - originRoom()->position()).normalized();
+    Vector3D destinationVector;
+    if (m_destination) {
+        destinationVector = (room->position() - m_destination->position()).normalized();
     }
 
-    Vector3D sourceVector = (sourceRoom->position() - originRoom()->position()).normalized();
-    Vector3D targetVector = (targetRoom->position() - sourceRoom->position()).normalized();
+    for (const RoomEdge &edge : room->realm()->roomGraph().edges(room)) {
+        if (hasBeenVisited(edge.oppositeRoom)) {
+            continue;
+        }
+
+        if (!edge.canSeeThrough() ||
+            (!isEndpoint && !isWithinSight(room, originVector, destinationVector, edge))) {
+            continue;
+        }
+
+        double propagatedStrength = strength * edge.eventMultiplier(GameEventType::Visual);
+        if (propagatedStrength >= 0.1) {
+            addVisit(edge.oppositeRoom, propagatedStrength);
+        }
+    }
+}
+
+bool MovementVisualEvent::isWithinSight(Room *sourceRoom, const Vector3D &originVector,
+                                        const Vector3D &destinationVector, const RoomEdge &edge) {
+
+    Vector3D sourceVector = originVector;
+    const Vector3D &targetVector = edge.direction;
     if (sourceVector == targetVector) {
         return true;
     }
@@ -155,7 +181,7 @@ bool MovementVisualEvent::isWithinSight(Room *targetRoom, Room *sourceRoom) {
     }
 
     if (m_destination) {
-        sourceVector = (sourceRoom->position() - m_destination->position()).normalized();
+        sourceVector = destinationVector;
         if (sourceVector == targetVector) {
             return true;
         }
@@ -7,6 +7,8 @@
 #include "visualevent.h"
 
 
+struct RoomEdge;
+
 class MovementVisualEvent : public VisualEvent {
 
     Q_OBJECT
@@ -44,7 +46,7 @@ class MovementVisualEvent : public VisualEvent {
                                                                              Room *room) const;
 
     protected:
-        virtual bool isWithinSight(Room *targetRoom, Room *sourceRoom);
+        virtual void propagate(Room *room, double strength);
 
     private:
         GameObjectPtr m_subject;
@@ -57,6 +59,9 @@ class MovementVisualEvent : public VisualEvent {
         QString m_simplePresent;
         QString m_helperVerb;
         QString m_continuous;
+
+        bool isWithinSight(Room *sourceRoom, const Vector3D &originVector,
+                           const Vector3D &destinationVector, const RoomEdge &edge);
 };
 
 #endif // MOVEMENTVISUALEVENT_H
@@ -1,7 +1,7 @@
 #include "soundevent.h"
 
 #include "character.h"
-#include "portal.h"
+#include "realm.h"
 #include "room.h"
 
 
@@ -20,38 +20,48 @@ SoundEvent::~SoundEvent() {
 
 void SoundEvent::visitRoom(Room *room, double strength) {
 
-    strength *= room->eventMultiplier(GameEventType::Sound);
+    double roomStrength = strength * room->eventMultiplier(GameEventType::Sound);
+    if (roomStrength < 0.1) {
+        return;
+    }
 
-    if (strength >= 0.1) {
-        for (const GameObjectPtr &characterPtr : room->characters()) {
-            if (excludedCharacters().contains(characterPtr)) {
-                continue;
-            }
-
-            Character *character = characterPtr.cast<Character *>();
-            QString message = descriptionForStrengthAndCharacterInRoom(strength, character, room);
-            if (character->isPlayer()) {
-                character->send(message);
-            } else {
-                character->invokeTrigger("onsound", message);
-            }
-
-            addAffectedCharacter(characterPtr);
+    for (const GameObjectPtr &characterPtr : room->characters()) {
+        if (excludedCharacters().contains(characterPtr)) {
+            continue;
         }
 
-        for (const GameObjectPtr &portalPtr : room->portals()) {
-            Portal *portal = portalPtr.cast<Portal *>();
-            Room *room1 = portal->room().unsafeCast<Room *>();
-            Room *room2 = portal->room2().unsafeCast<Room *>();
-            Room *oppositeRoom = (room == room1 ? room2 : room1);
-            if (hasBeenVisited(oppositeRoom) || !portal->canHearThrough()) {
-                continue;
-            }
-
-            double propagatedStrength = strength * portal->eventMultiplier(GameEventType::Sound);
-            if (propagatedStrength >= 0.1) {
-                addVisit(oppositeRoom, propagatedStrength);
-            }
+        Character *character = characterPtr.cast<Character *>();
+        QString message = descriptionForStrengthAndCharacterInRoom(roomStrength, character, room);
+        if (character->isPlayer()) {
+            messages().send(character, message);
+        } else {
+            messages().flush();
+            character->invokeTrigger("onsound", message);
         }
+
+        addAffectedCharacter(characterPtr);
+    }
+
+    propagateOverEdges(room, strength);
+}
+
+bool SoundEvent::propagatesThrough(Room *room, double strength, const RoomEdge &edge,
+                                   double *propagatedStrength) const {
+
+    if (!edge.canHearThrough()) {
+        return false;
     }
+
+    strength *= room->eventMultiplier(GameEventType::Sound);
+    if (strength < 0.1) {
+        return false;
+    }
+
+    *propagatedStrength = strength * edge.eventMultiplier(GameEventType::Sound);
+    return *propagatedStrength >= 0.1;
+}
+
+bool SoundEvent::supportsParallelPropagation() const {
+
+    return true;
 }
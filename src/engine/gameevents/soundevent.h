@@ -15,6 +15,10 @@ class SoundEvent : public GameEvent {
 
     protected:
         virtual void visitRoom(Room *room, double strength);
+
+        virtual bool propagatesThrough(Room *room, double strength, const RoomEdge &edge,
+                                       double *propagatedStrength) const;
+        virtual bool supportsParallelPropagation() const;
 };
 
 #endif // SOUNDEVENT_H
@@ -1,7 +1,7 @@
 #include "visualevent.h"
 
 #include "character.h"
-#include "portal.h"
+#include "realm.h"
 #include "room.h"
 #include "util.h"
 #include "vector3d.h"
@@ -42,57 +42,36 @@ void VisualEvent::visitRoom(Room *room, double strength) {
 
             QString message = descriptionForStrengthAndCharacterInRoom(strength, character, room);
             if (character->isPlayer()) {
-                character->send(message);
+                messages().send(character, message);
             } else {
+                messages().flush();
                 character->invokeTrigger("onvisual", message);
             }
 
             addAffectedCharacter(characterPtr);
         }
 
-        for (const GameObjectPtr &portalPtr : room->portals()) {
-            Portal *portal = portalPtr.unsafeCast<Portal *>();
-            Room *room1 = portal->room().unsafeCast<Room *>();
-            Room *room2 = portal->room2().unsafeCast<Room *>();
-            Room *oppositeRoom = (room == room1 ? room2 : room1);
-            if (hasBeenVisited(oppositeRoom)) {
-                continue;
-            }
-
-            if (!portal->canSeeThrough() || !isWithinSight(oppositeRoom, room)) {
-                continue;
-            }
-
-            double propagatedStrength = strength * portal->eventMultiplier(GameEventType::Visual);
-            if (propagatedStrength >= 0.1) {
-                addVisit(oppositeRoom, propagatedStrength);
-            }
-        }
+        propagate(room, strength);
     }
 }
 
-bool VisualEvent::isWithinSight(Room *targetRoom, Room *sourceRoom) {
-
-    if (sourceRoom == originRoom()) {
-        return true;
-    }
+void VisualEvent::propagate(Room *room, double strength) {
 
-    Vector3D sourceVector = (sourceRoom->position() - originRoom()->position()).normalized();
-    Vector3D targetVector = (targetRoom->position() - sourceRoom->position()).normalized();
-    if (sourceVector == targetVector) {
-        return true;
+    // everything that can be seen from the origin is known up-front, so all the rooms are
+    // visited right away and no further propagation is needed from the other rooms
+    if (room != originRoom()) {
+        return;
     }
 
-    if (~sourceRoom->flags() & RoomFlags::HasWalls) {
-        if (targetVector.z == sourceVector.z) {
-            return true;
+    LineOfSightCache &cache = room->realm()->lineOfSightCache();
+    for (const SightLine &sightLine : cache.sightLines(room, 0.1 / strength)) {
+        double propagatedStrength = strength * sightLine.attenuation;
+        if (propagatedStrength < 0.1) {
+            break;
         }
-    } else {
-        if (targetVector.x != sourceVector.x || targetVector.y != sourceVector.y) {
-            return false;
+
+        if (!hasBeenVisited(sightLine.room)) {
+            addVisit(sightLine.room, propagatedStrength);
         }
     }
-
-    return ((~sourceRoom->flags() & RoomFlags::HasCeiling && targetVector.z >= sourceVector.z) ||
-            (~sourceRoom->flags() & RoomFlags::HasFloor && targetVector.z <= sourceVector.z));
 }
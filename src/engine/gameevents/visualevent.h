@@ -16,7 +16,11 @@ class VisualEvent : public GameEvent {
     protected:
         virtual void visitRoom(Room *room, double strength);
 
-        virtual bool isWithinSight(Room *targetRoom, Room *sourceRoom);
+        /**
+         * Adds visits for the rooms that can see the event from the given room, in which the
+         * event has the given strength.
+         */
+        virtual void propagate(Room *room, double strength);
 };
 
 #endif // VISUALEVENT_H
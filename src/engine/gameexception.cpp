@@ -18,7 +18,8 @@ const char *GameException::s_messages[] = {
     "Not supported",
     "Index out of bounds",
     "Null iterator referenced",
-    "Invalid sign-in"
+    "Invalid sign-in",
+    "Invalid object ID"
 };
 
 GameException::GameException(Cause cause) :
@@ -29,7 +29,8 @@ class GameException : public std::exception {
             NotSupported,
             IndexOutOfBounds,
             NullIteratorReference,
-            InvalidSignIn
+            InvalidSignIn,
+            InvalidObjectId
         };
 
         GameException(Cause cause);
@@ -1,6 +1,7 @@
 #include "gameobjectptr.h"
 
 #include <algorithm>
+#include <cctype>
 #include <climits>
 #include <utility>
 
@@ -8,6 +9,7 @@
 #include <QStringList>
 
 #include "conversionutil.h"
+#include "jsonwriter.h"
 #include "realm.h"
 #include "util.h"
 
@@ -16,7 +18,9 @@ GameObjectPtr::GameObjectPtr() :
     m_gameObject(nullptr),
     m_objectType(GameObjectType::Unknown),
     m_id(0),
-    m_list(nullptr) {
+    m_list(nullptr),
+    m_previousPointer(nullptr),
+    m_nextPointer(nullptr) {
 }
 
 GameObjectPtr::GameObjectPtr(GameObject *gameObject) :
@@ -34,9 +38,12 @@ GameObjectPtr::GameObjectPtr(Realm *realm, GameObjectType objectType, uint id) :
     m_gameObject(nullptr),
     m_objectType(objectType),
     m_id(id),
-    m_list(nullptr) {
+    m_list(nullptr),
+    m_previousPointer(nullptr),
+    m_nextPointer(nullptr) {
 
-    if (realm->isInitialized()) {
+    // objects that are not loaded yet are resolved once they are
+    if (realm->isInitialized() && !realm->isUnloaded(id)) {
         resolve(realm);
     }
 }
@@ -45,7 +52,9 @@ GameObjectPtr::GameObjectPtr(const GameObjectPtr &other) :
     m_gameObject(other.m_gameObject),
     m_objectType(other.m_objectType),
     m_id(other.m_id),
-    m_list(nullptr) {
+    m_list(nullptr),
+    m_previousPointer(nullptr),
+    m_nextPointer(nullptr) {
 
     if (m_gameObject) {
         m_gameObject->registerPointer(this);
@@ -132,7 +141,7 @@ bool GameObjectPtr::operator!=(const GameObject *other) const {
 
 void GameObjectPtr::resolve(Realm *realm) {
 
-    if (m_id == 0) {
+    if (m_id == 0 || m_gameObject) {
         return;
     }
 
@@ -207,21 +216,79 @@ QString GameObjectPtr::toJsonString(const GameObjectPtr &pointer, Options option
     return ConversionUtil::jsString(pointer.toString());
 }
 
+void GameObjectPtr::writeJson(JsonWriter &writer, const GameObjectPtr &pointer) {
+
+    if (pointer.m_id == 0) {
+        writer.writeRaw("\"0\"", 3);
+        return;
+    }
+
+    // same as toString(), without the intermediate strings
+    writer.writeRaw('"');
+    for (const char *type = pointer.m_objectType.toCString(); *type; type++) {
+        writer.writeRaw((char) tolower(*type));
+    }
+    writer.writeRaw(':');
+    writer.writeUInt(pointer.m_id);
+    writer.writeRaw('"');
+}
+
 void GameObjectPtr::fromVariant(const QVariant &variant, GameObjectPtr &pointer) {
 
     QString string = variant.toString();
-    if (string == "0") {
+    fromJsonString(QStringRef(&string), pointer);
+}
+
+void GameObjectPtr::fromJsonString(const QStringRef &string, GameObjectPtr &pointer) {
+
+    const QChar *data = string.unicode();
+    int length = string.length();
+    if (length == 1 && data[0] == '0') {
         return;
     }
 
-    QStringList components = string.split(':');
-    if (components.length() != 2) {
+    int separator = -1;
+    for (int i = 0; i < length; i++) {
+        if (data[i] == ':') {
+            if (separator > -1) {
+                throw GameException(GameException::InvalidGameObjectPointer);
+            }
+            separator = i;
+        }
+    }
+    if (separator == -1) {
         throw GameException(GameException::InvalidGameObjectPointer);
     }
 
-    QString objectType = Util::capitalize(components[0]);
-    pointer = GameObjectPtr(Realm::instance(), GameObjectType::fromString(objectType),
-                            components[1].toInt());
+    // the type is matched with its first letter capitalized, like GameObjectType::fromString()
+    // after Util::capitalize()
+    GameObjectType objectType = GameObjectType::Unknown;
+    for (int i = 0; i < (int) GameObjectType::NumValues; i++) {
+        const char *typeName = GameObjectType((GameObjectType::Values) i).toCString();
+        int j = 0;
+        for (; j < separator && typeName[j]; j++) {
+            QChar character = (j == 0 ? data[j].toUpper() : data[j]);
+            if (character != QLatin1Char(typeName[j])) {
+                break;
+            }
+        }
+        if (j == separator && !typeName[j]) {
+            objectType = (GameObjectType::Values) i;
+            break;
+        }
+    }
+
+    // invalid IDs yield 0, like QString::toInt()
+    quint64 id = 0;
+    for (int i = separator + 1; i < length; i++) {
+        ushort digit = data[i].unicode();
+        if (digit < '0' || digit > '9' || (id = 10 * id + digit - '0') > INT_MAX) {
+            id = 0;
+            break;
+        }
+    }
+
+    pointer = GameObjectPtr(Realm::instance(), objectType, id);
 }
 
 QScriptValue GameObjectPtr::toScriptValue(QScriptEngine *engine, const GameObjectPtr &pointer) {
@@ -249,18 +316,7 @@ void swap(GameObjectPtr &first, GameObjectPtr &second) {
         return;
     }
 
-    if (first.m_gameObject) {
-        first.m_gameObject->registerPointer(&second);
-        first.m_gameObject->unregisterPointer(&first);
-    }
-    if (second.m_gameObject) {
-        second.m_gameObject->registerPointer(&first);
-        second.m_gameObject->unregisterPointer(&second);
-    }
-
-    std::swap(first.m_gameObject, second.m_gameObject);
-    std::swap(first.m_objectType, second.m_objectType);
-    std::swap(first.m_id, second.m_id);
+    swapWithinList(first, second);
 
     if (first.m_list && first.m_id == 0) {
         first.m_list->removeOne(first);
@@ -272,14 +328,44 @@ void swap(GameObjectPtr &first, GameObjectPtr &second) {
 
 void swapWithinList(GameObjectPtr &first, GameObjectPtr &second) {
 
-    if (second.m_gameObject) {
-        second.m_gameObject->registerPointer(&first);
-        second.m_gameObject->unregisterPointer(&second);
+    GameObject *firstObject = first.m_gameObject;
+    GameObject *secondObject = second.m_gameObject;
+    if (firstObject) {
+        firstObject->unlinkPointer(&first);
+    }
+    if (secondObject) {
+        secondObject->unlinkPointer(&second);
     }
 
     std::swap(first.m_gameObject, second.m_gameObject);
     std::swap(first.m_objectType, second.m_objectType);
     std::swap(first.m_id, second.m_id);
+
+    if (secondObject) {
+        secondObject->registerPointer(&first);
+    }
+    if (firstObject) {
+        firstObject->registerPointer(&second);
+    }
+}
+
+void relocateWithinList(GameObjectPtr &source, GameObjectPtr &destination) {
+
+    Q_ASSERT(!destination.m_gameObject);
+
+    // the destination takes over the place of the source in the list of pointers to the
+    // object, so the object never sees the pointer go away
+    if (source.m_gameObject) {
+        source.m_gameObject->relinkPointer(&source, &destination);
+    }
+
+    destination.m_gameObject = source.m_gameObject;
+    destination.m_objectType = source.m_objectType;
+    destination.m_id = source.m_id;
+
+    source.m_gameObject = nullptr;
+    source.m_objectType = GameObjectType::Unknown;
+    source.m_id = 0;
 }
 
 
@@ -304,10 +390,6 @@ GameObjectPtr &GameObjectPtrList::iterator::operator*() const {
 GameObjectPtrList::iterator &GameObjectPtrList::iterator::operator++() {
 
     m_index++;
-    if (m_index == m_list->m_size && m_list->m_nextList) {
-        m_list = m_list->m_nextList;
-        m_index = 0;
-    }
     return *this;
 }
 
@@ -315,10 +397,6 @@ GameObjectPtrList::iterator GameObjectPtrList::iterator::operator++(int) {
 
     GameObjectPtrList::iterator it(*this);
     m_index++;
-    if (m_index == m_list->m_size && m_list->m_nextList) {
-        m_list = m_list->m_nextList;
-        m_index = 0;
-    }
     return it;
 }
 
@@ -355,10 +433,6 @@ const GameObjectPtr &GameObjectPtrList::const_iterator::operator*() const {
 GameObjectPtrList::const_iterator &GameObjectPtrList::const_iterator::operator++() {
 
     m_index++;
-    if (m_index == m_list->m_size && m_list->m_nextList) {
-        m_list = m_list->m_nextList;
-        m_index = 0;
-    }
     return *this;
 }
 
@@ -366,10 +440,6 @@ GameObjectPtrList::const_iterator GameObjectPtrList::const_iterator::operator++(
 
     GameObjectPtrList::const_iterator it(*this);
     m_index++;
-    if (m_index == m_list->m_size && m_list->m_nextList) {
-        m_list = m_list->m_nextList;
-        m_index = 0;
-    }
     return it;
 }
 
@@ -384,40 +454,19 @@ GameObjectPtrList::GameObjectPtrList() :
     m_size(0),
     m_capacity(0),
     m_items(nullptr),
-    m_nextList(nullptr) {
+    m_unresolvedCopies(false) {
 }
 
 GameObjectPtrList::GameObjectPtrList(int size) :
-    m_size(0),
-    m_capacity(size),
-    m_items(nullptr),
-    m_nextList(nullptr) {
-
-    if (m_capacity) {
-        m_items = new GameObjectPtr[m_capacity];
+    GameObjectPtrList() {
 
-        for (int i = 0; i < m_capacity; i++) {
-            m_items[i].setOwnerList(this);
-        }
-    }
+    reserve(size);
 }
 
 GameObjectPtrList::GameObjectPtrList(const GameObjectPtrList &other) :
-    m_size(other.length()),
-    m_capacity(other.length()),
-    m_items(nullptr),
-    m_nextList(nullptr) {
-
-    if (m_capacity) {
-        m_items = new GameObjectPtr[m_capacity];
+    GameObjectPtrList() {
 
-        int index = 0;
-        for (const GameObjectPtr &pointer : other) {
-            m_items[index] = pointer;
-            m_items[index].setOwnerList(this);
-            index++;
-        }
-    }
+    append(other);
 }
 
 GameObjectPtrList::GameObjectPtrList(GameObjectPtrList &&other) :
@@ -428,7 +477,6 @@ GameObjectPtrList::GameObjectPtrList(GameObjectPtrList &&other) :
 
 GameObjectPtrList::~GameObjectPtrList() {
 
-    delete m_nextList;
     delete[] m_items;
 }
 
@@ -438,41 +486,30 @@ void GameObjectPtrList::append(const GameObjectPtr &value) {
         return;
     }
 
-    if (m_capacity) {
-        if (m_size < m_capacity) {
-            m_items[m_size] = value;
-            m_size++;
-        } else {
-            if (!m_nextList) {
-                m_nextList = new GameObjectPtrList(qMax(2 * m_capacity, 16));
-            }
-
-            m_nextList->append(value);
-        }
+    if (m_size == m_capacity) {
+        GameObjectPtr item(value);
+        grow(m_size + 1);
+        m_items[m_size] = item;
     } else {
-        m_size = 1;
-        m_capacity = 16;
-
-        m_items = new GameObjectPtr[m_capacity];
-
-        for (int i = 0; i < m_capacity; i++) {
-            m_items[i].setOwnerList(this);
-        }
-
-        m_items[0] = value;
+        m_items[m_size] = value;
     }
+    m_size++;
 }
 
 void GameObjectPtrList::append(const GameObjectPtrList &value) {
 
-    if (value.isEmpty()) {
+    int numItems = value.m_size;
+    if (numItems == 0) {
         return;
     }
 
-    reserve(qMax(length() + value.length(), 16));
+    if (m_size + numItems > m_capacity) {
+        grow(m_size + numItems);
+    }
 
-    for (const GameObjectPtr &item : value) {
-        append(item);
+    for (int i = 0; i < numItems; i++) {
+        m_items[m_size] = value.m_items[i];
+        m_size++;
     }
 }
 
@@ -494,13 +531,11 @@ GameObjectPtrList::const_iterator GameObjectPtrList::begin() const {
 
 void GameObjectPtrList::clear() {
 
-    delete m_nextList;
     delete[] m_items;
 
     m_size = 0;
     m_capacity = 0;
     m_items = nullptr;
-    m_nextList = nullptr;
 }
 
 GameObjectPtrList::const_iterator GameObjectPtrList::constBegin() const {
@@ -513,53 +548,31 @@ GameObjectPtrList::const_iterator GameObjectPtrList::constBegin() const {
 
 GameObjectPtrList::const_iterator GameObjectPtrList::constEnd() const {
 
-    if (m_nextList) {
-        return m_nextList->constEnd();
-    } else {
-        GameObjectPtrList::const_iterator it;
-        it.m_list = const_cast<GameObjectPtrList *>(this);
-        it.m_index = m_size;
-        return it;
-    }
+    GameObjectPtrList::const_iterator it;
+    it.m_list = const_cast<GameObjectPtrList *>(this);
+    it.m_index = m_size;
+    return it;
 }
 
 bool GameObjectPtrList::contains(const GameObjectPtr &value) const {
 
-    for (int i = 0; i < m_size; i++) {
-        if (m_items[i] == value) {
-            return true;
-        }
-    }
-
-    if (m_nextList) {
-        return m_nextList->contains(value);
-    } else {
-        return false;
-    }
+    return indexOf(value) != -1;
 }
 
 GameObjectPtrList::iterator GameObjectPtrList::end() {
 
-    if (m_nextList) {
-        return m_nextList->end();
-    } else {
-        GameObjectPtrList::iterator it;
-        it.m_list = this;
-        it.m_index = m_size;
-        return it;
-    }
+    GameObjectPtrList::iterator it;
+    it.m_list = this;
+    it.m_index = m_size;
+    return it;
 }
 
 GameObjectPtrList::const_iterator GameObjectPtrList::end() const {
 
-    if (m_nextList) {
-        return m_nextList->end();
-    } else {
-        GameObjectPtrList::const_iterator it;
-        it.m_list = const_cast<GameObjectPtrList *>(this);
-        it.m_index = m_size;
-        return it;
-    }
+    GameObjectPtrList::const_iterator it;
+    it.m_list = const_cast<GameObjectPtrList *>(this);
+    it.m_index = m_size;
+    return it;
 }
 
 GameObjectPtr &GameObjectPtrList::first() {
@@ -580,28 +593,12 @@ int GameObjectPtrList::indexOf(const GameObjectPtr &value) const {
         }
     }
 
-    if (m_nextList) {
-        int index = m_nextList->indexOf(value);
-        if (index != -1) {
-            index += m_size;
-        }
-        return index;
-    } else {
-        return -1;
-    }
+    return -1;
 }
 
 void GameObjectPtrList::insert(const GameObjectPtr &value) {
 
-    for (int i = 0; i < m_size; i++) {
-        if (m_items[i] == value) {
-            return;
-        }
-    }
-
-    if (m_nextList) {
-        m_nextList->insert(value);
-    } else {
+    if (!contains(value)) {
         append(value);
     }
 }
@@ -613,29 +610,17 @@ bool GameObjectPtrList::isEmpty() const {
 
 GameObjectPtr &GameObjectPtrList::last() {
 
-    if (m_nextList) {
-        return m_nextList->last();
-    } else {
-        return m_items[m_size - 1];
-    }
+    return m_items[m_size - 1];
 }
 
 const GameObjectPtr &GameObjectPtrList::last() const {
 
-    if (m_nextList) {
-        return m_nextList->last();
-    } else {
-        return m_items[m_size - 1];
-    }
+    return m_items[m_size - 1];
 }
 
 int GameObjectPtrList::length() const {
 
-    if (m_nextList) {
-        return m_size + m_nextList->length();
-    } else {
-        return m_size;
-    }
+    return m_size;
 }
 
 int GameObjectPtrList::removeAll(const GameObjectPtr &value) {
@@ -648,92 +633,59 @@ int GameObjectPtrList::removeAll(const GameObjectPtr &value) {
             i--;
         }
     }
-
-    if (m_nextList) {
-        numRemovals += m_nextList->removeAll(value);
-    }
-
     return numRemovals;
 }
 
 void GameObjectPtrList::removeAt(int i) {
 
-    if (i < m_size) {
-        m_items[i].setOwnerList(nullptr);
-        m_items[i] = GameObjectPtr();
-        for (int j = i; j < m_size - 1; j++) {
-            swapWithinList(m_items[j], m_items[j + 1]);
-        }
-        m_items[i].setOwnerList(this);
-        if (m_nextList) {
-            m_items[m_size - 1] = m_nextList->m_items[0];
-            m_nextList->removeAt(0);
-        } else {
-            m_size--;
-        }
-    } else {
-        if (m_nextList) {
-            m_nextList->removeAt(i - m_size);
-        } else {
-            throw GameException(GameException::IndexOutOfBounds,
-                                QString("Index %1 should be within [0,%2)").arg(i).arg(m_size));
-        }
+    if (i < 0 || i >= m_size) {
+        throw GameException(GameException::IndexOutOfBounds,
+                            QString("Index %1 should be within [0,%2)").arg(i).arg(m_size));
     }
 
-    if (m_nextList && m_nextList->m_size == 0) {
-        delete m_nextList;
-        m_nextList = nullptr;
+    m_items[i].setOwnerList(nullptr);
+    m_items[i] = GameObjectPtr();
+    m_items[i].setOwnerList(this);
+
+    for (int j = i; j < m_size - 1; j++) {
+        relocateWithinList(m_items[j + 1], m_items[j]);
     }
+    m_size--;
 }
 
 bool GameObjectPtrList::removeOne(const GameObjectPtr &value) {
 
-    for (int i = 0; i < m_size; i++) {
-        if (m_items[i] == value) {
-            removeAt(i);
-            return true;
-        }
-    }
-
-    if (m_nextList) {
-        return m_nextList->removeOne(value);
-    } else {
+    int index = indexOf(value);
+    if (index == -1) {
         return false;
     }
+
+    removeAt(index);
+    return true;
 }
 
 void GameObjectPtrList::reserve(int size) {
 
-    if (size) {
-        if (m_capacity) {
-            if (m_size >= size) {
-                return;
-            }
-            if (m_size == m_capacity) {
-                if (m_nextList) {
-                    m_nextList->reserve(size - m_size);
-                } else {
-                    m_nextList = new GameObjectPtrList(qMax(2 * m_capacity, m_size - size));
-                }
-            }
-        } else {
-            m_capacity = size;
-            m_items = new GameObjectPtr[m_capacity];
+    if (size <= m_capacity) {
+        return;
+    }
 
-            for (int i = 0; i < m_capacity; i++) {
-                m_items[i].setOwnerList(this);
-            }
-        }
+    GameObjectPtr *items = new GameObjectPtr[size];
+    for (int i = 0; i < size; i++) {
+        items[i].setOwnerList(this);
     }
+    for (int i = 0; i < m_size; i++) {
+        relocateWithinList(m_items[i], items[i]);
+    }
+
+    delete[] m_items;
+    m_items = items;
+    m_capacity = size;
 }
 
 int GameObjectPtrList::size() const {
 
-    if (m_nextList) {
-        return m_size + m_nextList->size();
-    } else {
-        return m_size;
-    }
+    return m_size;
 }
 
 void swap(GameObjectPtrList &first, GameObjectPtrList &second) {
@@ -741,28 +693,24 @@ void swap(GameObjectPtrList &first, GameObjectPtrList &second) {
     std::swap(first.m_size, second.m_size);
     std::swap(first.m_capacity, second.m_capacity);
     std::swap(first.m_items, second.m_items);
-    std::swap(first.m_nextList, second.m_nextList);
-}
-
-bool GameObjectPtrList::operator!=(const GameObjectPtrList &other) const {
 
-    if (size() != other.size()) {
-        return true;
+    for (int i = 0; i < first.m_capacity; i++) {
+        first.m_items[i].setOwnerList(&first);
     }
-
-    for (int i = 0; i < size(); i++) {
-        if (operator[](i) != other[i]) {
-            return true;
-        }
+    for (int i = 0; i < second.m_capacity; i++) {
+        second.m_items[i].setOwnerList(&second);
     }
+}
+
+bool GameObjectPtrList::operator!=(const GameObjectPtrList &other) const {
 
-    return false;
+    return !operator==(other);
 }
 
 GameObjectPtrList GameObjectPtrList::operator+(const GameObjectPtrList &other) const {
 
     GameObjectPtrList list;
-    list.reserve(length() + other.length());
+    list.reserve(m_size + other.m_size);
     list.append(*this);
     list.append(other);
     return list;
@@ -770,8 +718,20 @@ GameObjectPtrList GameObjectPtrList::operator+(const GameObjectPtrList &other) c
 
 GameObjectPtrList &GameObjectPtrList::operator=(const GameObjectPtrList &other) {
 
-    clear();
-    append(other);
+    if (&other != this) {
+        clear();
+        if (m_unresolvedCopies) {
+            reserve(other.m_size);
+            for (int i = 0; i < other.m_size; i++) {
+                m_items[i].m_objectType = other.m_items[i].m_objectType;
+                m_items[i].m_id = other.m_items[i].m_id;
+            }
+            m_size = other.m_size;
+        } else {
+            append(other);
+        }
+    }
+
     return *this;
 }
 
@@ -786,12 +746,12 @@ GameObjectPtrList &GameObjectPtrList::operator=(GameObjectPtrList &&other) {
 
 bool GameObjectPtrList::operator==(const GameObjectPtrList &other) const {
 
-    if (size() != other.size()) {
+    if (m_size != other.m_size) {
         return false;
     }
 
-    for (int i = 0; i < size(); i++) {
-        if (operator[](i) != other[i]) {
+    for (int i = 0; i < m_size; i++) {
+        if (m_items[i] != other.m_items[i]) {
             return false;
         }
     }
@@ -801,16 +761,12 @@ bool GameObjectPtrList::operator==(const GameObjectPtrList &other) const {
 
 const GameObjectPtr &GameObjectPtrList::operator[](int i) const {
 
-    if (i < m_size) {
-        return m_items[i];
-    } else {
-        if (m_nextList) {
-            return (*m_nextList)[i - m_size];
-        } else {
-            throw GameException(GameException::IndexOutOfBounds,
-                                QString("Index %1 should be within [0,%2)").arg(i).arg(m_size));
-        }
+    if (i < 0 || i >= m_size) {
+        throw GameException(GameException::IndexOutOfBounds,
+                            QString("Index %1 should be within [0,%2)").arg(i).arg(m_size));
     }
+
+    return m_items[i];
 }
 
 void GameObjectPtrList::resolvePointers(Realm *realm) {
@@ -819,13 +775,13 @@ void GameObjectPtrList::resolvePointers(Realm *realm) {
         try {
             m_items[i].resolve(realm);
         } catch (const GameException &exception) {
-            removeAt(i);
-            i--;
+            Q_UNUSED(exception)
+            if (!realm->isUnloaded(m_items[i].id())) {
+                removeAt(i);
+                i--;
+            }
         }
     }
-    if (m_nextList) {
-        m_nextList->resolvePointers(realm);
-    }
 }
 
 void GameObjectPtrList::unresolvePointers() {
@@ -833,9 +789,11 @@ void GameObjectPtrList::unresolvePointers() {
     for (int i = 0; i < m_size; i++) {
         m_items[i].unresolve();
     }
-    if (m_nextList) {
-        m_nextList->unresolvePointers();
-    }
+}
+
+void GameObjectPtrList::setUnresolvedCopies(bool unresolvedCopies) {
+
+    m_unresolvedCopies = unresolvedCopies;
 }
 
 void GameObjectPtrList::send(const QString &message, int color) const {
@@ -843,9 +801,6 @@ void GameObjectPtrList::send(const QString &message, int color) const {
     for (int i = 0; i < m_size; i++) {
         m_items[i]->send(message, color);
     }
-    if (m_nextList) {
-        m_nextList->send(message, color);
-    }
 }
 
 QString GameObjectPtrList::joinFancy(Options options) const {
@@ -853,6 +808,11 @@ QString GameObjectPtrList::joinFancy(Options options) const {
     return Util::joinPtrList(*this, options);
 }
 
+void GameObjectPtrList::grow(int size) {
+
+    reserve(qMax(size, qMax(2 * m_capacity, 16)));
+}
+
 QString GameObjectPtrList::toUserString(const GameObjectPtrList &pointerList) {
 
     QStringList stringList;
@@ -887,6 +847,23 @@ QString GameObjectPtrList::toJsonString(const GameObjectPtrList &pointerList, Op
     return stringList.isEmpty() ? QString() : "[ " + stringList.join(", ") + " ]";
 }
 
+bool GameObjectPtrList::writeJson(JsonWriter &writer, const GameObjectPtrList &pointerList) {
+
+    if (pointerList.m_size == 0) {
+        return false;
+    }
+
+    writer.writeRaw("[ ", 2);
+    for (int i = 0; i < pointerList.m_size; i++) {
+        if (i > 0) {
+            writer.writeRaw(", ", 2);
+        }
+        GameObjectPtr::writeJson(writer, pointerList.m_items[i]);
+    }
+    writer.writeRaw(" ]", 2);
+    return true;
+}
+
 void GameObjectPtrList::fromVariant(const QVariant &variant, GameObjectPtrList &pointerList) {
 
     QList<QVariant> variantList = variant.toList();
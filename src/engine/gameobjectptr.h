@@ -16,6 +16,7 @@
 
 class GameObject;
 class GameObjectPtrList;
+class JsonWriter;
 class Realm;
 
 class GameObjectPtr {
@@ -30,6 +31,8 @@ class GameObjectPtr {
 
         bool isNull() const;
 
+        uint id() const { return m_id; }
+
         GameObjectPtr &operator=(const GameObjectPtr &other);
         GameObjectPtr &operator=(GameObjectPtr &&other);
 
@@ -78,13 +81,22 @@ class GameObjectPtr {
         static void fromUserString(const QString &string, GameObjectPtr &pointer);
 
         static QString toJsonString(const GameObjectPtr &pointer, Options options = NoOptions);
+        static void writeJson(JsonWriter &writer, const GameObjectPtr &pointer);
         static void fromVariant(const QVariant &variant, GameObjectPtr &pointer);
 
+        /**
+         * Parses a pointer in the "type:id" format used in JSON, without splitting the string.
+         */
+        static void fromJsonString(const QStringRef &string, GameObjectPtr &pointer);
+
         static QScriptValue toScriptValue(QScriptEngine *engine, const GameObjectPtr &pointer);
         static void fromScriptValue(const QScriptValue &object, GameObjectPtr &pointer);
 
+        friend class GameObject;
+        friend class GameObjectPtrList;
         friend void swap(GameObjectPtr &first, GameObjectPtr &second);
         friend void swapWithinList(GameObjectPtr &first, GameObjectPtr &second);
+        friend void relocateWithinList(GameObjectPtr &source, GameObjectPtr &destination);
 
     private:
         GameObject *m_gameObject;
@@ -93,6 +105,9 @@ class GameObjectPtr {
         uint m_id;
 
         GameObjectPtrList *m_list;
+
+        GameObjectPtr *m_previousPointer;
+        GameObjectPtr *m_nextPointer;
 };
 
 PT_DECLARE_SERIALIZABLE_METATYPE(GameObjectPtr)
@@ -232,6 +247,14 @@ class GameObjectPtrList {
         void resolvePointers(Realm *realm);
         void unresolvePointers();
 
+        /**
+         * Makes lists that are assigned to this list copy only the types and IDs of their
+         * pointers, leaving the copies unresolved. Such copies don't touch the objects pointed
+         * to, so they take time proportional to the length of the list only, rather than
+         * registering and later unregistering every pointer.
+         */
+        void setUnresolvedCopies(bool unresolvedCopies);
+
         void send(const QString &message, int color = Silver) const;
 
         QString joinFancy(Options options = NoOptions) const;
@@ -241,13 +264,17 @@ class GameObjectPtrList {
 
         static QString toJsonString(const GameObjectPtrList &pointerList,
                                     Options options = NoOptions);
+        static bool writeJson(JsonWriter &writer, const GameObjectPtrList &pointerList);
         static void fromVariant(const QVariant &variant, GameObjectPtrList &pointerList);
 
     private:
         int m_size;
         int m_capacity;
         GameObjectPtr *m_items;
-        GameObjectPtrList *m_nextList;
+
+        bool m_unresolvedCopies;
+
+        void grow(int size);
 };
 
 PT_DECLARE_SERIALIZABLE_METATYPE(GameObjectPtrList)
@@ -25,7 +25,7 @@ void Area::addRoom(const GameObjectPtr &roomPtr) {
         }
         room->setArea(this);
 
-        setModified();
+        setModified("rooms");
     }
 }
 
@@ -34,7 +34,7 @@ void Area::removeRoom(const GameObjectPtr &room) {
     if (m_rooms.removeOne(room)) {
         room.cast<Room *>()->setArea(GameObjectPtr());
 
-        setModified();
+        setModified("rooms");
     }
 }
 
@@ -43,7 +43,7 @@ void Area::setRooms(const GameObjectPtrList &rooms) {
     if (m_rooms != rooms) {
         m_rooms = rooms;
 
-        setModified();
+        setModified("rooms");
     }
 }
 
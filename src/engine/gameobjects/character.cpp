@@ -23,7 +23,7 @@ Character::Character(Realm *realm, uint id, Options options) :
     Character(realm, GameObjectType::Character, id, options) {
 
     if (~options & Copy) {
-        m_regenerationIntervalId = realm->startInterval(this, 45000);
+        m_regenerationIntervalId = realm->subscribeToTicks(this, 45000);
     }
 }
 
@@ -51,7 +51,7 @@ Character::Character(Realm *realm, GameObjectType objectType, uint id, Options o
 Character::~Character() {
 
     if (m_regenerationIntervalId) {
-        realm()->stopInterval(m_regenerationIntervalId);
+        realm()->unsubscribeFromTicks(m_regenerationIntervalId, this);
     }
 }
 
@@ -60,7 +60,7 @@ void Character::setCurrentRoom(const GameObjectPtr &currentRoom) {
     if (m_currentRoom != currentRoom) {
         m_currentRoom = currentRoom;
 
-        setModified();
+        setModified("currentRoom");
     }
 }
 
@@ -69,7 +69,7 @@ void Character::setDirection(const Vector3D &direction) {
     if (m_direction != direction) {
         m_direction = direction;
 
-        setModified();
+        setModified("direction");
     }
 }
 
@@ -78,14 +78,14 @@ void Character::addInventoryItem(const GameObjectPtr &item) {
     if (!m_inventory.contains(item)) {
         m_inventory << item;
 
-        setModified();
+        setModified("inventory");
     }
 }
 
 void Character::removeInventoryItem(const GameObjectPtr &item) {
 
     if (m_inventory.removeOne(item)) {
-        setModified();
+        setModified("inventory");
     }
 }
 
@@ -94,7 +94,7 @@ void Character::setInventory(const GameObjectPtrList &inventory) {
     if (m_inventory != inventory) {
         m_inventory = inventory;
 
-        setModified();
+        setModified("inventory");
     }
 }
 
@@ -103,14 +103,14 @@ void Character::addSellableItem(const GameObjectPtr &item) {
     if (!m_sellableItems.contains(item)) {
         m_sellableItems << item;
 
-        setModified();
+        setModified("sellableItems");
     }
 }
 
 void Character::removeSellableItem(const GameObjectPtr &item) {
 
     if (m_sellableItems.removeOne(item)) {
-        setModified();
+        setModified("sellableItems");
     }
 }
 
@@ -119,7 +119,7 @@ void Character::setSellableItems(const GameObjectPtrList &items) {
     if (m_sellableItems != items) {
         m_sellableItems = items;
 
-        setModified();
+        setModified("sellableItems");
     }
 }
 
@@ -128,7 +128,7 @@ void Character::setRace(const GameObjectPtr &race) {
     if (m_race != race) {
         m_race = race;
 
-        setModified();
+        setModified("race");
     }
 }
 
@@ -137,7 +137,7 @@ void Character::setClass(const GameObjectPtr &characterClass) {
     if (m_class != characterClass) {
         m_class = characterClass;
 
-        setModified();
+        setModified("characterClass");
     }
 }
 
@@ -146,7 +146,7 @@ void Character::setGender(const QString &gender) {
     if (m_gender != gender) {
         m_gender = gender;
 
-        setModified();
+        setModified("gender");
     }
 }
 
@@ -176,7 +176,7 @@ void Character::setHeight(int height) {
     if (m_height != height) {
         m_height = height;
 
-        setModified();
+        setModified("height");
     }
 }
 
@@ -185,7 +185,7 @@ void Character::setRespawnTime(int respawnTime) {
     if (m_respawnTime != respawnTime) {
         m_respawnTime = qMax(respawnTime, 0);
 
-        setModified();
+        setModified("respawnTime");
     }
 }
 
@@ -194,7 +194,7 @@ void Character::setRespawnTimeVariation(int respawnTimeVariation) {
     if (m_respawnTimeVariation != respawnTimeVariation) {
         m_respawnTimeVariation = qMax(respawnTimeVariation, 0);
 
-        setModified();
+        setModified("respawnTimeVariation");
     }
 }
 
@@ -207,7 +207,7 @@ void Character::setHp(int hp) {
             m_hp = hp;
         }
 
-        setModified();
+        setModified("hp");
     }
 }
 
@@ -216,7 +216,7 @@ void Character::setMaxHp(int maxHp) {
     if (m_maxHp != maxHp) {
         m_maxHp = qMax(maxHp, 0);
 
-        setModified();
+        setModified("maxHp");
     }
 }
 
@@ -229,7 +229,7 @@ void Character::setMp(int mp) {
             m_mp = mp;
         }
 
-        setModified();
+        setModified("mp");
     }
 }
 
@@ -238,7 +238,7 @@ void Character::setMaxMp(int maxMp) {
     if (m_maxMp != maxMp) {
         m_maxMp = qMax(maxMp, 0);
 
-        setModified();
+        setModified("maxMp");
     }
 }
 
@@ -247,7 +247,7 @@ void Character::setGold(double gold) {
     if (m_gold != gold) {
         m_gold = qMax(gold, 0.0);
 
-        setModified();
+        setModified("gold");
     }
 }
 
@@ -256,7 +256,7 @@ void Character::setWeapon(const GameObjectPtr &weapon) {
     if (m_weapon != weapon) {
         m_weapon = weapon;
 
-        setModified();
+        setModified("weapon");
     }
 }
 
@@ -265,7 +265,7 @@ void Character::setSecondaryWeapon(const GameObjectPtr &secondaryWeapon) {
     if (m_secondaryWeapon != secondaryWeapon) {
         m_secondaryWeapon = secondaryWeapon;
 
-        setModified();
+        setModified("secondaryWeapon");
     }
 }
 
@@ -274,7 +274,7 @@ void Character::setShield(const GameObjectPtr &shield) {
     if (m_shield != shield) {
         m_shield = shield;
 
-        setModified();
+        setModified("shield");
     }
 }
 
@@ -626,11 +626,12 @@ int Character::updateEffects(qint64 now) {
         while (msecsLeft <= 0) {
             if (effect.hpDelta != 0) {
                 m_hp = qBound(0, m_hp + effect.hpDelta, m_maxHp);
+                setModified("hp");
             }
             if (effect.mpDelta != 0) {
                 m_mp = qBound(0, m_mp + effect.mpDelta, m_maxMp);
+                setModified("mp");
             }
-            setModified();
             send(effect.message);
 
             effect.numOccurrences--;
@@ -18,7 +18,7 @@ void Class::setStats(const CharacterStats &stats) {
     if (m_stats != stats) {
         m_stats = stats;
 
-        setModified();
+        setModified("stats");
     }
 }
 
@@ -27,6 +27,6 @@ void Class::setStatsSuggestion(const CharacterStats &statsSuggestion) {
     if (m_statsSuggestion != statsSuggestion) {
         m_statsSuggestion = statsSuggestion;
 
-        setModified();
+        setModified("statsSuggestion");
     }
 }
@@ -21,7 +21,7 @@ void Container::addItem(const GameObjectPtr &item) {
 
         setWeight(weight() + item.unsafeCast<Item *>()->weight());
 
-        setModified();
+        setModified("items");
     }
 }
 
@@ -30,7 +30,7 @@ void Container::removeItem(const GameObjectPtr &item) {
     if (m_items.removeOne(item)) {
         setWeight(weight() - item.unsafeCast<Item *>()->weight());
 
-        setModified();
+        setModified("items");
     }
 }
 
@@ -47,6 +47,6 @@ void Container::setItems(const GameObjectPtrList &items) {
             setWeight(weight);
         }
 
-        setModified();
+        setModified("items");
     }
 }
@@ -15,7 +15,7 @@ void GameEventObject::setEventType(GameEventType eventType) {
     if (m_eventType != eventType) {
         m_eventType = eventType;
 
-        setModified();
+        setModified("eventType");
     }
 }
 
@@ -24,7 +24,7 @@ void GameEventObject::setDescription(const QString &description) {
     if (m_description != description) {
         m_description = description;
 
-        setModified();
+        setModified("description");
     }
 }
 
@@ -33,7 +33,7 @@ void GameEventObject::setDistantDescription(const QString &distantDescription) {
     if (m_distantDescription != distantDescription) {
         m_distantDescription = distantDescription;
 
-        setModified();
+        setModified("distantDescription");
     }
 }
 
@@ -42,7 +42,7 @@ void GameEventObject::setVeryDistantDescription(const QString &veryDistantDescri
     if (m_veryDistantDescription != veryDistantDescription) {
         m_veryDistantDescription = veryDistantDescription;
 
-        setModified();
+        setModified("veryDistantDescription");
     }
 }
 
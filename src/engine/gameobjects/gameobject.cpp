@@ -1,31 +1,31 @@
 #include "gameobject.h"
 
 #include <QDateTime>
-#include <QFile>
-#include <QFileInfo>
 #include <QMetaProperty>
 #include <QMetaType>
 #include <QScriptValueIterator>
 #include <QStack>
 #include <QStringList>
+#include <QVarLengthArray>
 #include <QVariantList>
 #include <QVariantMap>
 
-#include "qjson/json_driver.hh"
-
 #include "area.h"
 #include "character.h"
+#include "characterstats.h"
 #include "class.h"
 #include "container.h"
 #include "conversionutil.h"
 #include "deleteobjectevent.h"
-#include "diskutil.h"
 #include "gameeventmultipliermap.h"
 #include "gameeventobject.h"
 #include "gameexception.h"
 #include "gameobjectptr.h"
+#include "gameobjectsnapshot.h"
 #include "group.h"
 #include "item.h"
+#include "jsonreader.h"
+#include "jsonwriter.h"
 #include "logutil.h"
 #include "player.h"
 #include "point3d.h"
@@ -34,19 +34,523 @@
 #include "realm.h"
 #include "room.h"
 #include "scriptengine.h"
+#include "scriptfunctionmap.h"
 #include "shield.h"
+#include "storagebackend.h"
 #include "util.h"
+#include "vector3d.h"
 #include "weapon.h"
 
 
 QMap<QString, QScriptValue> GameObject::s_prototypeMap = QMap<QString, QScriptValue>();
 
 
+static int CharacterStatsType;
 static int GameEventMultiplierMapType;
 static int GameObjectPtrType;
 static int GameObjectPtrListType;
 static int Point3DType;
 static int ScriptFunctionMapType;
+static int Vector3DType;
+
+static const quint64 AllProperties = ~Q_UINT64_C(0);
+
+
+struct StoredProperty;
+
+typedef QVariant (*SnapshotPropertyFunc)(GameObject *object, int propertyIndex);
+typedef bool (*WriteJsonPropertyFunc)(JsonWriter &writer, GameObject *object,
+                                      const StoredProperty &property, Options options);
+typedef bool (*WriteJsonValueFunc)(JsonWriter &writer, const QVariant &value,
+                                   const StoredProperty &property, Options options);
+typedef bool (*ReadJsonPropertyFunc)(JsonReader &reader, const StoredProperty &property,
+                                     QVariant *value);
+typedef void (*ResolvePropertyFunc)(GameObject *object, int propertyIndex, Realm *realm);
+typedef void (*CopyPropertyFunc)(GameObject *source, GameObject *destination, int propertyIndex);
+
+// describes a stored property, with the functions for handling its value selected up front, so
+// that no type lookups are needed for every individual value
+struct StoredProperty {
+    QMetaProperty metaProperty;
+    int propertyIndex;
+    QByteArray jsonPrefix;
+    MetaTypeRegistry::TypeToJsonStringFunc converter;
+
+    SnapshotPropertyFunc snapshot;
+    WriteJsonPropertyFunc writeJson;
+    WriteJsonValueFunc writeJsonValue;
+    ReadJsonPropertyFunc readJson;
+    ResolvePropertyFunc resolve;
+    CopyPropertyFunc copy;
+};
+
+struct StoredPropertyTable {
+    QVector<StoredProperty> properties;
+    QVector<QMetaProperty> metaProperties;
+
+    // maps property indices to stored property indices, or -1 for properties that are not stored
+    QVector<int> storedIndices;
+
+    // stored property indices of the properties holding pointers to other objects
+    QVector<int> pointerProperties;
+};
+
+// filled by registerStoredProperties() when the realm is created, before any other threads are
+// started, and only read afterwards
+static StoredPropertyTable storedPropertyTables[GameObjectType::NumValues];
+
+
+template <class T> static inline void readProperty(GameObject *object, int propertyIndex,
+                                                   T *value) {
+
+    void *argument = value;
+    object->qt_metacall(QMetaObject::ReadProperty, propertyIndex, &argument);
+}
+
+template <class T> static inline void writeProperty(GameObject *object, int propertyIndex,
+                                                    T *value) {
+
+    void *argument = value;
+    object->qt_metacall(QMetaObject::WriteProperty, propertyIndex, &argument);
+}
+
+template <class T> static QVariant snapshotProperty(GameObject *object, int propertyIndex) {
+
+    T value = T();
+    readProperty(object, propertyIndex, &value);
+    return QVariant::fromValue(value);
+}
+
+template <class T> static void copyProperty(GameObject *source, GameObject *destination,
+                                            int propertyIndex) {
+
+    T value = T();
+    readProperty(source, propertyIndex, &value);
+    writeProperty(destination, propertyIndex, &value);
+}
+
+static void copyVariantProperty(GameObject *source, GameObject *destination, int propertyIndex) {
+
+    QMetaProperty metaProperty = source->metaObject()->property(propertyIndex);
+    metaProperty.write(destination, metaProperty.read(source));
+}
+
+static QVariant snapshotPointerProperty(GameObject *object, int propertyIndex) {
+
+    GameObjectPtr pointer;
+    readProperty(object, propertyIndex, &pointer);
+    pointer.unresolve();
+    return QVariant::fromValue(pointer);
+}
+
+static QVariant snapshotPointerListProperty(GameObject *object, int propertyIndex) {
+
+    // the list is read straight into the variant, copying only the types and IDs, so the
+    // objects pointed to are not touched
+    QVariant value(qMetaTypeId<GameObjectPtrList>(), nullptr);
+    GameObjectPtrList *list = static_cast<GameObjectPtrList *>(value.data());
+    list->setUnresolvedCopies(true);
+    readProperty(object, propertyIndex, list);
+    return value;
+}
+
+static QVariant snapshotVariantProperty(GameObject *object, int propertyIndex) {
+
+    return object->metaObject()->property(propertyIndex).read(object);
+}
+
+static bool writeBoolProperty(JsonWriter &writer, GameObject *object,
+                              const StoredProperty &property, Options options) {
+
+    Q_UNUSED(options)
+
+    bool value = false;
+    readProperty(object, property.propertyIndex, &value);
+    writer.writeBool(value);
+    return true;
+}
+
+static bool writeIntProperty(JsonWriter &writer, GameObject *object,
+                             const StoredProperty &property, Options options) {
+
+    Q_UNUSED(options)
+
+    int value = 0;
+    readProperty(object, property.propertyIndex, &value);
+    writer.writeInt(value);
+    return true;
+}
+
+static bool writeDoubleProperty(JsonWriter &writer, GameObject *object,
+                                const StoredProperty &property, Options options) {
+
+    Q_UNUSED(options)
+
+    double value = 0.0;
+    readProperty(object, property.propertyIndex, &value);
+    writer.writeDouble(value);
+    return true;
+}
+
+static bool writeStringProperty(JsonWriter &writer, GameObject *object,
+                                const StoredProperty &property, Options options) {
+
+    Q_UNUSED(options)
+
+    QString string;
+    readProperty(object, property.propertyIndex, &string);
+    if (string.isEmpty()) {
+        return false;
+    }
+    writer.writeString(string);
+    return true;
+}
+
+static bool writePointerProperty(JsonWriter &writer, GameObject *object,
+                                 const StoredProperty &property, Options options) {
+
+    Q_UNUSED(options)
+
+    GameObjectPtr pointer;
+    readProperty(object, property.propertyIndex, &pointer);
+    GameObjectPtr::writeJson(writer, pointer);
+    return true;
+}
+
+static bool writePointerListProperty(JsonWriter &writer, GameObject *object,
+                                     const StoredProperty &property, Options options) {
+
+    Q_UNUSED(options)
+
+    GameObjectPtrList list;
+    list.setUnresolvedCopies(true);
+    readProperty(object, property.propertyIndex, &list);
+    return GameObjectPtrList::writeJson(writer, list);
+}
+
+static bool writeConvertedProperty(JsonWriter &writer, GameObject *object,
+                                   const StoredProperty &property, Options options) {
+
+    Q_UNUSED(options)
+
+    QString jsonString = property.converter(property.metaProperty.read(object));
+    if (jsonString.isEmpty()) {
+        return false;
+    }
+    writer.writeRaw(jsonString);
+    return true;
+}
+
+static bool writeVariantProperty(JsonWriter &writer, GameObject *object,
+                                 const StoredProperty &property, Options options) {
+
+    return writer.writeVariant(property.metaProperty.read(object), options);
+}
+
+static bool writePointerValue(JsonWriter &writer, const QVariant &value,
+                              const StoredProperty &property, Options options) {
+
+    Q_UNUSED(property)
+    Q_UNUSED(options)
+
+    GameObjectPtr::writeJson(writer, *static_cast<const GameObjectPtr *>(value.constData()));
+    return true;
+}
+
+static bool writePointerListValue(JsonWriter &writer, const QVariant &value,
+                                  const StoredProperty &property, Options options) {
+
+    Q_UNUSED(property)
+    Q_UNUSED(options)
+
+    return GameObjectPtrList::writeJson(writer,
+                                        *static_cast<const GameObjectPtrList *>(value.constData()));
+}
+
+static bool writeConvertedValue(JsonWriter &writer, const QVariant &value,
+                                const StoredProperty &property, Options options) {
+
+    Q_UNUSED(options)
+
+    QString jsonString = property.converter(value);
+    if (jsonString.isEmpty()) {
+        return false;
+    }
+    writer.writeRaw(jsonString);
+    return true;
+}
+
+static bool writeVariantValue(JsonWriter &writer, const QVariant &value,
+                              const StoredProperty &property, Options options) {
+
+    Q_UNUSED(property)
+
+    return writer.writeVariant(value, options);
+}
+
+static bool readVariantProperty(JsonReader &reader, const StoredProperty &property,
+                                QVariant *value) {
+
+    QVariant variant = reader.readValue();
+    if (reader.hasError()) {
+        return false;
+    }
+    *value = ConversionUtil::fromVariant(property.metaProperty.type(),
+                                         property.metaProperty.userType(), variant);
+    return true;
+}
+
+// pointers are parsed directly from the input
+static bool readPointerProperty(JsonReader &reader, const StoredProperty &property,
+                                QVariant *value) {
+
+    if (reader.token() != JsonReader::String) {
+        return readVariantProperty(reader, property, value);
+    }
+
+    GameObjectPtr pointer;
+    GameObjectPtr::fromJsonString(reader.stringRef(), pointer);
+    *value = QVariant::fromValue(pointer);
+    return true;
+}
+
+static bool readPointerListProperty(JsonReader &reader, const StoredProperty &property,
+                                    QVariant *value) {
+
+    if (reader.token() != JsonReader::BeginArray) {
+        return readVariantProperty(reader, property, value);
+    }
+
+    GameObjectPtrList list;
+    while (reader.next() != JsonReader::EndArray) {
+        GameObjectPtr pointer;
+        if (reader.token() == JsonReader::String) {
+            GameObjectPtr::fromJsonString(reader.stringRef(), pointer);
+        } else {
+            QVariant variant = reader.readValue();
+            if (reader.hasError()) {
+                return false;
+            }
+            GameObjectPtr::fromVariant(variant, pointer);
+        }
+        list.append(pointer);
+    }
+    *value = QVariant::fromValue(list);
+    return true;
+}
+
+// pointers to players that are not loaded, and to their items, are kept unresolved until they
+// are loaded
+static void registerUnresolvedPointer(GameObject *object, const GameObjectPtr &pointer,
+                                      Realm *realm) {
+
+    if (!pointer.isNull() && !pointer.unsafeCast<GameObject *>() &&
+        realm->isUnloaded(pointer.id())) {
+        realm->addUnresolvedReference(pointer.id(), object);
+    }
+}
+
+static void resolvePointerProperty(GameObject *object, int propertyIndex, Realm *realm) {
+
+    GameObjectPtr pointer;
+    readProperty(object, propertyIndex, &pointer);
+    try {
+        pointer.resolve(realm);
+    } catch (const GameException &exception) {
+        Q_UNUSED(exception)
+        if (realm->isUnloaded(pointer.id())) {
+            realm->addUnresolvedReference(pointer.id(), object);
+            return;
+        }
+        pointer = GameObjectPtr();
+    }
+    writeProperty(object, propertyIndex, &pointer);
+}
+
+static void resolvePointerListProperty(GameObject *object, int propertyIndex, Realm *realm) {
+
+    GameObjectPtrList list;
+    readProperty(object, propertyIndex, &list);
+    list.resolvePointers(realm);
+    for (const GameObjectPtr &pointer : list) {
+        registerUnresolvedPointer(object, pointer, realm);
+    }
+    writeProperty(object, propertyIndex, &list);
+}
+
+static StoredProperty createStoredProperty(const QMetaProperty &metaProperty) {
+
+    StoredProperty property;
+    property.metaProperty = metaProperty;
+    property.propertyIndex = metaProperty.propertyIndex();
+    property.jsonPrefix = QByteArray("  \"") + metaProperty.name() + "\": ";
+    property.converter = nullptr;
+    property.snapshot = snapshotVariantProperty;
+    property.writeJson = writeVariantProperty;
+    property.writeJsonValue = writeVariantValue;
+    property.readJson = readVariantProperty;
+    property.resolve = nullptr;
+    property.copy = copyVariantProperty;
+
+    switch (metaProperty.type()) {
+        case QVariant::Bool:
+            property.snapshot = snapshotProperty<bool>;
+            property.copy = copyProperty<bool>;
+            property.writeJson = writeBoolProperty;
+            break;
+        case QVariant::Int:
+            property.snapshot = snapshotProperty<int>;
+            property.copy = copyProperty<int>;
+            property.writeJson = writeIntProperty;
+            break;
+        case QVariant::Double:
+            property.snapshot = snapshotProperty<double>;
+            property.copy = copyProperty<double>;
+            property.writeJson = writeDoubleProperty;
+            break;
+        case QVariant::String:
+            property.snapshot = snapshotProperty<QString>;
+            property.copy = copyProperty<QString>;
+            property.writeJson = writeStringProperty;
+            break;
+        case QVariant::DateTime:
+            property.snapshot = snapshotProperty<QDateTime>;
+            property.copy = copyProperty<QDateTime>;
+            break;
+        case QVariant::Map:
+            property.snapshot = snapshotProperty<QVariantMap>;
+            property.copy = copyProperty<QVariantMap>;
+            break;
+        case QVariant::UserType: {
+            int userType = metaProperty.userType();
+            if (userType == GameObjectPtrType) {
+                property.snapshot = snapshotPointerProperty;
+                property.copy = copyProperty<GameObjectPtr>;
+                property.writeJson = writePointerProperty;
+                property.writeJsonValue = writePointerValue;
+                property.readJson = readPointerProperty;
+                property.resolve = resolvePointerProperty;
+                break;
+            } else if (userType == GameObjectPtrListType) {
+                property.snapshot = snapshotPointerListProperty;
+                property.copy = copyProperty<GameObjectPtrList>;
+                property.writeJson = writePointerListProperty;
+                property.writeJsonValue = writePointerListValue;
+                property.readJson = readPointerListProperty;
+                property.resolve = resolvePointerListProperty;
+                break;
+            } else if (userType == CharacterStatsType) {
+                property.snapshot = snapshotProperty<CharacterStats>;
+                property.copy = copyProperty<CharacterStats>;
+            } else if (userType == GameEventMultiplierMapType) {
+                property.snapshot = snapshotProperty<GameEventMultiplierMap>;
+                property.copy = copyProperty<GameEventMultiplierMap>;
+            } else if (userType == Point3DType) {
+                property.snapshot = snapshotProperty<Point3D>;
+                property.copy = copyProperty<Point3D>;
+            } else if (userType == ScriptFunctionMapType) {
+                property.snapshot = snapshotProperty<ScriptFunctionMap>;
+                property.copy = copyProperty<ScriptFunctionMap>;
+            } else if (userType == Vector3DType) {
+                property.snapshot = snapshotProperty<Vector3D>;
+                property.copy = copyProperty<Vector3D>;
+            }
+
+            property.converter = MetaTypeRegistry::jsonConverters(metaProperty.typeName())
+                                 .typeToJsonStringConverter;
+            if (property.converter) {
+                property.writeJson = writeConvertedProperty;
+                property.writeJsonValue = writeConvertedValue;
+            }
+            break;
+        }
+        default:
+            break;
+    }
+
+    return property;
+}
+
+static const QMetaObject *metaObjectForType(GameObjectType objectType) {
+
+    switch (objectType.value) {
+        case GameObjectType::Area:
+            return &Area::staticMetaObject;
+        case GameObjectType::Character:
+            return &Character::staticMetaObject;
+        case GameObjectType::Class:
+            return &Class::staticMetaObject;
+        case GameObjectType::Container:
+            return &Container::staticMetaObject;
+        case GameObjectType::Event:
+            return &GameEventObject::staticMetaObject;
+        case GameObjectType::Group:
+            return &Group::staticMetaObject;
+        case GameObjectType::Item:
+            return &Item::staticMetaObject;
+        case GameObjectType::Player:
+            return &Player::staticMetaObject;
+        case GameObjectType::Portal:
+            return &Portal::staticMetaObject;
+        case GameObjectType::Race:
+            return &Race::staticMetaObject;
+        case GameObjectType::Realm:
+            return &Realm::staticMetaObject;
+        case GameObjectType::Room:
+            return &Room::staticMetaObject;
+        case GameObjectType::Shield:
+            return &Shield::staticMetaObject;
+        case GameObjectType::Weapon:
+            return &Weapon::staticMetaObject;
+        case GameObjectType::Unknown:
+        default:
+            return nullptr;
+    }
+}
+
+static void registerStoredProperties() {
+
+    CharacterStatsType = QMetaType::type("CharacterStats");
+    GameEventMultiplierMapType = QMetaType::type("GameEventMultiplierMap");
+    GameObjectPtrType = QMetaType::type("GameObjectPtr");
+    GameObjectPtrListType = QMetaType::type("GameObjectPtrList");
+    Point3DType = QMetaType::type("Point3D");
+    ScriptFunctionMapType = QMetaType::type("ScriptFunctionMap");
+    Vector3DType = QMetaType::type("Vector3D");
+
+    for (int i = 0; i < (int) GameObjectType::NumValues; i++) {
+        const QMetaObject *metaObject = metaObjectForType((GameObjectType::Values) i);
+        if (!metaObject) {
+            continue;
+        }
+
+        StoredPropertyTable &table = storedPropertyTables[i];
+        if (!table.properties.isEmpty()) {
+            continue;
+        }
+
+        int count = metaObject->propertyCount(),
+            offset = GameObject::staticMetaObject.propertyOffset();
+        table.storedIndices.fill(-1, count);
+        for (int j = offset; j < count; j++) {
+            QMetaProperty metaProperty = metaObject->property(j);
+            if (!metaProperty.isStored()) {
+                continue;
+            }
+
+            StoredProperty property = createStoredProperty(metaProperty);
+            table.storedIndices[j] = table.properties.size();
+            if (property.resolve) {
+                table.pointerProperties.append(table.properties.size());
+            }
+            table.properties.append(property);
+            table.metaProperties.append(metaProperty);
+        }
+
+        // the modified properties are tracked in a 64-bit mask
+        Q_ASSERT(table.properties.size() <= 64);
+    }
+}
 
 
 GameObject::GameObject(Realm *realm, GameObjectType objectType, uint id, Options options) :
@@ -56,6 +560,9 @@ GameObject::GameObject(Realm *realm, GameObjectType objectType, uint id, Options
     m_id(id),
     m_options((Options) (options & Copy ? options : options | AutoDelete)),
     m_deleted(false),
+    m_typeIndex(-1),
+    m_modifiedProperties(0),
+    m_firstPointer(nullptr),
     m_intervalHash(nullptr),
     m_timeoutHash(nullptr) {
 
@@ -67,14 +574,14 @@ GameObject::GameObject(Realm *realm, GameObjectType objectType, uint id, Options
         }
         if (~m_options & Copy) {
             m_realm->registerObject(this);
+
+            if (m_realm->isInitialized()) {
+                m_modifiedProperties = AllProperties;
+            }
         }
     } else {
         if (m_id == 0) {
-            GameEventMultiplierMapType = QMetaType::type("GameEventMultiplierMap");
-            GameObjectPtrType = QMetaType::type("GameObjectPtr");
-            GameObjectPtrListType = QMetaType::type("GameObjectPtrList");
-            Point3DType = QMetaType::type("Point3D");
-            ScriptFunctionMapType = QMetaType::type("ScriptFunctionMap");
+            registerStoredProperties();
         }
     }
 }
@@ -85,10 +592,11 @@ GameObject::~GameObject() {
         m_realm->unregisterObject(this);
     }
 
-    for (GameObjectPtr *pointer : m_pointers) {
+    while (m_firstPointer) {
+        GameObjectPtr *pointer = m_firstPointer;
+        unlinkPointer(pointer);
         pointer->unresolve(EndOfLife);
     }
-    m_pointers.clear();
 
     killAllTimers();
 }
@@ -175,7 +683,7 @@ void GameObject::setName(const QString &name) {
         m_name = name;
 
         setObjectName(name);
-        setModified();
+        setModified("name");
 
         changeName(m_name);
     }
@@ -227,7 +735,7 @@ void GameObject::setPlural(const QString &plural) {
     if (m_plural != plural) {
         m_plural = plural;
 
-        setModified();
+        setModified("plural");
     }
 }
 
@@ -236,7 +744,7 @@ void GameObject::setIndefiniteArticle(const QString &indefiniteArticle) {
     if (m_indefiniteArticle != indefiniteArticle) {
         m_indefiniteArticle = indefiniteArticle;
 
-        setModified();
+        setModified("indefiniteArticle");
     }
 }
 
@@ -245,7 +753,7 @@ void GameObject::setDescription(const QString &description) {
     if (m_description != description) {
         m_description = description;
 
-        setModified();
+        setModified("description");
     }
 }
 
@@ -254,7 +762,7 @@ void GameObject::setData(const QVariantMap &data) {
     if (m_data != data) {
         m_data = data;
 
-        setModified();
+        setModified("data");
     }
 }
 
@@ -264,7 +772,7 @@ void GameObject::setBoolData(const QString &name, bool value) {
         m_data[name].toBool() != value) {
         m_data[name] = value;
 
-        setModified();
+        setModified("data");
     }
 }
 
@@ -274,7 +782,7 @@ void GameObject::setIntData(const QString &name, int value) {
         m_data[name].toInt() != value) {
         m_data[name] = value;
 
-        setModified();
+        setModified("data");
     }
 }
 
@@ -284,7 +792,7 @@ void GameObject::setStringData(const QString &name, const QString &value) {
         m_data[name].toString() != value) {
         m_data[name] = value;
 
-        setModified();
+        setModified("data");
     }
 }
 
@@ -295,7 +803,7 @@ void GameObject::setGameObjectData(const QString &name, const GameObjectPtr &val
         m_data[name].value<GameObjectPtr>() != value) {
         m_data[name] = QVariant::fromValue(value);
 
-        setModified();
+        setModified("data");
     }
 }
 
@@ -306,7 +814,7 @@ void GameObject::setGameObjectListData(const QString &name, const GameObjectPtrL
         m_data[name].value<GameObjectPtrList>() != value) {
         m_data[name] = QVariant::fromValue(value);
 
-        setModified();
+        setModified("data");
     }
 }
 
@@ -315,14 +823,14 @@ void GameObject::setTrigger(const QString &name, const ScriptFunction &function)
     if (!m_triggers.contains(name) || m_triggers[name] != function) {
         m_triggers.insert(name, function);
 
-        setModified();
+        setModified("triggers");
     }
 }
 
 void GameObject::unsetTrigger(const QString &name) {
 
     if (m_triggers.remove(name) > 0) {
-        setModified();
+        setModified("triggers");
     }
 }
 
@@ -331,7 +839,7 @@ void GameObject::setTriggers(const ScriptFunctionMap &triggers) {
     if (m_triggers != triggers) {
         m_triggers = triggers;
 
-        setModified();
+        setModified("triggers");
     }
 }
 
@@ -641,9 +1149,9 @@ void GameObject::init() {
 GameObject *GameObject::copy() {
 
     GameObject *object = GameObject::createByObjectType(realm(), objectType());
-    for (const QMetaProperty &metaProperty : storedMetaProperties()) {
-        const char *name = metaProperty.name();
-        object->setProperty(name, property(name));
+    for (const StoredProperty &property :
+         storedPropertyTables[m_objectType.intValue()].properties) {
+        property.copy(this, object, property.propertyIndex);
     }
     object->init();
     return object;
@@ -669,55 +1177,202 @@ void GameObject::setDeleted() {
 
 QString GameObject::toJsonString(Options options) const {
 
-    QStringList dumpedProperties;
+    JsonWriter writer;
+    writeJson(writer, options);
+    return writer.toString();
+}
+
+void GameObject::writeJson(JsonWriter &writer, Options options) const {
+
+    bool first = true;
+    writer.writeRaw("{\n", 2);
     if (~options & SkipId) {
-        dumpedProperties.append(QString("  \"id\": %1").arg(m_id));
+        writer.writeRaw("  \"id\": ");
+        writer.writeUInt(m_id);
+        first = false;
     }
-    for (const QMetaProperty &metaProperty : storedMetaProperties()) {
-        const char *name = metaProperty.name();
+    // reading properties does not modify the object
+    GameObject *object = const_cast<GameObject *>(this);
+    const QVector<StoredProperty> &properties =
+            storedPropertyTables[m_objectType.intValue()].properties;
+    for (const StoredProperty &property : properties) {
+        int size = writer.size();
+        if (!first) {
+            writer.writeRaw(",\n", 2);
+        }
+        writer.writeRaw(property.jsonPrefix);
 
-        QString jsonString = ConversionUtil::toJsonString(property(name),
-                                                          (Options) (options & IncludeTypeInfo));
-        if (!jsonString.isEmpty()) {
-            dumpedProperties.append(QString("  \"%1\": %2").arg(name, jsonString));
+        if (property.writeJson(writer, object, property, (Options) (options & IncludeTypeInfo))) {
+            first = false;
+        } else {
+            writer.truncate(size);
         }
     }
-    return "{\n" + dumpedProperties.join(",\n") + "\n}";
+    writer.writeRaw("\n}", 2);
 }
 
-bool GameObject::save() {
+GameObjectSnapshot GameObject::snapshot() const {
+
+    return snapshot(m_modifiedProperties);
+}
+
+GameObjectSnapshot GameObject::snapshot(quint64 properties) const {
+
+    GameObjectSnapshot snapshot;
+    snapshot.objectType = m_objectType;
+    snapshot.id = m_id;
+    snapshot.deleted = m_deleted;
+    snapshot.modifiedProperties = properties;
 
     if (m_deleted) {
-        bool result = QFile::remove(DiskUtil::gameObjectPath(m_objectType.toString(), m_id));
+        return snapshot;
+    }
 
-        m_realm->enqueueEvent(new DeleteObjectEvent(m_id));
+    // reading properties does not modify the object
+    GameObject *object = const_cast<GameObject *>(this);
+    const QVector<StoredProperty> &storedProperties =
+            storedPropertyTables[m_objectType.intValue()].properties;
+    snapshot.values.resize(storedProperties.size());
+    for (int i = 0; i < storedProperties.size(); i++) {
+        if (properties & (Q_UINT64_C(1) << i)) {
+            const StoredProperty &property = storedProperties[i];
+            snapshot.values[i] = property.snapshot(object, property.propertyIndex);
+        }
+    }
+    return snapshot;
+}
+
+void GameObject::writeJson(const GameObjectSnapshot &snapshot, JsonWriter &writer) {
+
+    // same output as writeJson() with the SkipId and IncludeTypeInfo options
+    const QVector<StoredProperty> &properties =
+            storedPropertyTables[snapshot.objectType.intValue()].properties;
+    bool first = true;
+    writer.writeRaw("{\n", 2);
+    for (int i = 0; i < properties.size(); i++) {
+        const StoredProperty &property = properties[i];
+        int size = writer.size();
+        if (!first) {
+            writer.writeRaw(",\n", 2);
+        }
+        writer.writeRaw(property.jsonPrefix);
+
+        if (property.writeJsonValue(writer, snapshot.values[i], property, IncludeTypeInfo)) {
+            first = false;
+        } else {
+            writer.truncate(size);
+        }
+    }
+    writer.writeRaw("\n}", 2);
+}
+
+bool GameObject::save(const GameObjectSnapshot &snapshot, JsonWriter &writer) {
+
+    Realm *realm = Realm::instance();
+    StorageBackend *storageBackend = realm->storageBackend();
+    QString key = StorageBackend::objectKey(snapshot.objectType.toString(), snapshot.id);
+
+    if (snapshot.deleted) {
+        bool result = storageBackend->removeObject(key);
+
+        realm->enqueueEvent(new DeleteObjectEvent(snapshot.id));
 
         return result;
+    }
+
+    if (snapshot.modifiedProperties == AllProperties) {
+        writer.clear();
+        writeJson(snapshot, writer);
+        return storageBackend->writeObject(key, writer.toString());
     } else {
-        return DiskUtil::writeGameObject(m_objectType.toString(), m_id,
-                                         toJsonString((Options) (SkipId | IncludeTypeInfo)));
+        QMap<QString, QString> modifiedProperties;
+        const QVector<StoredProperty> &properties =
+                storedPropertyTables[snapshot.objectType.intValue()].properties;
+        for (int i = 0; i < properties.size(); i++) {
+            if (snapshot.modifiedProperties & (Q_UINT64_C(1) << i)) {
+                const StoredProperty &property = properties[i];
+                writer.clear();
+                property.writeJsonValue(writer, snapshot.values[i], property, IncludeTypeInfo);
+                modifiedProperties[property.metaProperty.name()] = writer.toString();
+            }
+        }
+        return storageBackend->patchObject(key, modifiedProperties);
     }
 }
 
-void GameObject::load(const QString &path) {
+void GameObject::load() {
+
+    QString key = StorageBackend::objectKey(m_objectType.toString(), m_id);
 
-    QFile file(path);
-    if (!file.open(QIODevice::ReadOnly)) {
-        throw GameException(GameException::CouldNotOpenGameObjectFile, path);
+    QString jsonString;
+    if (!Realm::instance()->storageBackend()->readObject(key, &jsonString)) {
+        throw GameException(GameException::CouldNotOpenGameObjectFile, key);
     }
 
-    loadJson(file.readAll());
+    loadJson(jsonString);
+
+    m_modifiedProperties = 0;
 }
 
 void GameObject::loadJson(const QString &jsonString) {
 
-    bool error;
-    JSonDriver driver;
-    QVariantMap map = driver.parse(jsonString, &error).toMap();
-    if (error) {
+    const QVector<StoredProperty> &properties =
+            storedPropertyTables[m_objectType.intValue()].properties;
+    QVarLengthArray<QVariant, 64> values(properties.size());
+    quint64 readProperties = 0;
+
+    // the values are converted while reading, but only written once the entire document turned
+    // out to be valid, so that a malformed document does not leave the object half-modified
+    JsonReader reader(jsonString);
+    JsonReader::Token token = reader.next();
+    if (token == JsonReader::BeginObject) {
+        // properties are usually stored in order, so we start looking after the previous one
+        int nextIndex = 0;
+        while (reader.next() == JsonReader::Key) {
+            QStringRef key = reader.stringRef();
+            int index = -1;
+            for (int i = 0; i < properties.size(); i++) {
+                int candidate = (nextIndex + i) % properties.size();
+                if (key == QLatin1String(properties[candidate].metaProperty.name())) {
+                    index = candidate;
+                    break;
+                }
+            }
+
+            reader.next();
+            if (index == -1) {
+                if (!reader.skipValue()) {
+                    break;
+                }
+                continue;
+            }
+
+            const StoredProperty &property = properties[index];
+            if (!property.readJson(reader, property, &values[index])) {
+                break;
+            }
+            readProperties |= Q_UINT64_C(1) << index;
+            nextIndex = index + 1;
+        }
+        reader.next();
+    } else if (token == JsonReader::BeginArray) {
+        reader.skipValue();
+        reader.next();
+    }
+
+    if (reader.hasError()) {
         throw GameException(GameException::InvalidGameObjectJson, jsonString);
     }
 
+    for (int i = 0; i < properties.size(); i++) {
+        if (readProperties & (Q_UINT64_C(1) << i)) {
+            properties[i].metaProperty.write(this, values[i]);
+        }
+    }
+}
+
+void GameObject::loadProperties(const QVariantMap &map) {
+
     for (const QMetaProperty &meta : storedMetaProperties()) {
         const char *name = meta.name();
         if (!map.contains(name)) {
@@ -730,25 +1385,27 @@ void GameObject::loadJson(const QString &jsonString) {
 
 void GameObject::resolvePointers() {
 
-    for (const QMetaProperty &metaProperty : storedMetaProperties()) {
-        if (metaProperty.type() == QVariant::UserType) {
-            if (metaProperty.userType() == GameObjectPtrType) {
-                GameObjectPtr pointer;
-                void *value = &pointer;
-                qt_metacall(QMetaObject::ReadProperty, metaProperty.propertyIndex(), &value);
-                try {
-                    pointer.resolve(m_realm);
-                } catch (const GameException &exception) {
-                    Q_UNUSED(exception)
-                    pointer = GameObjectPtr();
-                }
-                qt_metacall(QMetaObject::WriteProperty, metaProperty.propertyIndex(), &value);
-            } else if (metaProperty.userType() == GameObjectPtrListType) {
-                GameObjectPtrList list;
-                void *value = &list;
-                qt_metacall(QMetaObject::ReadProperty, metaProperty.propertyIndex(), &value);
-                list.resolvePointers(m_realm);
-                qt_metacall(QMetaObject::WriteProperty, metaProperty.propertyIndex(), &value);
+    const StoredPropertyTable &table = storedPropertyTables[m_objectType.intValue()];
+    for (int index : table.pointerProperties) {
+        const StoredProperty &property = table.properties[index];
+        property.resolve(this, property.propertyIndex, m_realm);
+    }
+}
+
+void GameObject::registerUnresolvedPointers() {
+
+    const StoredPropertyTable &table = storedPropertyTables[m_objectType.intValue()];
+    for (int index : table.pointerProperties) {
+        const StoredProperty &property = table.properties[index];
+        if (property.resolve == resolvePointerProperty) {
+            GameObjectPtr pointer;
+            readProperty(this, property.propertyIndex, &pointer);
+            registerUnresolvedPointer(this, pointer, m_realm);
+        } else {
+            GameObjectPtrList list;
+            readProperty(this, property.propertyIndex, &list);
+            for (const GameObjectPtr &pointer : list) {
+                registerUnresolvedPointer(this, pointer, m_realm);
             }
         }
     }
@@ -765,22 +1422,16 @@ QVector<QMetaProperty> GameObject::metaProperties() const {
     return properties;
 }
 
-QVector<QMetaProperty> GameObject::storedMetaProperties() const {
+const QVector<QMetaProperty> &GameObject::storedMetaProperties() const {
 
-    static QHash<int, QVector<QMetaProperty> > storedProperties;
-    if (!storedProperties.contains(m_objectType.intValue())) {
-        QVector<QMetaProperty> properties;
-        int count = metaObject()->propertyCount(),
-            offset = GameObject::staticMetaObject.propertyOffset();
-        for (int i = offset; i < count; i++) {
-            QMetaProperty metaProperty = metaObject()->property(i);
-            if (metaProperty.isStored()) {
-                properties << metaProperty;
-            }
-        }
-        storedProperties[m_objectType.intValue()] = properties;
-    }
-    return storedProperties[m_objectType.intValue()];
+    return storedPropertyTables[m_objectType.intValue()].metaProperties;
+}
+
+int GameObject::storedPropertyIndex(const char *propertyName) const {
+
+    int propertyIndex = metaObject()->indexOfProperty(propertyName);
+    return propertyIndex > -1 ?
+           storedPropertyTables[m_objectType.intValue()].storedIndices[propertyIndex] : -1;
 }
 
 GameObject *GameObject::createByObjectType(Realm *realm, GameObjectType objectType, uint id,
@@ -823,83 +1474,37 @@ GameObject *GameObject::createByObjectType(Realm *realm, GameObjectType objectTy
     throw GameException(GameException::UnknownGameObjectType);
 }
 
-GameObject *GameObject::createFromFile(Realm *realm, const QString &path) {
+QVariantMap GameObject::parseJson(const QString &jsonString) {
+
+    bool ok;
+    QVariantMap map = JsonReader::parse(jsonString, &ok).toMap();
+    if (!ok) {
+        throw GameException(GameException::InvalidGameObjectJson, jsonString);
+    }
+    return map;
+}
 
-    QFileInfo fileInfo(path);
-    QString fileName = fileInfo.fileName();
-    QStringList components = fileName.split('.');
+GameObject *GameObject::createFromStorage(Realm *realm, const QString &key,
+                                          const QVariantMap &properties) {
+
+    QStringList components = key.split('.');
     if (components.length() != 2) {
-        throw GameException(GameException::InvalidGameObjectFileName, fileName);
+        throw GameException(GameException::InvalidGameObjectFileName, key);
     }
 
     bool validId;
     GameObjectType objectType = GameObjectType::fromString(Util::capitalize(components[0]));
     uint id = components[1].toUInt(&validId);
     if (objectType == GameObjectType::Unknown || !validId) {
-        throw GameException(GameException::InvalidGameObjectFileName, fileName);
+        throw GameException(GameException::InvalidGameObjectFileName, key);
     }
 
     GameObject *gameObject = createByObjectType(realm, objectType, id);
-    gameObject->load(path);
+    gameObject->loadProperties(properties);
+    gameObject->m_modifiedProperties = 0;
     return gameObject;
 }
 
-GameObject *GameObject::createCopy(GameObject *other) {
-
-    Q_ASSERT(other);
-    GameObject *copy = createByObjectType(other->realm(), other->objectType(), other->id(), Copy);
-    copy->m_deleted = other->m_deleted;
-
-    for (const QMetaProperty &metaProperty : other->storedMetaProperties()) {
-        if (metaProperty.type() == QVariant::UserType) {
-            if (metaProperty.userType() == GameEventMultiplierMapType) {
-                GameEventMultiplierMap map;
-                void *value = &map;
-                other->qt_metacall(QMetaObject::ReadProperty, metaProperty.propertyIndex(), &value);
-                copy->qt_metacall(QMetaObject::WriteProperty, metaProperty.propertyIndex(), &value);
-            } else if (metaProperty.userType() == GameObjectPtrType) {
-                GameObjectPtr pointer;
-                void *value = &pointer;
-                other->qt_metacall(QMetaObject::ReadProperty, metaProperty.propertyIndex(), &value);
-                pointer.unresolve();
-                copy->qt_metacall(QMetaObject::WriteProperty, metaProperty.propertyIndex(), &value);
-            } else if (metaProperty.userType() == GameObjectPtrListType) {
-                GameObjectPtrList list;
-                void *value = &list;
-                other->qt_metacall(QMetaObject::ReadProperty, metaProperty.propertyIndex(), &value);
-                list.unresolvePointers();
-                copy->qt_metacall(QMetaObject::WriteProperty, metaProperty.propertyIndex(), &value);
-            } else if (metaProperty.userType() == Point3DType) {
-                Point3D point;
-                void *value = &point;
-                other->qt_metacall(QMetaObject::ReadProperty, metaProperty.propertyIndex(), &value);
-                copy->qt_metacall(QMetaObject::WriteProperty, metaProperty.propertyIndex(), &value);
-            } else if (metaProperty.userType() == ScriptFunctionMapType) {
-                ScriptFunctionMap map;
-                void *value = &map;
-                other->qt_metacall(QMetaObject::ReadProperty, metaProperty.propertyIndex(), &value);
-                copy->qt_metacall(QMetaObject::WriteProperty, metaProperty.propertyIndex(), &value);
-            } else {
-                metaProperty.write(copy, metaProperty.read(other));
-            }
-        } else if (metaProperty.type() == QVariant::Map) {
-            QVariantMap map;
-            void *value = &map;
-            other->qt_metacall(QMetaObject::ReadProperty, metaProperty.propertyIndex(), &value);
-            copy->qt_metacall(QMetaObject::WriteProperty, metaProperty.propertyIndex(), &value);
-        } else if (metaProperty.type() == QVariant::String) {
-            QString string;
-            void *value = &string;
-            other->qt_metacall(QMetaObject::ReadProperty, metaProperty.propertyIndex(), &value);
-            copy->qt_metacall(QMetaObject::WriteProperty, metaProperty.propertyIndex(), &value);
-        } else {
-            metaProperty.write(copy, metaProperty.read(other));
-        }
-    }
-
-    return copy;
-}
-
 QScriptValue GameObject::toScriptValue(QScriptEngine *engine, GameObject *const &gameObject) {
 
     QScriptValue object = engine->newQObject(gameObject, QScriptEngine::QtOwnership,
@@ -975,9 +1580,13 @@ bool GameObject::mayReferenceOtherProperties() const {
     return ~m_options & Copy && m_realm->isInitialized();
 }
 
-void GameObject::setModified() {
+void GameObject::setModified(const char *propertyName) {
+
+    if (~m_options & Copy && ~m_options & DontSave) {
+        int index = storedPropertyIndex(propertyName);
+        Q_ASSERT(index > -1);
+        m_modifiedProperties |= (index > -1 ? Q_UINT64_C(1) << index : AllProperties);
 
-    if (~m_options & DontSave) {
         m_realm->addModifiedObject(this);
     }
 }
@@ -995,27 +1604,86 @@ void GameObject::registerPointer(GameObjectPtr *pointer) {
 
     if (m_options & NeverDelete) {
         return;
-    } 
+    }
 
-    Q_ASSERT(!m_pointers.contains(pointer));
-    m_pointers.append(pointer);
+    Q_ASSERT(!pointer->m_previousPointer && !pointer->m_nextPointer && m_firstPointer != pointer);
+
+    pointer->m_nextPointer = m_firstPointer;
+    if (m_firstPointer) {
+        m_firstPointer->m_previousPointer = pointer;
+    }
+    m_firstPointer = pointer;
 }
 
 void GameObject::unregisterPointer(GameObjectPtr *pointer) {
 
     if (m_options & NeverDelete) {
         return;
-    } 
+    }
 
-    int index = m_pointers.indexOf(pointer);
-    Q_ASSERT(index > -1);
-    m_pointers.remove(index);
+    unlinkPointer(pointer);
 
-    if (m_options & AutoDelete && m_pointers.isEmpty()) {
+    if (m_options & AutoDelete && !m_firstPointer) {
         setDeleted();
     }
 }
 
+void GameObject::unlinkPointer(GameObjectPtr *pointer) {
+
+    if (m_options & NeverDelete) {
+        return;
+    }
+
+    if (pointer->m_previousPointer) {
+        pointer->m_previousPointer->m_nextPointer = pointer->m_nextPointer;
+    } else {
+        Q_ASSERT(m_firstPointer == pointer);
+        m_firstPointer = pointer->m_nextPointer;
+    }
+    if (pointer->m_nextPointer) {
+        pointer->m_nextPointer->m_previousPointer = pointer->m_previousPointer;
+    }
+
+    pointer->m_previousPointer = nullptr;
+    pointer->m_nextPointer = nullptr;
+}
+
+void GameObject::relinkPointer(GameObjectPtr *source, GameObjectPtr *destination) {
+
+    if (m_options & NeverDelete) {
+        return;
+    }
+
+    Q_ASSERT(!destination->m_previousPointer && !destination->m_nextPointer);
+
+    destination->m_previousPointer = source->m_previousPointer;
+    destination->m_nextPointer = source->m_nextPointer;
+    if (destination->m_previousPointer) {
+        destination->m_previousPointer->m_nextPointer = destination;
+    } else {
+        Q_ASSERT(m_firstPointer == source);
+        m_firstPointer = destination;
+    }
+    if (destination->m_nextPointer) {
+        destination->m_nextPointer->m_previousPointer = destination;
+    }
+
+    source->m_previousPointer = nullptr;
+    source->m_nextPointer = nullptr;
+}
+
+int GameObject::detachPointers() {
+
+    int numPointers = 0;
+    while (m_firstPointer) {
+        GameObjectPtr *pointer = m_firstPointer;
+        unlinkPointer(pointer);
+        pointer->m_gameObject = nullptr;
+        numPointers++;
+    }
+    return numPointers;
+}
+
 void GameObject::changeName(const QString &newName) {
 
     if (m_options & AutomaticNameForms) {
@@ -1041,6 +1709,9 @@ void GameObject::changeName(const QString &newName) {
             } else {
                 m_indefiniteArticle = "a";
             }
+
+            setModified("plural");
+            setModified("indefiniteArticle");
         }
     }
 }
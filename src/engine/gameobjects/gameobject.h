@@ -14,6 +14,8 @@
 
 class GameObjectPtr;
 class GameObjectPtrList;
+class GameObjectSnapshot;
+class JsonWriter;
 class Realm;
 
 
@@ -41,8 +43,11 @@ class GameObject : public QObject {
     Q_OBJECT
 
     friend class GameObjectPtr;
+    friend class GameObjectSyncThread;
+    friend class Realm;
     friend void swap(GameObjectPtr &first, GameObjectPtr &second);
     friend void swapWithinList(GameObjectPtr &first, GameObjectPtr &second);
+    friend void relocateWithinList(GameObjectPtr &source, GameObjectPtr &destination);
 
     public:
         GameObject(Realm *realm, GameObjectType objectType, uint id, Options options = NoOptions);
@@ -185,22 +190,43 @@ class GameObject : public QObject {
         Q_INVOKABLE void setDeleted();
 
         QString toJsonString(Options options = NoOptions) const;
-
-        bool save();
-        void load(const QString &path);
+        void writeJson(JsonWriter &writer, Options options = NoOptions) const;
+
+        /**
+         * Takes a snapshot of the modified properties, which can be saved from another thread.
+         */
+        GameObjectSnapshot snapshot() const;
+        GameObjectSnapshot snapshot(quint64 properties) const;
+        static bool save(const GameObjectSnapshot &snapshot, JsonWriter &writer);
+
+        /**
+         * Writes a snapshot that contains all properties the way writeJson() would with the
+         * SkipId and IncludeTypeInfo options.
+         */
+        static void writeJson(const GameObjectSnapshot &snapshot, JsonWriter &writer);
+
+        void load();
         void loadJson(const QString &jsonString);
+        void loadProperties(const QVariantMap &map);
 
         void resolvePointers();
 
+        /**
+         * Registers this object with the realm as referring to every object it points to that
+         * is not loaded, so that the pointers are resolved once those objects are loaded.
+         */
+        void registerUnresolvedPointers();
+
         QVector<QMetaProperty> metaProperties() const;
-        QVector<QMetaProperty> storedMetaProperties() const;
+        const QVector<QMetaProperty> &storedMetaProperties() const;
+        int storedPropertyIndex(const char *propertyName) const;
 
         static GameObject *createByObjectType(Realm *realm, GameObjectType objectType, uint id = 0,
                                               Options options = NoOptions);
 
-        static GameObject *createFromFile(Realm *realm, const QString &path);
-
-        static GameObject *createCopy(GameObject *other);
+        static QVariantMap parseJson(const QString &jsonString);
+        static GameObject *createFromStorage(Realm *realm, const QString &key,
+                                             const QVariantMap &properties);
 
         static QScriptValue toScriptValue(QScriptEngine *engine, GameObject *const &gameObject);
         static void fromScriptValue(const QScriptValue &object, GameObject *&gameObject);
@@ -209,7 +235,7 @@ class GameObject : public QObject {
 
     protected:
         bool mayReferenceOtherProperties() const;
-        void setModified();
+        void setModified(const char *propertyName);
 
         void setAutoDelete(bool autoDelete);
 
@@ -217,6 +243,22 @@ class GameObject : public QObject {
 
         void registerPointer(GameObjectPtr *pointer);
         void unregisterPointer(GameObjectPtr *pointer);
+        void unlinkPointer(GameObjectPtr *pointer);
+
+        /**
+         * Makes the destination take the place of the source in the list of pointers to this
+         * object. The destination should not be registered with any object.
+         */
+        void relinkPointer(GameObjectPtr *source, GameObjectPtr *destination);
+
+        /**
+         * Detaches all pointers to this object, without removing them from their lists. They
+         * keep referring to the object by its ID, so they can be resolved again once the object
+         * is loaded again.
+         *
+         * @return The number of detached pointers.
+         */
+        int detachPointers();
 
         virtual void changeName(const QString &newName);
 
@@ -229,7 +271,11 @@ class GameObject : public QObject {
 
         bool m_deleted;
 
-        QVector<GameObjectPtr *> m_pointers;
+        int m_typeIndex;
+
+        quint64 m_modifiedProperties;
+
+        GameObjectPtr *m_firstPointer;
 
         QString m_name;
         QString m_plural;
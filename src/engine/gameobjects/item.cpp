@@ -24,7 +24,7 @@ void Item::setPosition(const Point3D &position) {
     if (m_position != position) {
         m_position = position;
 
-        setModified();
+        setModified("position");
     }
 }
 
@@ -33,7 +33,7 @@ void Item::setWeight(double weight) {
     if (m_weight != weight) {
         m_weight = weight;
 
-        setModified();
+        setModified("weight");
     }
 }
 
@@ -42,7 +42,7 @@ void Item::setCost(double cost) {
     if (m_cost != cost) {
         m_cost = cost;
 
-        setModified();
+        setModified("cost");
     }
 }
 
@@ -51,6 +51,6 @@ void Item::setFlags(ItemFlags flags) {
     if (m_flags != flags) {
         m_flags = flags;
 
-        setModified();
+        setModified("flags");
     }
 }
@@ -1,6 +1,7 @@
 #include "player.h"
 
 #include <QCryptographicHash>
+#include <QDateTime>
 
 #include "realm.h"
 #include "session.h"
@@ -13,13 +14,18 @@ Player::Player(Realm *realm, uint id, Options options) :
     super(realm, GameObjectType::Player, id, options),
     m_regenerationIntervalId(0),
     m_admin(false),
-    m_session(0) {
+    m_session(0),
+    m_offlineSince(QDateTime::currentMSecsSinceEpoch()) {
 
     setIndefiniteArticle("");
 }
 
 Player::~Player() {
 
+    if (m_regenerationIntervalId) {
+        realm()->unsubscribeFromTicks(m_regenerationIntervalId, this);
+    }
+
     if (~options() & Copy) {
         realm()->unregisterPlayer(this);
     }
@@ -30,7 +36,7 @@ void Player::setPasswordSalt(const QString &passwordSalt) {
     if (m_passwordSalt != passwordSalt) {
         m_passwordSalt = passwordSalt;
 
-        setModified();
+        setModified("passwordSalt");
     }
 }
 
@@ -39,7 +45,7 @@ void Player::setPasswordHash(const QString &passwordHash) {
     if (m_passwordHash != passwordHash) {
         m_passwordHash = passwordHash;
 
-        setModified();
+        setModified("passwordHash");
     }
 }
 
@@ -55,7 +61,8 @@ void Player::setPassword(const QString &password) {
     m_passwordHash = QCryptographicHash::hash(data, QCryptographicHash::Sha1).toBase64();
 #endif
 
-    setModified();
+    setModified("passwordSalt");
+    setModified("passwordHash");
 }
 
 bool Player::matchesPassword(const QString &password) const {
@@ -79,7 +86,7 @@ void Player::setAdmin(bool admin) {
     if (m_admin != admin) {
         m_admin = admin;
 
-        setModified();
+        setModified("admin");
     }
 }
 
@@ -88,12 +95,16 @@ void Player::setSession(Session *session) {
     m_session = session;
 
     if (m_session) {
-        m_regenerationIntervalId = realm()->startInterval(this, 30000);
+        m_regenerationIntervalId = realm()->subscribeToTicks(this, 30000);
 
         enter(currentRoom());
     } else {
-        realm()->stopInterval(m_regenerationIntervalId);
-        m_regenerationIntervalId = 0;
+        if (m_regenerationIntervalId) {
+            realm()->unsubscribeFromTicks(m_regenerationIntervalId, this);
+            m_regenerationIntervalId = 0;
+        }
+
+        m_offlineSince = QDateTime::currentMSecsSinceEpoch();
 
         if (secondsStunned() > 0) {
             setLeaveOnActive(true);
@@ -114,6 +125,11 @@ void Player::send(const QString &_message, int color) const {
         return;
     }
 
+    m_session->send(formatMessage(_message, color));
+}
+
+QString Player::formatMessage(const QString &_message, int color) {
+
     QString message;
     if (_message.endsWith("\n") ||
         (_message.startsWith("{") && _message.endsWith("}"))) {
@@ -126,7 +142,7 @@ void Player::send(const QString &_message, int color) const {
         message = Util::colorize(message, (Color) color);
     }
 
-    m_session->send(message);
+    return message;
 }
 
 void Player::quit() {
@@ -35,8 +35,19 @@ class Player : public Character {
         void setSession(Session *session);
         Q_INVOKABLE bool isOnline() const;
 
+        /**
+         * Time (in milliseconds since the epoch) at which the player signed out, or at which
+         * the player was loaded if they did not sign in since.
+         */
+        qint64 offlineSince() const { return m_offlineSince; }
+
         virtual void send(const QString &message, int color = Silver) const;
 
+        /**
+         * Returns the message as it is written to the session by send().
+         */
+        static QString formatMessage(const QString &message, int color = Silver);
+
         Q_INVOKABLE void quit();
 
         Q_INVOKABLE virtual void invokeTimer(int timerId);
@@ -53,6 +64,7 @@ class Player : public Character {
         bool m_admin;
 
         Session *m_session;
+        qint64 m_offlineSince;
 };
 
 #endif // PLAYER_H
@@ -1,16 +1,32 @@
 #include "portal.h"
 
+#include "realm.h"
 #include "room.h"
 
 
 #define super GameObject
 
+static void invalidateRoom(const GameObjectPtr &roomPtr) {
+
+    Room *room = roomPtr.unsafeCast<Room *>();
+    if (room) {
+        room->realm()->roomGraph().invalidateRoom(room);
+    }
+}
+
 Portal::Portal(Realm *realm, uint id, Options options) :
     super(realm, GameObjectType::Portal, id, options),
     m_flags(PortalFlags::NoFlags) {
 }
 
 Portal::~Portal() {
+
+    // the rooms drop the portal from their lists without being told, and rooms are never
+    // deleted, so they're still around to have their edges rebuilt without it
+    if (~options() & Copy) {
+        invalidateRoom(m_room);
+        invalidateRoom(m_room2);
+    }
 }
 
 void Portal::setName2(const QString &name2) {
@@ -18,7 +34,7 @@ void Portal::setName2(const QString &name2) {
     if (m_name2 != name2) {
         m_name2 = name2;
 
-        setModified();
+        setModified("name2");
     }
 }
 
@@ -27,7 +43,7 @@ void Portal::setDescription2(const QString &description2) {
     if (m_description2 != description2) {
         m_description2 = description2;
 
-        setModified();
+        setModified("description2");
     }
 }
 
@@ -36,7 +52,7 @@ void Portal::setDestination(const QString &destination) {
     if (m_destination != destination) {
         m_destination = destination;
 
-        setModified();
+        setModified("destination");
     }
 }
 
@@ -45,25 +61,29 @@ void Portal::setDestination2(const QString &destination2) {
     if (m_destination2 != destination2) {
         m_destination2 = destination2;
 
-        setModified();
+        setModified("destination2");
     }
 }
 
 void Portal::setRoom(const GameObjectPtr &room) {
 
     if (m_room != room) {
+        invalidateRoom(m_room);
         m_room = room;
+        invalidateRoom(m_room);
 
-        setModified();
+        setModified("room");
     }
 }
 
 void Portal::setRoom2(const GameObjectPtr &room2) {
 
     if (m_room2 != room2) {
+        invalidateRoom(m_room2);
         m_room2 = room2;
+        invalidateRoom(m_room2);
 
-        setModified();
+        setModified("room2");
     }
 }
 
@@ -81,7 +101,11 @@ void Portal::setFlags(PortalFlags flags) {
     if (m_flags != flags) {
         m_flags = flags;
 
-        setModified();
+        if (~options() & Copy) {
+            realm()->roomGraph().updatePortal(this);
+        }
+
+        setModified("flags");
     }
 }
 
@@ -90,7 +114,11 @@ void Portal::setEventMultipliers(const GameEventMultiplierMap &multipliers) {
     if (m_eventMultipliers != multipliers) {
         m_eventMultipliers = multipliers;
 
-        setModified();
+        if (~options() & Copy) {
+            realm()->roomGraph().updatePortal(this);
+        }
+
+        setModified("eventMultipliers");
     }
 }
 
@@ -21,7 +21,7 @@ void Race::setAdjective(const QString &adjective) {
     if (m_adjective != adjective) {
         m_adjective = adjective;
 
-        setModified();
+        setModified("adjective");
     }
 }
 
@@ -30,7 +30,7 @@ void Race::setStats(const CharacterStats &stats) {
     if (m_stats != stats) {
         m_stats = stats;
 
-        setModified();
+        setModified("stats");
     }
 }
 
@@ -39,7 +39,7 @@ void Race::setStatsSuggestion(const CharacterStats &statsSuggestion) {
     if (m_statsSuggestion != statsSuggestion) {
         m_statsSuggestion = statsSuggestion;
 
-        setModified();
+        setModified("statsSuggestion");
     }
 }
 
@@ -48,7 +48,7 @@ void Race::setHeight(int height) {
     if (m_height != height) {
         m_height = height;
 
-        setModified();
+        setModified("height");
     }
 }
 
@@ -57,7 +57,7 @@ void Race::setWeight(int weight) {
     if (m_weight != weight) {
         m_weight = weight;
 
-        setModified();
+        setModified("weight");
     }
 }
 
@@ -66,7 +66,7 @@ void Race::setClasses(const GameObjectPtrList &classes) {
     if (m_classes != classes) {
         m_classes = classes;
 
-        setModified();
+        setModified("classes");
     }
 }
 
@@ -75,7 +75,7 @@ void Race::setStartingRoom(const GameObjectPtr &startingRoom) {
     if (m_startingRoom != startingRoom) {
         m_startingRoom = startingRoom;
 
-        setModified();
+        setModified("startingRoom");
     }
 }
 
@@ -84,6 +84,6 @@ void Race::setPlayerSelectable(bool playerSelectable) {
     if (m_playerSelectable != playerSelectable) {
         m_playerSelectable = playerSelectable;
 
-        setModified();
+        setModified("playerSelectable");
     }
 }
@@ -1,13 +1,28 @@
 #include "realm.h"
 
+#include <exception>
+
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QRunnable>
+#include <QThreadPool>
+
+#include "binarysnapshot.h"
 #include "commandinterpreter.h"
 #include "commandregistry.h"
+#include "container.h"
 #include "diskutil.h"
+#include "event.h"
 #include "gameevent.h"
 #include "gameexception.h"
+#include "jsonreader.h"
+#include "jsonwriter.h"
 #include "logutil.h"
 #include "player.h"
 #include "room.h"
+#include "scriptengine.h"
+#include "storagebackend.h"
 #include "triggerregistry.h"
 #include "util.h"
 
@@ -15,18 +30,309 @@
 static Realm *s_instance = nullptr;
 
 
+// objects with IDs below this are looked up in a table indexed by their ID, objects with higher
+// IDs in a hash, so that a single large ID cannot grow the table without bound
+static const uint OBJECT_TABLE_SIZE = 0x1000000;
+
+// backups take the snapshots of this many objects per event
+static const int NUM_BACKUP_SNAPSHOTS_PER_EVENT = 1000;
+
+// properties through which characters and containers hold the items they own
+static const char *ItemProperties[] = {
+    "inventory", "weapon", "secondaryWeapon", "shield", "items"
+};
+
+// properties that are needed to index players and the items they hold
+static bool isIndexProperty(const QStringRef &name) {
+
+    if (name == QLatin1String("name")) {
+        return true;
+    }
+    for (const char *itemProperty : ItemProperties) {
+        if (name == QLatin1String(itemProperty)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// reads only the index properties of an object, the values of all other properties are skipped
+// without being decoded
+static QVariantMap parseIndexProperties(const QString &jsonString) {
+
+    QVariantMap properties;
+    JsonReader reader(jsonString);
+    if (reader.next() == JsonReader::BeginObject) {
+        while (reader.next() == JsonReader::Key) {
+            if (!isIndexProperty(reader.stringRef())) {
+                reader.next();
+                if (!reader.skipValue()) {
+                    break;
+                }
+                continue;
+            }
+
+            QString name = reader.string();
+            reader.next();
+            QVariant value = reader.readValue();
+            if (reader.hasError()) {
+                break;
+            }
+            properties.insert(name, value);
+        }
+    }
+    if (reader.token() != JsonReader::EndObject) {
+        throw GameException(GameException::InvalidGameObjectJson, jsonString);
+    }
+    return properties;
+}
+
+
+struct LoadedObject {
+    QString key;
+    int snapshotIndex;
+
+    // players and their items are only indexed, so only their index properties are read
+    bool indexOnly;
+
+    QVariantMap properties;
+    std::exception_ptr exception;
+};
+
+class ParseObjectsTask : public QRunnable {
+
+    public:
+        ParseObjectsTask(StorageBackend *storageBackend, BinarySnapshotReader *snapshot,
+                         LoadedObject *objects, const int *indices, int begin, int end) :
+            QRunnable(),
+            m_storageBackend(storageBackend),
+            m_snapshot(snapshot),
+            m_objects(objects),
+            m_indices(indices),
+            m_begin(begin),
+            m_end(end) {
+        }
+
+        virtual void run() {
+
+            for (int i = m_begin; i < m_end; i++) {
+                LoadedObject &object = m_objects[m_indices[i]];
+                try {
+                    if (object.snapshotIndex > -1) {
+                        loadFromSnapshot(object);
+                    } else {
+                        QString jsonString;
+                        if (!m_storageBackend->readObject(object.key, &jsonString)) {
+                            throw GameException(GameException::CouldNotOpenGameObjectFile,
+                                                object.key);
+                        }
+                        object.properties = (object.indexOnly ?
+                                             parseIndexProperties(jsonString) :
+                                             GameObject::parseJson(jsonString));
+                    }
+                } catch (...) {
+                    object.exception = std::current_exception();
+                }
+            }
+        }
+
+    private:
+        StorageBackend *m_storageBackend;
+        BinarySnapshotReader *m_snapshot;
+        LoadedObject *m_objects;
+        const int *m_indices;
+        int m_begin;
+        int m_end;
+
+        void loadFromSnapshot(LoadedObject &object) {
+
+            QString jsonString = m_snapshot->objectJson(object.snapshotIndex);
+            if (!jsonString.isEmpty()) {
+                object.properties = (object.indexOnly ? parseIndexProperties(jsonString) :
+                                                        GameObject::parseJson(jsonString));
+                return;
+            }
+
+            // values that are still JSON encoded are parsed together in a single document
+            QMap<QString, QString> jsonProperties;
+            object.properties = m_snapshot->objectProperties(object.snapshotIndex,
+                                                             &jsonProperties);
+            if (object.indexOnly) {
+                for (auto it = jsonProperties.begin(); it != jsonProperties.end(); ) {
+                    if (isIndexProperty(QStringRef(&it.key()))) {
+                        ++it;
+                    } else {
+                        it = jsonProperties.erase(it);
+                    }
+                }
+            }
+            if (!jsonProperties.isEmpty()) {
+                QVariantMap parsedProperties =
+                        GameObject::parseJson(StorageBackend::patchJson(QString(), jsonProperties));
+                for (auto it = parsedProperties.constBegin();
+                     it != parsedProperties.constEnd(); ++it) {
+                    object.properties.insert(it.key(), it.value());
+                }
+            }
+        }
+};
+
+// reading and parsing is independent for every object, so we spread it over a thread pool
+static void parseObjects(StorageBackend *storageBackend, BinarySnapshotReader *snapshot,
+                         QVector<LoadedObject> &objects, const QVector<int> &indices) {
+
+    QThreadPool threadPool;
+    int numTasks = qMin(indices.size(), 4 * threadPool.maxThreadCount());
+    for (int i = 0; i < numTasks; i++) {
+        threadPool.start(new ParseObjectsTask(storageBackend, snapshot, objects.data(),
+                                              indices.constData(),
+                                              i * indices.size() / numTasks,
+                                              (i + 1) * indices.size() / numTasks));
+    }
+    threadPool.waitForDone();
+}
+
+
+class BackupSnapshotEvent : public Event {
+
+    public:
+        BackupSnapshotEvent() :
+            Event() {
+        }
+
+        virtual void process() {
+
+            Realm::instance()->takeBackupSnapshots();
+        }
+
+        virtual QString toString() const {
+
+            return "Backup snapshots: " + Realm::instance()->m_backupPath;
+        }
+};
+
+
+class PlayerLoadedEvent : public Event {
+
+    public:
+        PlayerLoadedEvent(const QString &name, uint id, const QElapsedTimer &timer) :
+            Event(),
+            m_name(name),
+            m_id(id),
+            m_timer(timer) {
+        }
+
+        virtual void process() {
+
+            Realm::instance()->playerLoaded(m_name, m_id, objects, errorString,
+                                            m_timer.elapsed());
+        }
+
+        virtual QString toString() const {
+
+            return "Player loaded: " + m_name;
+        }
+
+        QVector<Realm::StoredObject> objects;
+        QString errorString;
+
+    private:
+        QString m_name;
+        uint m_id;
+        QElapsedTimer m_timer;
+};
+
+// reads and parses a player and their items on the sync thread, after which the game thread
+// only needs to create the objects
+class LoadPlayerJob : public SyncJob {
+
+    public:
+        LoadPlayerJob(const QString &name, uint id) :
+            SyncJob(),
+            m_name(name),
+            m_id(id) {
+
+            m_timer.start();
+        }
+
+        virtual void run(StorageBackend *storageBackend) {
+
+            PlayerLoadedEvent *event = new PlayerLoadedEvent(m_name, m_id, m_timer);
+            Realm::readPlayer(storageBackend, m_id, &event->objects, &event->errorString);
+            Realm::instance()->enqueueEvent(event);
+        }
+
+    private:
+        QString m_name;
+        uint m_id;
+        QElapsedTimer m_timer;
+};
+
+
+void Realm::appendItemKeys(const QVariantMap &properties, QStringList *keys) {
+
+    for (const char *name : ItemProperties) {
+        QVariant value = properties.value(name);
+        QVariantList pointers = (value.type() == QVariant::List ? value.toList() :
+                                                                  QVariantList() << value);
+        for (const QVariant &pointer : pointers) {
+            QStringList components = pointer.toString().split(':');
+            uint id = (components.length() == 2 ? components[1].toUInt() : 0);
+            if (id > 0) {
+                keys->append(StorageBackend::objectKey(components[0], id));
+            }
+        }
+    }
+}
+
+// collects the items held through the given pointers, counting the pointers as well
+static void appendItems(const GameObjectPtrList &pointers, QVector<GameObject *> *items,
+                        int *numPointers) {
+
+    for (const GameObjectPtr &pointer : pointers) {
+        GameObject *item = pointer.unsafeCast<GameObject *>();
+        if (!item) {
+            continue;
+        }
+
+        (*numPointers)++;
+        if (!items->contains(item)) {
+            items->append(item);
+        }
+    }
+}
+
+
 #define super GameObject
 
 Realm::Realm(Options options) :
     super(this, GameObjectType::Realm, 0, (Options) (options | DontRegister | NeverDelete)),
     m_initialized(false),
     m_nextId(1),
+    m_playerEvictionDelay(15 * 60 * 1000),
+    m_evictionIntervalId(0),
+    m_lineOfSightCache(&m_roomGraph),
+    m_parallelPropagator(&m_roomGraph),
     m_timeIntervalId(0),
     m_gameThread(this),
+    m_numModifications(0),
+    m_syncWindow(500),
+    m_syncDeadline(0),
+    m_backupThread(&m_syncThread),
+    m_takingBackupSnapshots(false),
+    m_backupRecipientId(0),
+    m_backupProgress(0),
+    m_storageBackend(nullptr),
+    m_binarySnapshotEnabled(false),
     m_scriptEngine(nullptr) {
 
     if (~options & Copy) {
         s_instance = this;
+
+        m_storageBackend = StorageBackend::create();
+
+        QByteArray binarySnapshot = qgetenv("PT_BINARY_SNAPSHOT");
+        m_binarySnapshotEnabled = (!binarySnapshot.isEmpty() && binarySnapshot != "0");
     }
 
     m_commandRegistry = new CommandRegistry();
@@ -36,17 +342,25 @@ Realm::Realm(Options options) :
 
     m_triggerRegistry = new TriggerRegistry();
 
+    QByteArray syncWindow = qgetenv("PT_SYNC_WINDOW");
+    if (!syncWindow.isEmpty()) {
+        m_syncWindow = qMax(syncWindow.toInt(), 0);
+    }
+
+    QByteArray playerEvictionDelay = qgetenv("PT_PLAYER_EVICTION_DELAY");
+    if (!playerEvictionDelay.isEmpty()) {
+        m_playerEvictionDelay = qMax(playerEvictionDelay.toInt(), 0) * 1000;
+    }
+
     m_reservedNames << "all" << "down" << "east" << "north" << "northeast" << "northwest" << "out"
                     << "room" << "south" << "southeast" << "southwest" << "west";
     for (const QString &commandName : m_commandRegistry->commandNames()) {
         m_reservedNames.append(commandName);
     }
 
-    for (uint i = 0; i < GameObjectType::NumValues; i++) {
-        m_numObjects[i] = 0;
+    if (~options & Copy) {
+        load();
     }
-
-    load(DiskUtil::gameObjectPath("Realm", id()));
 }
 
 Realm::~Realm() {
@@ -55,16 +369,35 @@ Realm::~Realm() {
         stopInterval(m_timeIntervalId);
         m_timeIntervalId = 0;
     }
+    if (m_evictionIntervalId) {
+        stopInterval(m_evictionIntervalId);
+        m_evictionIntervalId = 0;
+    }
 
     m_gameThread.terminate();
     m_gameThread.wait();
 
+    m_backupThread.wait();
+
+    enqueueModifiedObjects();
+
     m_syncThread.terminate();
     m_logThread.terminate();
 
     m_syncThread.wait();
     m_logThread.wait();
 
+    // written after all modifications are synced, so that the snapshot is newer than anything
+    // the backend wrote, but before the backend is closed, because players that are not loaded
+    // are read back from it. the backend is flushed first, because the compaction that may
+    // trigger rewrites its files, which would make the snapshot appear out of date
+    if (m_binarySnapshotEnabled) {
+        m_storageBackend->flush();
+        writeBinarySnapshot();
+    }
+
+    delete m_storageBackend;
+
     delete m_triggerRegistry;
     delete m_commandInterpreter;
     delete m_commandRegistry;
@@ -75,18 +408,157 @@ Realm *Realm::instance() {
     return s_instance;
 }
 
+QString Realm::binarySnapshotPath() {
+
+    return DiskUtil::dataDir() + "/snapshot/realm.snapshot";
+}
+
 void Realm::init() {
 
-    for (const QString &fileName : DiskUtil::dataDirFileList()) {
-        if (!fileName.startsWith("realm.")) {
-            createFromFile(this, DiskUtil::dataDir() + "/" + fileName);
+    QElapsedTimer timer;
+    timer.start();
+
+    BinarySnapshotReader *snapshot = nullptr;
+    if (m_binarySnapshotEnabled) {
+        QFileInfo snapshotInfo(binarySnapshotPath());
+        if (!snapshotInfo.exists()) {
+            LogUtil::logInfo("No binary snapshot found");
+        } else if (snapshotInfo.lastModified() <= m_storageBackend->lastModified()) {
+            LogUtil::logInfo("Binary snapshot is out of date, ignoring it");
+        } else {
+            snapshot = new BinarySnapshotReader(snapshotInfo.filePath());
+            if (!snapshot->open()) {
+                LogUtil::logError("Could not open binary snapshot %1, ignoring it",
+                                  snapshotInfo.filePath());
+                delete snapshot;
+                snapshot = nullptr;
+            }
+        }
+    }
+
+    QString source = (snapshot ? "binary snapshot" : "storage");
+
+    QVector<LoadedObject> loadedObjects;
+    if (snapshot) {
+        loadedObjects.resize(snapshot->numObjects());
+        for (int i = 0; i < snapshot->numObjects(); i++) {
+            loadedObjects[i].key = snapshot->objectKey(i);
+            loadedObjects[i].snapshotIndex = i;
+            loadedObjects[i].indexOnly = false;
+        }
+    } else {
+        for (const QString &key : m_storageBackend->objectKeys()) {
+            if (!key.startsWith("realm.")) {
+                LoadedObject loadedObject;
+                loadedObject.key = key;
+                loadedObject.snapshotIndex = -1;
+                loadedObject.indexOnly = false;
+                loadedObjects.append(loadedObject);
+            }
+        }
+    }
+
+    QHash<QString, int> indices;
+    QVector<int> batch;
+    for (int i = 0; i < loadedObjects.size(); i++) {
+        LoadedObject &loadedObject = loadedObjects[i];
+        indices.insert(loadedObject.key, i);
+
+        bool validId;
+        uint id = loadedObject.key.section('.', 1).toUInt(&validId);
+        if (!validId || id > MaxObjectId) {
+            throw GameException(GameException::InvalidGameObjectFileName, loadedObject.key);
+        }
+        // make sure the IDs of objects that are not loaded are not handed out again
+        m_nextId = qMax(m_nextId, id + 1);
+
+        if (loadedObject.key.startsWith("player.")) {
+            loadedObject.indexOnly = true;
+            batch.append(i);
         }
     }
 
-    for (GameObject *object : m_objectMap) {
+    // players are only indexed by name, they are loaded together with their items when they
+    // are needed. so of the players, and of the items they hold, only the properties that tell
+    // their names and items are read, one level of items at a time
+    int numIndexed = 0;
+    while (!batch.isEmpty()) {
+        parseObjects(m_storageBackend, snapshot, loadedObjects, batch);
+        numIndexed += batch.size();
+
+        QStringList itemKeys;
+        for (int index : batch) {
+            const LoadedObject &loadedObject = loadedObjects[index];
+            if (loadedObject.exception) {
+                std::rethrow_exception(loadedObject.exception);
+            }
+            if (loadedObject.key.startsWith("player.")) {
+                m_playerIds.insert(loadedObject.properties.value("name").toString(),
+                                   loadedObject.key.section('.', 1).toUInt());
+            }
+            appendItemKeys(loadedObject.properties, &itemKeys);
+        }
+
+        batch.clear();
+        for (const QString &itemKey : itemKeys) {
+            int index = indices.value(itemKey, -1);
+            if (index > -1 && !loadedObjects[index].indexOnly) {
+                loadedObjects[index].indexOnly = true;
+                batch.append(index);
+            }
+        }
+    }
+    indices.clear();
+
+    for (const LoadedObject &loadedObject : loadedObjects) {
+        if (loadedObject.indexOnly) {
+            m_unloadedObjectIds.insert(loadedObject.key.section('.', 1).toUInt());
+        }
+    }
+
+    qint64 indexTime = timer.restart();
+
+    for (int i = 0; i < loadedObjects.size(); i++) {
+        if (!loadedObjects[i].indexOnly) {
+            batch.append(i);
+        }
+    }
+    parseObjects(m_storageBackend, snapshot, loadedObjects, batch);
+
+    delete snapshot;
+
+    qint64 parseTime = timer.restart();
+
+    // creating objects registers them with the realm, which is not thread-safe
+    for (int index : batch) {
+        const LoadedObject &loadedObject = loadedObjects[index];
+        if (loadedObject.exception) {
+            std::rethrow_exception(loadedObject.exception);
+        }
+        createFromStorage(this, loadedObject.key, loadedObject.properties);
+    }
+    loadedObjects.clear();
+
+    qint64 createTime = timer.restart();
+
+    QVector<GameObject *> objects = allObjects(GameObjectType::Unknown);
+    for (GameObject *object : objects) {
         object->resolvePointers();
     }
 
+    m_roomGraph.update();
+
+    qint64 resolveTime = timer.restart();
+
+    LogUtil::logInfo(QString("Loaded %1 objects from %2 in %3 ms (index: %4 ms, read and parse: "
+                             "%5 ms, create: %6 ms, resolve pointers: %7 ms), indexed %8 "
+                             "players and %9 objects they hold, %10 room connections")
+                     .arg(objects.size()).arg(source)
+                     .arg(indexTime + parseTime + createTime + resolveTime)
+                     .arg(indexTime).arg(parseTime).arg(createTime).arg(resolveTime)
+                     .arg(m_playerIds.size()).arg(numIndexed - m_playerIds.size())
+                     .arg(m_roomGraph.numEdges()));
+
     m_syncThread.start(QThread::LowestPriority);
     m_logThread.start(QThread::LowestPriority);
 
@@ -94,11 +566,14 @@ void Realm::init() {
 
     super::init();
 
-    for (GameObject *object : m_objectMap) {
+    for (GameObject *object : objects) {
         object->init();
     }
 
     m_timeIntervalId = startInterval(this, 150000);
+    if (m_playerEvictionDelay > 0) {
+        m_evictionIntervalId = startInterval(this, 60000);
+    }
 
     m_commandRegistry->moveToThread(&m_gameThread);
     m_commandInterpreter->moveToThread(&m_gameThread);
@@ -107,12 +582,207 @@ void Realm::init() {
     m_gameThread.start(QThread::HighestPriority);
 }
 
+bool Realm::writeBinarySnapshot() {
+
+    QElapsedTimer timer;
+    timer.start();
+
+    BinarySnapshotWriter writer;
+    JsonWriter jsonWriter;
+    for (GameObject *object : allObjects(GameObjectType::Unknown)) {
+        if (object->m_deleted || object->m_options & DontSave) {
+            continue;
+        }
+
+        jsonWriter.clear();
+        object->writeJson(jsonWriter, (Options) (SkipId | IncludeTypeInfo));
+        writer.addObject(object->objectType().toString(), object->id(), jsonWriter.toString());
+    }
+
+    // players that are not loaded, and their items, are copied from storage
+    QStringList keys;
+    for (auto it = m_playerIds.constBegin(); it != m_playerIds.constEnd(); ++it) {
+        if (!m_playerMap.contains(it.key())) {
+            keys.append(StorageBackend::objectKey("player", it.value()));
+        }
+    }
+    QSet<QString> copiedKeys;
+    for (int i = 0; i < keys.size(); i++) {
+        uint id = keys[i].section('.', 1).toUInt();
+        if (copiedKeys.contains(keys[i]) || getObject(GameObjectType::Unknown, id)) {
+            continue;
+        }
+        copiedKeys.insert(keys[i]);
+
+        QString jsonString;
+        try {
+            if (!m_storageBackend->readObject(keys[i], &jsonString)) {
+                if (!keys[i].startsWith("player.")) {
+                    continue;
+                }
+                throw GameException(GameException::CouldNotOpenGameObjectFile, keys[i]);
+            }
+            appendItemKeys(parseJson(jsonString), &keys);
+        } catch (const GameException &exception) {
+            LogUtil::logError("Could not write binary snapshot: %1", exception.what());
+            return false;
+        }
+
+        writer.addObject(Util::capitalize(keys[i].section('.', 0, 0)), id, jsonString);
+    }
+
+    QString path = binarySnapshotPath();
+    QString directory = QFileInfo(path).path();
+    if (!QDir(directory).exists() && !QDir().mkpath(directory)) {
+        LogUtil::logError("Could not create snapshot directory: %1", directory);
+        return false;
+    }
+
+    if (!writer.write(path)) {
+        LogUtil::logError("Could not write binary snapshot %1", path);
+        return false;
+    }
+
+    LogUtil::logInfo("Binary snapshot written in %1 ms", QString::number(timer.elapsed()));
+    return true;
+}
+
+bool Realm::startBackup(const QString &path, Player *recipient) {
+
+    if (isBackupInProgress()) {
+        return false;
+    }
+
+    m_backupTimer.start();
+
+    m_takingBackupSnapshots = true;
+    m_backupPath = path;
+    m_backupRecipientId = (recipient ? recipient->id() : 0);
+    m_backupObjectIds.reserve(numObjects(GameObjectType::Unknown));
+    for (const QVector<GameObject *> &objectsOfType : m_objectsByType) {
+        for (GameObject *object : objectsOfType) {
+            m_backupObjectIds.append(object->id());
+        }
+    }
+    m_backupProgress = 0;
+
+    enqueueEvent(new BackupSnapshotEvent());
+    return true;
+}
+
+bool Realm::isBackupInProgress() const {
+
+    return isTakingBackupSnapshots() || m_backupThread.isRunning();
+}
+
+const QString &Realm::backupPath() const {
+
+    return isTakingBackupSnapshots() ? m_backupPath : m_backupThread.path();
+}
+
+void Realm::takeBackupSnapshots() {
+
+    int end = qMin(m_backupProgress + NUM_BACKUP_SNAPSHOTS_PER_EVENT, m_backupObjectIds.size());
+    for (; m_backupProgress < end; m_backupProgress++) {
+        uint id = m_backupObjectIds[m_backupProgress];
+        if (!m_backupModifiedIds.contains(id)) {
+            takeBackupSnapshot(id);
+        }
+    }
+
+    if (m_backupProgress < m_backupObjectIds.size()) {
+        enqueueEvent(new BackupSnapshotEvent());
+        return;
+    }
+
+    // objects that changed while the snapshots were being taken are only captured now, so that
+    // all snapshots reflect the state at this event
+    for (uint id : m_backupModifiedIds) {
+        m_backupSnapshots.remove(id);
+        takeBackupSnapshot(id);
+    }
+
+    QStringList storedKeys;
+    for (auto it = m_playerIds.constBegin(); it != m_playerIds.constEnd(); ++it) {
+        if (!m_playerMap.contains(it.key())) {
+            storedKeys.append(StorageBackend::objectKey("player", it.value()));
+        }
+    }
+
+    QVector<GameObjectSnapshot> snapshots;
+    snapshots.reserve(m_backupSnapshots.size());
+    for (const GameObjectSnapshot &snapshot : m_backupSnapshots) {
+        snapshots.append(snapshot);
+    }
+    m_backupThread.startBackup(m_backupPath, snapshots, storedKeys, m_backupRecipientId);
+
+    LogUtil::logInfo("Backup %1 started, taking snapshots of %2 objects took %3 ms, of which "
+                     "%4 were taken again at the end", m_backupPath,
+                     QString::number(snapshots.size()), QString::number(m_backupTimer.elapsed()),
+                     QString::number(m_backupModifiedIds.size()));
+
+    m_takingBackupSnapshots = false;
+    m_backupPath.clear();
+    m_backupRecipientId = 0;
+    m_backupObjectIds.clear();
+    m_backupProgress = 0;
+    m_backupSnapshots.clear();
+    m_backupModifiedIds.clear();
+}
+
+void Realm::takeBackupSnapshot(uint id) {
+
+    GameObject *object = (id < OBJECT_TABLE_SIZE ? m_objects.value(id) :
+                                                   m_overflowObjects.value(id));
+    if (!object || object->m_deleted || object->m_options & DontSave) {
+        return;
+    }
+
+    m_backupSnapshots.insert(id, object->snapshot(AllProperties));
+}
+
+QString Realm::backupDir() {
+
+    return DiskUtil::dataDir() + "/backup";
+}
+
+QString Realm::backupFilePath(const QString &fileName) {
+
+    if (fileName.isEmpty()) {
+        return backupDir() + "/realm-" +
+               QDateTime::currentDateTime().toString("yyyyMMdd-hhmmss") + ".snapshot";
+    }
+
+    if (fileName.startsWith('.') || fileName.contains('/') || fileName.contains('\\')) {
+        return QString();
+    }
+
+    return backupDir() + "/" + fileName;
+}
+
 void Realm::registerObject(GameObject *gameObject) {
 
     Q_ASSERT(gameObject);
 
     uint id = gameObject->id();
-    m_objectMap.insert(id, gameObject);
+    if (id > MaxObjectId) {
+        throw GameException(GameException::InvalidObjectId, gameObject->objectType(), id);
+    }
+    if (id < OBJECT_TABLE_SIZE) {
+        if (id >= (uint) m_objects.size()) {
+            m_objects.resize(id + 1);
+        }
+
+        Q_ASSERT(!m_objects[id]);
+        m_objects[id] = gameObject;
+    } else {
+        Q_ASSERT(!m_overflowObjects.contains(id));
+        m_overflowObjects.insert(id, gameObject);
+    }
+
+    if (isTakingBackupSnapshots()) {
+        m_backupModifiedIds.insert(id);
+    }
 
     int objectType = gameObject->objectType().value;
     switch (objectType) {
@@ -129,27 +799,49 @@ void Realm::registerObject(GameObject *gameObject) {
             m_races.append(gameObject);
             break;
         default:
-            m_numObjects[objectType]++;
             break;
     }
 
+    QVector<GameObject *> &objects = m_objectsByType[objectType];
+    gameObject->m_typeIndex = objects.size();
+    objects.append(gameObject);
+
     if (id >= m_nextId) {
-        m_nextId = id;
-        do {
-            m_nextId++;
-        } while (m_objectMap.contains(m_nextId));
+        m_nextId = id + 1;
     }
 }
 
 void Realm::unregisterObject(GameObject *gameObject) {
 
     Q_ASSERT(gameObject);
-    m_objectMap.remove(gameObject->id());
 
-    int objectType = gameObject->objectType().value;
-    if (m_numObjects[objectType] > 0) {
-        m_numObjects[objectType]--;
+    m_modifiedObjects.remove(gameObject);
+
+    uint id = gameObject->id();
+    if (isTakingBackupSnapshots()) {
+        m_backupModifiedIds.insert(id);
+    }
+    if (id < OBJECT_TABLE_SIZE) {
+        if (m_objects.value(id) == gameObject) {
+            m_objects[id] = nullptr;
+        }
+    } else if (m_overflowObjects.value(id) == gameObject) {
+        m_overflowObjects.remove(id);
+    }
+
+    int index = gameObject->m_typeIndex;
+    if (index == -1) {
+        return;
     }
+
+    QVector<GameObject *> &objects = m_objectsByType[gameObject->objectType().value];
+    Q_ASSERT(objects[index] == gameObject);
+    GameObject *last = objects.last();
+    objects[index] = last;
+    last->m_typeIndex = index;
+    objects.removeLast();
+
+    gameObject->m_typeIndex = -1;
 }
 
 GameObject *Realm::getObject(GameObjectType objectType, uint id) {
@@ -160,12 +852,10 @@ GameObject *Realm::getObject(GameObjectType objectType, uint id) {
         }
     }
 
-    if (m_objectMap.contains(id)) {
-        GameObject *object = m_objectMap[id];
-        Q_ASSERT(object);
-        if (objectType == GameObjectType::Unknown || object->objectType() == objectType) {
-            return object;
-        }
+    GameObject *object = (id < OBJECT_TABLE_SIZE ? m_objects.value(id) :
+                                                   m_overflowObjects.value(id));
+    if (object && (objectType == GameObjectType::Unknown || object->objectType() == objectType)) {
+        return object;
     }
 
     return nullptr;
@@ -183,22 +873,31 @@ GameObject *Realm::createObject(const QString &objectType) {
 
 QVector<GameObject *> Realm::allObjects(GameObjectType objectType) const {
 
+    if (objectType != GameObjectType::Unknown) {
+        return m_objectsByType[objectType.value];
+    }
+
     QVector<GameObject *> objects;
-    objects.reserve(m_numObjects[objectType.value]);
-    if (objectType == GameObjectType::Unknown) {
-        for (GameObject *object : m_objectMap) {
-            objects.append(object);
-        }
-    } else {
-        for (GameObject *object : m_objectMap) {
-            if (object->objectType() == objectType) {
-                objects.append(object);
-            }
-        }
+    objects.reserve(numObjects(objectType));
+    for (const QVector<GameObject *> &objectsOfType : m_objectsByType) {
+        objects += objectsOfType;
     }
     return objects;
 }
 
+int Realm::numObjects(GameObjectType objectType) const {
+
+    if (objectType != GameObjectType::Unknown) {
+        return m_objectsByType[objectType.value].size();
+    }
+
+    int numObjects = 0;
+    for (const QVector<GameObject *> &objectsOfType : m_objectsByType) {
+        numObjects += objectsOfType.size();
+    }
+    return numObjects;
+}
+
 GameObjectPtrList Realm::players() const {
 
     GameObjectPtrList players;
@@ -223,23 +922,333 @@ void Realm::registerPlayer(Player *player) {
 
     Q_ASSERT(player);
     m_playerMap.insert(player->name(), player);
+    m_playerIds.insert(player->name(), player->id());
+
+    // if the player is evicted again before a pending load completes, what it read may be
+    // outdated
+    if (m_playerCallbacks.contains(player->name())) {
+        m_staleLoads.insert(player->name());
+    }
 }
 
 void Realm::unregisterPlayer(Player *player) {
 
     Q_ASSERT(player);
     m_playerMap.remove(player->name());
+
+    // evicted players remain known, so they can be loaded again
+    if (player->m_deleted) {
+        m_playerIds.remove(player->name());
+    }
 }
 
-GameObject *Realm::getPlayer(const QString &name) const {
+GameObject *Realm::getPlayer(const QString &name) {
 
-    if (m_playerMap.contains(name)) {
-        return m_playerMap[name];
+    Player *player = m_playerMap.value(name);
+    if (player) {
+        return player;
+    }
+
+    uint id = m_playerIds.value(name);
+    if (id) {
+        return loadPlayer(id);
     }
 
     return nullptr;
 }
 
+GameObject *Realm::getLoadedPlayer(const QString &name) const {
+
+    return m_playerMap.value(name);
+}
+
+void Realm::getPlayerAsync(const QString &name, const QScriptValue &callback) {
+
+    QList<QScriptValue> &callbacks = m_playerCallbacks[name];
+    callbacks.append(callback);
+    if (callbacks.size() > 1) {
+        return; // the player is being loaded already
+    }
+
+    uint id = m_playerIds.value(name);
+    if (m_playerMap.contains(name) || !id) {
+        QElapsedTimer timer;
+        timer.start();
+        enqueueEvent(new PlayerLoadedEvent(name, 0, timer));
+    } else {
+        m_syncThread.enqueueJob(new LoadPlayerJob(name, id));
+    }
+}
+
+bool Realm::readPlayer(StorageBackend *storageBackend, uint id, QVector<StoredObject> *objects,
+                       QString *errorString) {
+
+    try {
+        QStringList keys;
+        keys.append(StorageBackend::objectKey("player", id));
+        QSet<QString> readKeys;
+        for (int i = 0; i < keys.size(); i++) {
+            if (readKeys.contains(keys[i])) {
+                continue;
+            }
+            readKeys.insert(keys[i]);
+
+            // missing items are skipped, just like unresolvable pointers are
+            StoredObject object;
+            object.key = keys[i];
+            if (!storageBackend->readObject(keys[i], &object.jsonString)) {
+                if (i == 0) {
+                    throw GameException(GameException::CouldNotOpenGameObjectFile, keys[i]);
+                }
+                continue;
+            }
+
+            object.properties = parseJson(object.jsonString);
+            appendItemKeys(object.properties, &keys);
+            objects->append(object);
+        }
+    } catch (const GameException &exception) {
+        *errorString = exception.what();
+        objects->clear();
+        return false;
+    }
+
+    return true;
+}
+
+Player *Realm::createPlayer(uint id, const QVector<StoredObject> &storedObjects) {
+
+    QVector<GameObject *> objects;
+    try {
+        for (const StoredObject &storedObject : storedObjects) {
+            if (getObject(GameObjectType::Unknown, storedObject.key.section('.', 1).toUInt())) {
+                continue;
+            }
+
+            // a backup that is being written expects players that are not loaded to be unmodified
+            if (m_backupThread.isRunning()) {
+                m_backupThread.addLoadedObject(storedObject.key, storedObject.jsonString);
+            }
+
+            objects.append(createFromStorage(this, storedObject.key, storedObject.properties));
+        }
+    } catch (const GameException &exception) {
+        LogUtil::logError("Could not load player #%1: %2", QString::number(id),
+                          exception.what());
+        qDeleteAll(objects);
+        return nullptr;
+    }
+
+    for (GameObject *object : objects) {
+        m_unloadedObjectIds.remove(object->id());
+    }
+    for (GameObject *object : objects) {
+        object->resolvePointers();
+    }
+
+    // the properties were set through their setters, but there is nothing to be synced
+    for (GameObject *object : objects) {
+        object->m_modifiedProperties = 0;
+        m_modifiedObjects.remove(object);
+    }
+
+    resolveReferences(objects);
+
+    // items are initialized before the player that holds them
+    for (int i = objects.size() - 1; i >= 0; i--) {
+        objects[i]->init();
+    }
+
+    Player *player = (objects.isEmpty() ? nullptr : qobject_cast<Player *>(objects.first()));
+    if (!player) {
+        LogUtil::logError("Could not load player #%1", QString::number(id));
+    }
+    return player;
+}
+
+Player *Realm::loadPlayer(uint id) {
+
+    QElapsedTimer timer;
+    timer.start();
+
+    // the player may have been evicted while their last modifications were not written yet,
+    // and the sync thread should not be writing while we read
+    m_syncThread.waitForIdle();
+
+    QVector<StoredObject> objects;
+    QString errorString;
+    if (!readPlayer(m_storageBackend, id, &objects, &errorString)) {
+        LogUtil::logError("Could not load player #%1: %2", QString::number(id), errorString);
+        return nullptr;
+    }
+
+    Player *player = createPlayer(id, objects);
+    if (player) {
+        LogUtil::logInfo("Loaded player %1 in %2 ms", player->name(),
+                         QString::number(timer.elapsed()));
+    }
+    return player;
+}
+
+void Realm::playerLoaded(const QString &name, uint id, const QVector<StoredObject> &objects,
+                         const QString &errorString, qint64 loadTime) {
+
+    Player *player = m_playerMap.value(name);
+    if (!player && id) {
+        if (m_staleLoads.remove(name)) {
+            m_syncThread.enqueueJob(new LoadPlayerJob(name, id));
+            return;
+        }
+
+        if (errorString.isEmpty()) {
+            player = createPlayer(id, objects);
+        } else {
+            LogUtil::logError("Could not load player #%1: %2", QString::number(id),
+                              errorString);
+        }
+        if (player) {
+            LogUtil::logInfo("Loaded player %1 in %2 ms", player->name(),
+                             QString::number(loadTime));
+        }
+    }
+    m_staleLoads.remove(name);
+
+    ScriptEngine *engine = ScriptEngine::instance();
+    QScriptValueList args;
+    args.append(engine->toScriptValue(player));
+    for (QScriptValue callback : m_playerCallbacks.take(name)) {
+        callback.call(QScriptValue(), args);
+        if (engine->hasUncaughtException()) {
+            LogUtil::logException("Script Exception: %1\n"
+                                  "In Realm::getPlayerAsync()", engine->uncaughtException());
+        }
+    }
+}
+
+bool Realm::canEvictPlayer(Player *player, qint64 offlineSince) const {
+
+    if (player->session() || player->offlineSince() > offlineSince || player->m_deleted ||
+        !player->group().isNull()) {
+        return false;
+    }
+
+    // players who were stunned while signing out remain in their room until they recover
+    if (!player->currentRoom().isNull()) {
+        Room *room = player->currentRoom().cast<Room *>();
+        if (room->characters().contains(player)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void Realm::evictIdlePlayers() {
+
+    qint64 offlineSince = QDateTime::currentMSecsSinceEpoch() - m_playerEvictionDelay;
+
+    QList<Player *> players;
+    for (Player *player : m_playerMap) {
+        if (canEvictPlayer(player, offlineSince)) {
+            players.append(player);
+        }
+    }
+
+    if (!players.isEmpty()) {
+        evictPlayers(players);
+    }
+}
+
+void Realm::evictPlayer(Player *player) {
+
+    evictPlayers(QList<Player *>() << player);
+}
+
+void Realm::evictPlayers(const QList<Player *> &players) {
+
+    QVector<GameObject *> objects;
+    QSet<GameObject *> objectSet;
+    int numInternalPointers = 0;
+    for (Player *player : players) {
+        QVector<GameObject *> items;
+        appendItems(player->inventory(), &items, &numInternalPointers);
+        appendItems(GameObjectPtrList() << player->weapon() << player->secondaryWeapon()
+                                        << player->shield(), &items, &numInternalPointers);
+        for (int i = 0; i < items.size(); i++) {
+            if (items[i]->isContainer()) {
+                appendItems(qobject_cast<Container *>(items[i])->items(), &items,
+                            &numInternalPointers);
+            }
+        }
+
+        objects.append(player);
+        for (GameObject *item : items) {
+            if (!objectSet.contains(item)) {
+                objectSet.insert(item);
+                objects.append(item);
+            }
+        }
+    }
+
+    bool modified = false;
+    for (GameObject *object : objects) {
+        modified = modified || m_modifiedObjects.contains(object);
+    }
+    if (modified) {
+        enqueueModifiedObjects();
+    }
+
+    // pointers to the evicted objects are kept, so that none of the objects gets deleted from
+    // storage for losing its last pointer, and so that other objects don't lose track of them
+    int numPointers = 0;
+    for (GameObject *object : objects) {
+        numPointers += object->detachPointers();
+        m_unloadedObjectIds.insert(object->id());
+    }
+
+    // items are deleted from the inside out, before the players holding them
+    for (int i = objects.size() - 1; i >= 0; i--) {
+        delete objects[i];
+    }
+
+    // only if the evicted objects were pointed to by something other than each other, do we
+    // need to look for the objects that should have their pointers resolved again on loading
+    if (numPointers > numInternalPointers) {
+        for (GameObject *object : allObjects(GameObjectType::Unknown)) {
+            object->registerUnresolvedPointers();
+        }
+    }
+}
+
+void Realm::addUnresolvedReference(uint id, GameObject *object) {
+
+    m_unresolvedReferences[id].insert(object->id());
+}
+
+void Realm::resolveReferences(const QVector<GameObject *> &objects) {
+
+    QSet<uint> referringIds;
+    for (GameObject *object : objects) {
+        referringIds += m_unresolvedReferences.take(object->id());
+    }
+
+    for (uint id : referringIds) {
+        GameObject *object = getObject(GameObjectType::Unknown, id);
+        if (!object) {
+            continue;
+        }
+
+        // the pointers keep the same IDs, so there is nothing to be synced
+        bool modified = m_modifiedObjects.contains(object);
+        quint64 modifiedProperties = object->m_modifiedProperties;
+        object->resolvePointers();
+        object->m_modifiedProperties = modifiedProperties;
+        if (!modified) {
+            m_modifiedObjects.remove(object);
+        }
+    }
+}
+
 void Realm::addReservedName(const QString &name) {
 
     QString userName = Util::validateUserName(name);
@@ -253,7 +1262,7 @@ void Realm::setDateTime(const QDateTime &dateTime) {
     if (m_dateTime != dateTime) {
         m_dateTime = dateTime;
 
-        setModified();
+        setModified("dateTime");
     }
 }
 
@@ -271,11 +1280,11 @@ GameEvent *Realm::createEvent(const QString &eventType, const GameObjectPtr &ori
 
 uint Realm::uniqueObjectId() {
 
-    uint uniqueId = m_nextId;
-    do {
-        m_nextId++;
-    } while (m_objectMap.contains(m_nextId));
-    return uniqueId;
+    if (m_nextId > MaxObjectId) {
+        throw GameException(GameException::InvalidObjectId);
+    }
+
+    return m_nextId++;
 }
 
 void Realm::enqueueEvent(Event *event) {
@@ -289,15 +1298,45 @@ void Realm::addModifiedObject(GameObject *object) {
         return;
     }
 
+    if (m_modifiedObjects.isEmpty()) {
+        m_syncDeadline = QDateTime::currentMSecsSinceEpoch() + m_syncWindow;
+    }
+
     m_modifiedObjects.insert(object);
+    m_numModifications++;
+
+    if (isTakingBackupSnapshots()) {
+        m_backupModifiedIds.insert(object->id());
+    }
+}
+
+void Realm::syncModifiedObjects() {
+
+    if (m_modifiedObjects.isEmpty()) {
+        return;
+    }
+
+    if (m_syncWindow > 0 && QDateTime::currentMSecsSinceEpoch() < m_syncDeadline) {
+        return;
+    }
+
+    enqueueModifiedObjects();
 }
 
 void Realm::enqueueModifiedObjects() {
 
-    for (GameObject *object : m_modifiedObjects) {
-        m_syncThread.enqueueObject(object);
+    if (m_modifiedObjects.isEmpty()) {
+        return;
     }
+
+    m_syncThread.enqueueObjects(m_modifiedObjects.toList(), m_numModifications);
     m_modifiedObjects.clear();
+    m_numModifications = 0;
+}
+
+qint64 Realm::modifiedObjectsDeadline() const {
+
+    return m_modifiedObjects.isEmpty() ? -1 : m_syncDeadline;
 }
 
 void Realm::enqueueLogMessage(LogMessage *message) {
@@ -319,6 +1358,8 @@ void Realm::invokeTimer(int timerId) {
         if (m_dateTime.time().hour() == 0) {
             emit dayPassed(m_dateTime);
         }
+    } else if (timerId == m_evictionIntervalId) {
+        evictIdlePlayers();
     } else {
         super::invokeTimer(timerId);
     }
@@ -2,17 +2,24 @@
 #define REALM_H
 
 #include <QDateTime>
+#include <QElapsedTimer>
 #include <QHash>
+#include <QList>
+#include <QScriptValue>
 #include <QSet>
 #include <QStringList>
 #include <QVector>
 
+#include "backupthread.h"
 #include "gameevent.h"
 #include "gameobject.h"
 #include "gameobjectptr.h"
 #include "gameobjectsyncthread.h"
 #include "gamethread.h"
+#include "lineofsightcache.h"
 #include "logthread.h"
+#include "parallelpropagator.h"
+#include "roomgraph.h"
 
 
 class CommandInterpreter;
@@ -21,18 +28,63 @@ class Event;
 class LogMessage;
 class Player;
 class ScriptEngine;
+class StorageBackend;
 class TriggerRegistry;
 
 class Realm : public GameObject {
 
     Q_OBJECT
 
+    friend class BackupSnapshotEvent;
+    friend class LoadPlayerJob;
+    friend class PlayerLoadedEvent;
+
     public:
+        /**
+         * The highest ID an object can have. IDs are never handed out again, so a realm can
+         * create this many objects over its lifetime, after which creating an object throws.
+         */
+        static const uint MaxObjectId = 0xfffffffe;
+
         Realm(Options options = NoOptions);
         virtual ~Realm();
 
         static Realm *instance();
 
+        static QString binarySnapshotPath();
+        bool writeBinarySnapshot();
+
+        /**
+         * Starts writing a backup of the entire realm to the given path, in the binary snapshot
+         * format. Snapshots of the objects in memory are taken a chunk per event, so that no
+         * single event takes time proportional to the size of the realm. Objects that are
+         * modified, created, loaded, evicted or deleted in the meantime get their snapshots
+         * taken again, or dropped, by the event that takes the last chunk, so the backup
+         * captures the state of the realm at that event. The backup is then written in the
+         * background.
+         *
+         * @param recipient Optional player to send progress reports to.
+         * @return false if another backup is still in progress.
+         */
+        bool startBackup(const QString &path, Player *recipient = nullptr);
+        bool isBackupInProgress() const;
+        bool isTakingBackupSnapshots() const { return m_takingBackupSnapshots; }
+        const QString &backupPath() const;
+        int numBackupSnapshots() const { return m_backupProgress; }
+        int numBackupObjects() const { return m_backupObjectIds.size(); }
+        BackupThread &backupThread() { return m_backupThread; }
+        GameObjectSyncThread &syncThread() { return m_syncThread; }
+        static QString backupDir();
+
+        /**
+         * Returns the path of a backup with the given file name in the backup directory, or of
+         * a backup named after the current time if the file name is empty. Returns an empty
+         * string if the file name is not valid.
+         */
+        static QString backupFilePath(const QString &fileName);
+
+        static void appendItemKeys(const QVariantMap &properties, QStringList *keys);
+
         virtual void init();
         bool isInitialized() const { return m_initialized; }
 
@@ -42,12 +94,60 @@ class Realm : public GameObject {
         Q_INVOKABLE GameObject *getObject(const QString &objectType, uint id);
         Q_INVOKABLE GameObject *createObject(const QString &objectType);
         QVector<GameObject *> allObjects(GameObjectType objectType) const;
+        int numObjects(GameObjectType objectType) const;
 
+        /**
+         * Players are loaded on demand, so this only returns the players that are currently in
+         * memory. Use playerNames() for the names of all players.
+         */
         Q_INVOKABLE GameObjectPtrList players() const;
         Q_INVOKABLE GameObjectPtrList onlinePlayers() const;
+        Q_INVOKABLE QStringList playerNames() const { return m_playerIds.keys(); }
         void registerPlayer(Player *player);
         void unregisterPlayer(Player *player);
-        Q_INVOKABLE GameObject *getPlayer(const QString &name) const;
+
+        Q_INVOKABLE bool hasPlayer(const QString &name) const {
+            return m_playerIds.contains(name);
+        }
+
+        /**
+         * Returns the player with the given name, loading the player and their items from
+         * storage if they are not in memory yet.
+         *
+         * Loading blocks the game thread until the sync thread is idle and the player is read,
+         * so getPlayerAsync() should be preferred wherever a player may not be in memory.
+         */
+        Q_INVOKABLE GameObject *getPlayer(const QString &name);
+
+        /**
+         * Returns the player with the given name only if they are in memory, which is always
+         * the case for players that are online.
+         */
+        Q_INVOKABLE GameObject *getLoadedPlayer(const QString &name) const;
+
+        /**
+         * Calls the callback with the player with the given name, or with null if there is no
+         * such player. Players that are not in memory are read and parsed on the sync thread,
+         * so the game thread does not wait for storage.
+         *
+         * The callback is always called from a later event, even if the player is in memory.
+         */
+        Q_INVOKABLE void getPlayerAsync(const QString &name, const QScriptValue &callback);
+
+        /**
+         * Writes the player and their items to storage, and removes them from memory. They are
+         * loaded again when needed.
+         */
+        void evictPlayer(Player *player);
+
+        /**
+         * Players that are not loaded, and their items, may still be pointed to by other
+         * objects. Such pointers keep their ID, but remain unresolved until the objects are
+         * loaded, at which point the objects registered through addUnresolvedReference() have
+         * their pointers resolved.
+         */
+        bool isUnloaded(uint id) const { return m_unloadedObjectIds.contains(id); }
+        void addUnresolvedReference(uint id, GameObject *object);
 
         Q_INVOKABLE void addReservedName(const QString &name);
         Q_INVOKABLE QStringList reservedNames() const { return m_reservedNames; }
@@ -61,18 +161,37 @@ class Realm : public GameObject {
         Q_INVOKABLE GameObjectPtrList races() const { return m_races; }
         Q_INVOKABLE GameObjectPtrList classes() const { return m_classes; }
 
+        RoomGraph &roomGraph() { return m_roomGraph; }
+        LineOfSightCache &lineOfSightCache() { return m_lineOfSightCache; }
+        ParallelPropagator &parallelPropagator() { return m_parallelPropagator; }
+
         Q_INVOKABLE GameEvent *createEvent(const QString &eventType, const GameObjectPtr &origin,
                                            double strength);
 
+        /**
+         * Object IDs are never handed out again once their object is deleted, so an ID that
+         * outlived its object resolves to null rather than to an unrelated object. Throws an
+         * InvalidObjectId exception once all IDs up to MaxObjectId have been handed out.
+         */
         uint uniqueObjectId();
 
         void enqueueEvent(Event *event);
 
+        /**
+         * May only be called from the game thread.
+         */
+        const GameThreadMetrics &gameThreadMetrics() const { return m_gameThread.metrics(); }
+        int eventQueueDepth() const { return m_gameThread.queueDepth(); }
+
         void addModifiedObject(GameObject *object);
+        void syncModifiedObjects();
         void enqueueModifiedObjects();
+        qint64 modifiedObjectsDeadline() const;
 
         void enqueueLogMessage(LogMessage *message);
 
+        StorageBackend *storageBackend() const { return m_storageBackend; }
+
         inline int startTimer(GameObject *object, int timeout) {
             return m_gameThread.startTimer(object, timeout);
         }
@@ -89,6 +208,14 @@ class Realm : public GameObject {
             m_gameThread.stopInterval(id);
         }
 
+        inline int subscribeToTicks(GameObject *object, int interval) {
+            return m_gameThread.subscribeToTicks(object, interval);
+        }
+
+        inline void unsubscribeFromTicks(int tickGroupId, GameObject *object) {
+            m_gameThread.unsubscribeFromTicks(tickGroupId, object);
+        }
+
         virtual void invokeTimer(int timerId);
 
         ScriptEngine *scriptEngine() const { return m_scriptEngine; }
@@ -107,8 +234,19 @@ class Realm : public GameObject {
         bool m_initialized;
 
         uint m_nextId;
-        QHash<uint, GameObject *> m_objectMap;
+        QVector<GameObject *> m_objects;
+        QHash<uint, GameObject *> m_overflowObjects;
         QHash<QString, Player *> m_playerMap;
+        QHash<QString, uint> m_playerIds;
+        QHash<QString, QList<QScriptValue> > m_playerCallbacks;
+        QSet<QString> m_staleLoads;
+
+        QSet<uint> m_unloadedObjectIds;
+
+        // maps IDs of objects that are not loaded to the IDs of objects pointing to them
+        QHash<uint, QSet<uint> > m_unresolvedReferences;
+        int m_playerEvictionDelay;
+        int m_evictionIntervalId;
 
         QStringList m_reservedNames;
 
@@ -116,7 +254,11 @@ class Realm : public GameObject {
         GameObjectPtrList m_rooms;
         GameObjectPtrList m_races;
         GameObjectPtrList m_classes;
-        int m_numObjects[GameObjectType::NumValues];
+        QVector<GameObject *> m_objectsByType[GameObjectType::NumValues];
+
+        RoomGraph m_roomGraph;
+        LineOfSightCache m_lineOfSightCache;
+        ParallelPropagator m_parallelPropagator;
 
         QDateTime m_dateTime;
         int m_timeIntervalId;
@@ -125,6 +267,24 @@ class Realm : public GameObject {
 
         GameObjectSyncThread m_syncThread;
         QSet<GameObject *> m_modifiedObjects;
+        int m_numModifications;
+        int m_syncWindow;
+        qint64 m_syncDeadline;
+
+        BackupThread m_backupThread;
+
+        // state of a backup of which the snapshots are still being taken
+        bool m_takingBackupSnapshots;
+        QString m_backupPath;
+        uint m_backupRecipientId;
+        QVector<uint> m_backupObjectIds;
+        int m_backupProgress;
+        QHash<uint, GameObjectSnapshot> m_backupSnapshots;
+        QSet<uint> m_backupModifiedIds;
+        QElapsedTimer m_backupTimer;
+
+        StorageBackend *m_storageBackend;
+        bool m_binarySnapshotEnabled;
 
         LogThread m_logThread;
 
@@ -134,6 +294,26 @@ class Realm : public GameObject {
         CommandInterpreter *m_commandInterpreter;
 
         TriggerRegistry *m_triggerRegistry;
+
+        struct StoredObject {
+            QString key;
+            QString jsonString;
+            QVariantMap properties;
+        };
+
+        void takeBackupSnapshots();
+        void takeBackupSnapshot(uint id);
+
+        static bool readPlayer(StorageBackend *storageBackend, uint id,
+                               QVector<StoredObject> *objects, QString *errorString);
+        Player *createPlayer(uint id, const QVector<StoredObject> &objects);
+        Player *loadPlayer(uint id);
+        void playerLoaded(const QString &name, uint id, const QVector<StoredObject> &objects,
+                          const QString &errorString, qint64 loadTime);
+        void resolveReferences(const QVector<GameObject *> &objects);
+        bool canEvictPlayer(Player *player, qint64 offlineSince) const;
+        void evictIdlePlayers();
+        void evictPlayers(const QList<Player *> &players);
 };
 
 #endif // REALM_H
@@ -2,6 +2,7 @@
 
 #include "item.h"
 #include "portal.h"
+#include "realm.h"
 #include "util.h"
 
 
@@ -9,22 +10,27 @@
 
 Room::Room(Realm *realm, uint id, Options options) :
     super(realm, GameObjectType::Room, id, (Options) (options | NeverDelete)),
+    m_graphIndex(-1),
     m_type(RoomType::Room),
     m_position(0, 0, 0),
     m_flags(RoomFlags::NoFlags),
     m_portals(8) {
+
+    if (~options & Copy) {
+        realm->roomGraph().addRoom(this);
+    }
 }
 
 Room::~Room() {
+
+    if (m_graphIndex != -1) {
+        realm()->roomGraph().removeRoom(this);
+    }
 }
 
 void Room::setArea(const GameObjectPtr &area) {
 
-    if (m_area != area) {
-        m_area = area;
-
-        setModified();
-    }
+    m_area = area;
 }
 
 void Room::setType(RoomType type) {
@@ -32,7 +38,7 @@ void Room::setType(RoomType type) {
     if (m_type != type) {
         m_type = type;
 
-        setModified();
+        setModified("type");
     }
 }
 
@@ -41,7 +47,9 @@ void Room::setPosition(const Point3D &position) {
     if (m_position != position) {
         m_position = position;
 
-        setModified();
+        realm()->roomGraph().invalidateRoom(this);
+
+        setModified("position");
     }
 }
 
@@ -50,7 +58,9 @@ void Room::setFlags(RoomFlags flags) {
     if (m_flags != flags) {
         m_flags = flags;
 
-        setModified();
+        realm()->roomGraph().updateRoom(this);
+
+        setModified("flags");
     }
 }
 
@@ -59,14 +69,18 @@ void Room::addPortal(const GameObjectPtr &portal) {
     if (!m_portals.contains(portal)) {
         m_portals.append(portal);
 
-        setModified();
+        realm()->roomGraph().invalidateRoom(this);
+
+        setModified("portals");
     }
 }
 
 void Room::removePortal(const GameObjectPtr &portal) {
 
     if (m_portals.removeOne(portal)) {
-        setModified();
+        realm()->roomGraph().invalidateRoom(this);
+
+        setModified("portals");
     }
 }
 
@@ -75,7 +89,9 @@ void Room::setPortals(const GameObjectPtrList &portals) {
     if (m_portals != portals) {
         m_portals = portals;
 
-        setModified();
+        realm()->roomGraph().invalidateRoom(this);
+
+        setModified("portals");
     }
 }
 
@@ -103,14 +119,14 @@ void Room::addItem(const GameObjectPtr &item) {
     if (!m_items.contains(item)) {
         m_items.append(item);
 
-        setModified();
+        setModified("items");
     }
 }
 
 void Room::removeItem(const GameObjectPtr &item) {
 
     if (m_items.removeOne(item)) {
-        setModified();
+        setModified("items");
     }
 }
 
@@ -119,7 +135,7 @@ void Room::setItems(const GameObjectPtrList &items) {
     if (m_items != items) {
         m_items = items;
 
-        setModified();
+        setModified("items");
     }
 }
 
@@ -128,7 +144,9 @@ void Room::setEventMultipliers(const GameEventMultiplierMap &multipliers) {
     if (m_eventMultipliers != multipliers) {
         m_eventMultipliers = multipliers;
 
-        setModified();
+        realm()->roomGraph().updateRoom(this);
+
+        setModified("eventMultipliers");
     }
 }
 
@@ -136,3 +154,32 @@ double Room::eventMultiplier(GameEventType eventType) const {
 
     return m_eventMultipliers[eventType];
 }
+
+QVariantList Room::visibleRooms(double strength) const {
+
+    QVariantList rooms;
+    if (strength <= 0.0) {
+        return rooms;
+    }
+
+    // the cache only reads from the room
+    Room *room = const_cast<Room *>(this);
+    LineOfSightCache &cache = realm()->lineOfSightCache();
+    for (const SightLine &sightLine : cache.sightLines(room, 0.1 / strength)) {
+        if (sightLine.room == this) {
+            continue;
+        }
+
+        double roomStrength = strength * sightLine.attenuation *
+                              sightLine.room->eventMultiplier(GameEventType::Visual);
+        if (roomStrength < 0.1) {
+            continue;
+        }
+
+        QVariantMap map;
+        map["room"] = QVariant::fromValue(GameObjectPtr(sightLine.room));
+        map["strength"] = roomStrength;
+        rooms.append(map);
+    }
+    return rooms;
+}
@@ -1,6 +1,8 @@
 #ifndef ROOM_H
 #define ROOM_H
 
+#include <QVariantList>
+
 #include "gameeventmultipliermap.h"
 #include "gameobject.h"
 #include "gameobjectptr.h"
@@ -35,6 +37,8 @@ class Room : public GameObject {
 
     Q_OBJECT
 
+    friend class RoomGraph;
+
     public:
         Room(Realm *realm, uint id = 0, Options options = NoOptions);
         virtual ~Room();
@@ -80,7 +84,23 @@ class Room : public GameObject {
 
         Q_INVOKABLE double eventMultiplier(GameEventType eventType) const;
 
+        /**
+         * Returns the other rooms that can be seen from this room, given the strength of a
+         * visual event in this room, as objects with the room and the strength with which it is
+         * seen, including the room's own multiplier. Rooms seen with a strength below 0.1 are
+         * omitted. Sight lines are taken from the realm's line-of-sight cache.
+         */
+        Q_INVOKABLE QVariantList visibleRooms(double strength) const;
+
+        /**
+         * Dense index of the room in the realm's room graph, or -1 for rooms that are not part
+         * of it.
+         */
+        int graphIndex() const { return m_graphIndex; }
+
     private:
+        int m_graphIndex;
+
         GameObjectPtr m_area;
 
         RoomType m_type;
@@ -17,6 +17,6 @@ void Shield::setCategory(const QString &category) {
     if (m_category != category) {
         m_category = category;
 
-        setModified();
+        setModified("category");
     }
 }
@@ -22,7 +22,7 @@ void StatsItem::setStats(const CharacterStats &stats) {
     if (m_stats != stats) {
         m_stats = stats;
 
-        setModified();
+        setModified("stats");
 
         if (~options() & Copy) {
             changeStats(m_stats);
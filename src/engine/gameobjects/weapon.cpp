@@ -17,6 +17,6 @@ void Weapon::setCategory(const QString &category) {
     if (m_category != category) {
         m_category = category;
 
-        setModified();
+        setModified("category");
     }
 }
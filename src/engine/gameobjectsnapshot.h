@@ -0,0 +1,41 @@
+#ifndef GAMEOBJECTSNAPSHOT_H
+#define GAMEOBJECTSNAPSHOT_H
+
+#include <QVariant>
+#include <QVector>
+
+#include "gameobject.h"
+
+
+/**
+ * Point-in-time copy of the modified properties of a game object, as written to storage by the
+ * sync thread.
+ *
+ * Strings, variant maps and the like are implicitly shared with the object, so for those taking
+ * a snapshot only increments a reference count, and the object detaches from the snapshot when
+ * it modifies the value afterwards. Pointer lists are not shared: for those the types and IDs
+ * are copied, which takes time proportional to the length of the list, but doesn't touch the
+ * objects pointed to. Pointers are kept unresolved, so a snapshot never references live objects
+ * and can safely be serialized and destroyed on another thread.
+ */
+class GameObjectSnapshot {
+
+    public:
+        GameObjectType objectType;
+        uint id;
+        bool deleted;
+
+        quint64 modifiedProperties;
+
+        // indexed by stored property index, only the modified properties are set
+        QVector<QVariant> values;
+
+        GameObjectSnapshot() :
+            objectType(GameObjectType::Unknown),
+            id(0),
+            deleted(false),
+            modifiedProperties(0) {
+        }
+};
+
+#endif // GAMEOBJECTSNAPSHOT_H
@@ -1,29 +1,82 @@
 #include "gameobjectsyncthread.h"
 
+#include <utility>
+
 #include "gameexception.h"
 #include "gameobject.h"
 #include "logutil.h"
+#include "realm.h"
+#include "storagebackend.h"
 
 
 GameObjectSyncThread::GameObjectSyncThread() :
     QThread(),
-    m_quit(false) {
+    m_quit(false),
+    m_syncing(false),
+    m_numModifications(0),
+    m_numWrites(0) {
 }
 
 GameObjectSyncThread::~GameObjectSyncThread() {
+
+    qDeleteAll(m_jobQueue);
 }
 
-void GameObjectSyncThread::enqueueObject(GameObject *object) {
+void GameObjectSyncThread::enqueueObjects(const QList<GameObject *> &objects,
+                                          int numModifications) {
 
-    GameObject *copy = GameObject::createCopy(object);
+    // snapshots only contain the modified properties, so when a snapshot is still pending we
+    // should make sure the properties it would have written are included in its replacement
+    m_mutex.lock();
+    for (GameObject *object : objects) {
+        auto it = m_pendingObjects.constFind(object->id());
+        if (it != m_pendingObjects.constEnd()) {
+            object->m_modifiedProperties |= it->modifiedProperties;
+        }
+    }
+    m_mutex.unlock();
+
+    // taking a snapshot only references the property values, the serialization itself is done
+    // on the sync thread
+    QVector<GameObjectSnapshot> snapshots;
+    snapshots.reserve(objects.size());
+    for (GameObject *object : objects) {
+        snapshots.append(object->snapshot());
+        object->m_modifiedProperties = 0;
+    }
 
     m_mutex.lock();
-    m_objectQueue.enqueue(copy);
+    for (const GameObjectSnapshot &snapshot : snapshots) {
+        GameObjectSnapshot &pendingSnapshot = m_pendingObjects[snapshot.id];
+        if (pendingSnapshot.id == 0) {
+            m_objectQueue.enqueue(snapshot.id);
+        }
+        pendingSnapshot = snapshot;
+    }
+    m_numModifications += numModifications;
     m_mutex.unlock();
 
     m_waitCondition.wakeAll();
 }
 
+void GameObjectSyncThread::enqueueJob(SyncJob *job) {
+
+    m_mutex.lock();
+    m_jobQueue.enqueue(job);
+    m_mutex.unlock();
+
+    m_waitCondition.wakeAll();
+}
+
+void GameObjectSyncThread::waitForIdle() {
+
+    m_mutex.lock();
+    while (!m_objectQueue.isEmpty() || !m_jobQueue.isEmpty() || m_syncing) {
+        m_idleCondition.wait(&m_mutex);
+    }
+    m_mutex.unlock();
+}
+
 void GameObjectSyncThread::terminate() {
 
     m_quit = true;
@@ -34,48 +87,82 @@ void GameObjectSyncThread::run() {
 
     while (!m_quit) {
         m_mutex.lock();
-
-        if (m_objectQueue.isEmpty()) {
+        if (m_objectQueue.isEmpty() && m_jobQueue.isEmpty()) {
             m_waitCondition.wait(&m_mutex);
         }
+        m_mutex.unlock();
+
+        syncObjects();
+    }
+
+    syncObjects();
+
+    LogUtil::logInfo(QString("All objects synced (%1 writes for %2 modifications). Quit.")
+                     .arg(m_numWrites.load()).arg(m_numModifications.load()));
+}
+
+void GameObjectSyncThread::syncObjects() {
 
-        while (!m_quit && !m_objectQueue.isEmpty()) {
-            GameObject *object = m_objectQueue.dequeue();
-            m_mutex.unlock();
+    m_mutex.lock();
+    QQueue<uint> objectQueue;
+    QHash<uint, GameObjectSnapshot> pendingObjects;
+    QQueue<SyncJob *> jobQueue;
+    std::swap(objectQueue, m_objectQueue);
+    std::swap(pendingObjects, m_pendingObjects);
+    std::swap(jobQueue, m_jobQueue);
+    m_syncing = !objectQueue.isEmpty() || !jobQueue.isEmpty();
+    m_mutex.unlock();
 
-            syncObject(object);
+    if (objectQueue.isEmpty() && jobQueue.isEmpty()) {
+        return;
+    }
 
-            m_mutex.lock();
+    StorageBackend *storageBackend = Realm::instance()->storageBackend();
+    if (!objectQueue.isEmpty()) {
+        for (uint id : objectQueue) {
+            syncObject(pendingObjects[id]);
         }
 
-        m_mutex.unlock();
+        storageBackend->flush();
     }
 
-    while (!m_objectQueue.isEmpty()) {
-        GameObject *object = m_objectQueue.dequeue();
-        syncObject(object);
+    // jobs run after the objects that were enqueued before them are written, so they never
+    // read outdated objects
+    for (SyncJob *job : jobQueue) {
+        try {
+            job->run(storageBackend);
+        } catch (const GameException &exception) {
+            LogUtil::logError("Game Exception in sync job: %1", exception.what());
+        } catch (...) {
+            LogUtil::logError("Unknown exception in sync job");
+        }
+        delete job;
     }
 
-    LogUtil::logInfo("All objects synced. Quit.");
+    m_mutex.lock();
+    m_syncing = false;
+    m_mutex.unlock();
+
+    m_idleCondition.wakeAll();
 }
 
-void GameObjectSyncThread::syncObject(GameObject *object) {
+void GameObjectSyncThread::syncObject(const GameObjectSnapshot &snapshot) {
+
+    m_numWrites++;
 
     try {
-        bool result = object->save();
+        bool result = GameObject::save(snapshot, m_jsonWriter);
 
         if (!result) {
             LogUtil::logError("Error while syncing object: %1:%2",
-                              object->objectType().toString(), QString::number(object->id()));
+                              snapshot.objectType.toString(), QString::number(snapshot.id));
         }
     } catch (const GameException &exception) {
         LogUtil::logError("Game Exception: %1\n"
                           "While syncing object: %2:%3", exception.what(),
-                          object->objectType().toString(), QString::number(object->id()));
+                          snapshot.objectType.toString(), QString::number(snapshot.id));
     } catch (...) {
         LogUtil::logError("Unknown exception while syncing object: %1:%2",
-                          object->objectType().toString(), QString::number(object->id()));
+                          snapshot.objectType.toString(), QString::number(snapshot.id));
     }
-
-    delete object;
 }
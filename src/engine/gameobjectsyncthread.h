@@ -1,13 +1,37 @@
 #ifndef GAMEOBJECTSYNCTHREAD_H
 #define GAMEOBJECTSYNCTHREAD_H
 
+#include <atomic>
+
+#include <QHash>
+#include <QList>
 #include <QMutex>
 #include <QQueue>
 #include <QThread>
 #include <QWaitCondition>
 
+#include "gameobjectsnapshot.h"
+#include "jsonwriter.h"
+
 
 class GameObject;
+class StorageBackend;
+
+/**
+ * Work that reads from the storage backend, and therefore should be done on the sync thread.
+ *
+ * Jobs run after all objects that were enqueued before them have been written, and are deleted
+ * after they have run.
+ */
+class SyncJob {
+
+    public:
+        SyncJob() {}
+        virtual ~SyncJob() {}
+
+        virtual void run(StorageBackend *storageBackend) = 0;
+};
+
 
 class GameObjectSyncThread : public QThread {
 
@@ -17,21 +41,52 @@ class GameObjectSyncThread : public QThread {
         GameObjectSyncThread();
         virtual ~GameObjectSyncThread();
 
-        void enqueueObject(GameObject *object);
+        void enqueueObjects(const QList<GameObject *> &objects, int numModifications);
+
+        /**
+         * Takes ownership of the job.
+         */
+        void enqueueJob(SyncJob *job);
+
+        /**
+         * Blocks until all enqueued objects have been written to the storage backend, and all
+         * enqueued jobs have run. Used before reading objects back from storage on another
+         * thread after the realm has been initialized.
+         */
+        void waitForIdle();
 
         void terminate();
 
+        /**
+         * Modifications are coalesced per object, first on the game thread and then for
+         * objects whose previous snapshot was not written yet, so the ratio between these two
+         * shows how much writing is saved.
+         */
+        quint64 numModifications() const { return m_numModifications; }
+        quint64 numWrites() const { return m_numWrites; }
+
     protected:
         virtual void run();
 
     private:
         QWaitCondition m_waitCondition;
+        QWaitCondition m_idleCondition;
         QMutex m_mutex;
         volatile bool m_quit;
+        bool m_syncing;
+
+        QQueue<uint> m_objectQueue;
+        QHash<uint, GameObjectSnapshot> m_pendingObjects;
+
+        QQueue<SyncJob *> m_jobQueue;
+
+        std::atomic<quint64> m_numModifications;
+        std::atomic<quint64> m_numWrites;
 
-        QQueue<GameObject *> m_objectQueue;
+        JsonWriter m_jsonWriter;
 
-        void syncObject(GameObject *object);
+        void syncObjects();
+        void syncObject(const GameObjectSnapshot &snapshot);
 };
 
 #endif // GAMEOBJECTSYNCTHREAD_H
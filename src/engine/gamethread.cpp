@@ -1,124 +1,225 @@
 #include "gamethread.h"
 
 #include <QDateTime>
+#include <QThread>
 
 #include "event.h"
 #include "gameexception.h"
 #include "logutil.h"
 #include "realm.h"
+#include "tickevent.h"
+#include "tickgroup.h"
 #include "timerevent.h"
 
 
 GameThread::GameThread(Realm *realm) :
     QThread(),
     m_quit(false),
+    m_idle(false),
     m_realm(realm),
-    m_nextTimerId(0) {
+    m_eventQueue(EventQueueCapacity),
+    m_timers(QDateTime::currentMSecsSinceEpoch()),
+    m_nextTimerId(0),
+    m_sampleStartTime(0),
+    m_nextSampleTime(0) {
+
+    m_clock.start();
 }
 
 GameThread::~GameThread() {
+
+    qDeleteAll(m_tickGroups);
 }
 
 void GameThread::enqueueEvent(Event *event) {
 
-    m_mutex.lock();
-    m_eventQueue.enqueue(event);
-    m_mutex.unlock();
+    event->setEnqueueTime(m_clock.nsecsElapsed());
+
+    if (QThread::currentThread() == this) {
+        // events that are already in the ring were enqueued before this one, so they are moved
+        // to the local queue first to keep all events in the order in which they were enqueued
+        Event *queuedEvent;
+        while (m_eventQueue.dequeue(queuedEvent)) {
+            m_localEventQueue.enqueue(queuedEvent);
+        }
 
-    m_waitCondition.wakeAll();
+        m_localEventQueue.enqueue(event);
+        return;
+    }
+
+    while (!m_eventQueue.enqueue(event)) {
+        wakeUp();
+        QThread::yieldCurrentThread();
+    }
+
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_idle.load(std::memory_order_relaxed)) {
+        wakeUp();
+    }
 }
 
 void GameThread::terminate() {
 
     m_quit = true;
-    m_waitCondition.wakeAll();
+    wakeUp();
 }
 
 int GameThread::startTimer(GameObject *object, int timeout) {
 
-    m_nextTimerId++;
-    if (m_nextTimerId < 0) {
-        m_nextTimerId = 1;
-    }
-
-    Timer timer;
-    timer.id = m_nextTimerId;
+    TimerWheel::Timer timer;
+    timer.id = nextTimerId();
     timer.object = object;
     timer.timestamp = QDateTime::currentMSecsSinceEpoch() + timeout;
     timer.interval = 0;
 
-    enqueueTimer(timer);
+    m_timers.insert(timer);
 
     return timer.id;
 }
 
 int GameThread::startInterval(GameObject *object, int interval) {
 
-    m_nextTimerId++;
-    if (m_nextTimerId < 0) {
-        m_nextTimerId = 1;
-    }
-
-    Timer timer;
-    timer.id = m_nextTimerId;
+    TimerWheel::Timer timer;
+    timer.id = nextTimerId();
     timer.object = object;
     timer.timestamp = QDateTime::currentMSecsSinceEpoch() + interval;
     timer.interval = interval;
 
-    enqueueTimer(timer);
+    m_timers.insert(timer);
 
     return timer.id;
 }
 
 void GameThread::stopTimer(int id) {
 
-    dequeueTimer(id);
+    m_timers.remove(id);
 }
 
 void GameThread::stopInterval(int id) {
 
-    dequeueTimer(id);
+    m_timers.remove(id);
 }
 
-void GameThread::run() {
+int GameThread::subscribeToTicks(GameObject *object, int interval) {
 
-    while (!m_quit) {
-        m_mutex.lock();
+    TickGroup *group = m_tickGroups.value(interval);
+    if (!group) {
+        group = new TickGroup(nextTimerId(), interval);
+        m_tickGroups.insert(interval, group);
+    }
 
-        unsigned long msecs = msecsTillNextTimer();
-        bool timeout = (msecs ? !m_waitCondition.wait(&m_mutex, msecs) : true);
-
-        while (!m_quit && (!m_eventQueue.isEmpty() || timeout)) {
-            Event *event;
-            if (timeout) {
-                event = takeFirstTimer();
-                timeout = false;
-            } else {
-                event = m_eventQueue.dequeue();
+    group->subscribe(object);
+
+    if (!group->timerId()) {
+        group->setTimerId(startInterval(nullptr, group->tickInterval()));
+    }
+
+    return group->id();
+}
+
+void GameThread::unsubscribeFromTicks(int tickGroupId, GameObject *object) {
+
+    for (TickGroup *group : m_tickGroups) {
+        if (group->id() == tickGroupId) {
+            group->unsubscribe(object);
+
+            if (group->isEmpty() && group->timerId()) {
+                stopInterval(group->timerId());
+                group->setTimerId(0);
             }
+            return;
+        }
+    }
+}
 
-            m_mutex.unlock();
+void GameThread::run() {
 
-            processEvent(event);
+    m_sampleStartTime = m_clock.nsecsElapsed() / 1000;
+    m_nextSampleTime = QDateTime::currentMSecsSinceEpoch() + GameThreadMetrics::SampleInterval;
 
-            m_mutex.lock();
+    while (!m_quit) {
+        if (m_localEventQueue.isEmpty() && m_eventQueue.isEmpty() &&
+            !m_timers.hasExpiredTimers()) {
+            waitForEvents();
         }
 
-        m_mutex.unlock();
+        qint64 now = QDateTime::currentMSecsSinceEpoch();
+        if (now >= m_nextSampleTime) {
+            takeMetricsSample(now);
+        }
+
+        m_timers.advance(now);
+
+        while (!m_quit && m_timers.hasExpiredTimers()) {
+            processEvent(takeFirstTimer());
+        }
+
+        m_realm->syncModifiedObjects();
+
+        for (int i = 0; i < EventBatchSize && !m_quit; i++) {
+            Event *event = takeNextEvent();
+            if (!event) {
+                break;
+            }
+
+            processEvent(event);
+        }
     }
 
-    while (!m_eventQueue.isEmpty()) {
-        Event *event = m_eventQueue.dequeue();
+    while (Event *event = takeNextEvent()) {
         processEvent(event);
     }
 }
 
+void GameThread::waitForEvents() {
+
+    m_mutex.lock();
+
+    m_idle.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    qint64 idleStart = m_clock.nsecsElapsed();
+
+    if (!m_quit && m_eventQueue.isEmpty()) {
+        unsigned long msecs = msecsTillNextTimer();
+        if (msecs) {
+            m_waitCondition.wait(&m_mutex, msecs);
+        }
+    }
+
+    m_metrics.recordIdleTime((m_clock.nsecsElapsed() - idleStart) / 1000);
+
+    m_idle.store(false, std::memory_order_relaxed);
+
+    m_mutex.unlock();
+}
+
+Event *GameThread::takeNextEvent() {
+
+    // the local queue only holds events that were enqueued before anything still in the ring
+    if (!m_localEventQueue.isEmpty()) {
+        return m_localEventQueue.dequeue();
+    }
+
+    Event *event;
+    return (m_eventQueue.dequeue(event) ? event : nullptr);
+}
+
+void GameThread::wakeUp() {
+
+    m_mutex.lock();
+    m_waitCondition.wakeOne();
+    m_mutex.unlock();
+}
+
 void GameThread::processEvent(Event *event) {
 
+    m_metrics.recordEvent((m_clock.nsecsElapsed() - event->enqueueTime()) / 1000, queueDepth());
+
     try {
         event->process();
 
-        m_realm->enqueueModifiedObjects();
+        m_realm->syncModifiedObjects();
     } catch (const GameException &exception) {
         LogUtil::logError("Game Exception: %1\n"
                           "While processing event: %2", exception.what(), event->toString());
@@ -131,49 +232,66 @@ void GameThread::processEvent(Event *event) {
 
 unsigned long GameThread::msecsTillNextTimer() const {
 
-    if (m_timers.isEmpty()) {
-        return ULONG_MAX;
+    qint64 timeout = m_timers.nextTimeout();
+    qint64 syncDeadline = m_realm->modifiedObjectsDeadline();
+    if (syncDeadline != -1 && (timeout == -1 || syncDeadline < timeout)) {
+        timeout = syncDeadline;
+    }
+    // samples are also taken while there is nothing to do
+    if (timeout == -1 || m_nextSampleTime < timeout) {
+        timeout = m_nextSampleTime;
     }
 
     qint64 now = QDateTime::currentMSecsSinceEpoch();
-    return qMax(m_timers[0].timestamp, now) - now;
+    return qMax(timeout, now) - now;
 }
 
 Event *GameThread::takeFirstTimer() {
 
-    Q_ASSERT(!m_timers.isEmpty());
+    TimerWheel::Timer timer = m_timers.takeExpiredTimer();
 
-    Timer timer = m_timers.takeFirst();
+    m_metrics.recordTimerLateness(QDateTime::currentMSecsSinceEpoch() - timer.timestamp);
 
     if (timer.interval) {
         timer.timestamp += timer.interval;
-        enqueueTimer(timer);
+        m_timers.insert(timer);
     }
 
-    return new TimerEvent(timer.object, timer.id);
-}
-
-void GameThread::enqueueTimer(const GameThread::Timer &timer) {
-
-    if (m_timers.isEmpty()) {
-        m_timers.append(timer);
-    } else {
-        auto iterator = qUpperBound(m_timers.begin(), m_timers.end(), timer);
-        m_timers.insert(iterator, timer);
+    Event *event = nullptr;
+    if (!timer.object) {
+        for (TickGroup *group : m_tickGroups) {
+            if (group->timerId() == timer.id) {
+                event = new TickEvent(group);
+                break;
+            }
+        }
+    }
+    if (!event) {
+        event = new TimerEvent(timer.object, timer.id);
     }
+
+    // timer events don't wait in the queue, their delay is recorded as lateness instead
+    event->setEnqueueTime(m_clock.nsecsElapsed());
+    return event;
 }
 
-void GameThread::dequeueTimer(int id) {
+void GameThread::takeMetricsSample(qint64 now) {
 
-    for (int i = 0; i < m_timers.length(); i++) {
-        if (m_timers[i].id == id) {
-            m_timers.removeAt(i);
-            return;
-        }
+    qint64 sampleEndTime = m_clock.nsecsElapsed() / 1000;
+    m_metrics.takeSample(now, sampleEndTime - m_sampleStartTime);
+    m_sampleStartTime = sampleEndTime;
+    m_nextSampleTime = now + GameThreadMetrics::SampleInterval;
+
+    if (m_metrics.numSamplesTaken() % SamplesPerStatsEntry == 0) {
+        LogUtil::logGameThreadStats(m_metrics.summary(SamplesPerStatsEntry));
     }
 }
 
-bool GameThread::Timer::operator<(const GameThread::Timer &timer) const {
+int GameThread::nextTimerId() {
 
-    return timestamp < timer.timestamp;
+    m_nextTimerId++;
+    if (m_nextTimerId < 0) {
+        m_nextTimerId = 1;
+    }
+    return m_nextTimerId;
 }
@@ -1,15 +1,24 @@
 #ifndef GAMETHREAD_H
 #define GAMETHREAD_H
 
+#include <atomic>
+
+#include <QElapsedTimer>
+#include <QHash>
 #include <QMutex>
 #include <QQueue>
 #include <QThread>
 #include <QWaitCondition>
 
+#include "gamethreadmetrics.h"
+#include "mpscqueue.h"
+#include "timerwheel.h"
+
 
 class Event;
 class GameObject;
 class Realm;
+class TickGroup;
 
 class GameThread : public QThread {
 
@@ -27,36 +36,59 @@ class GameThread : public QThread {
         void stopTimer(int id);
         void stopInterval(int id);
 
+        int subscribeToTicks(GameObject *object, int interval);
+        void unsubscribeFromTicks(int tickGroupId, GameObject *object);
+
+        /**
+         * May only be called from the game thread.
+         */
+        const GameThreadMetrics &metrics() const { return m_metrics; }
+        int queueDepth() const { return m_eventQueue.size() + m_localEventQueue.size(); }
+
     protected:
         virtual void run();
 
     private:
+        static const int EventQueueCapacity = 65536;
+        static const int EventBatchSize = 256;
+        static const int SamplesPerStatsEntry = 60;
+
         QWaitCondition m_waitCondition;
         QMutex m_mutex;
         volatile bool m_quit;
+        std::atomic<bool> m_idle;
 
         Realm *m_realm;
 
-        QQueue<Event *> m_eventQueue;
-
-        struct Timer {
-            int id;
-            qint64 timestamp;
-            GameObject *object;
-            int interval;
+        MpscQueue<Event *> m_eventQueue;
 
-            bool operator<(const Timer &timer) const;
-        };
+        // events the game thread posts to itself, preceded by any events that were taken from
+        // the ring when they were posted, so that events are processed in enqueue order
+        QQueue<Event *> m_localEventQueue;
 
-        QList<Timer> m_timers;
+        TimerWheel m_timers;
         int m_nextTimerId;
 
+        QHash<int, TickGroup *> m_tickGroups;
+
+        QElapsedTimer m_clock;
+        GameThreadMetrics m_metrics;
+        qint64 m_sampleStartTime;
+        qint64 m_nextSampleTime;
+
+        int nextTimerId();
+
+        void waitForEvents();
+        void wakeUp();
+
+        Event *takeNextEvent();
+
         void processEvent(Event *event);
 
         unsigned long msecsTillNextTimer() const;
         Event *takeFirstTimer();
-        void enqueueTimer(const Timer &timer);
-        void dequeueTimer(int id);
+
+        void takeMetricsSample(qint64 now);
 };
 
 #endif // GAMETHREAD_H
@@ -0,0 +1,110 @@
+#include "gamethreadmetrics.h"
+
+
+GameThreadSample::GameThreadSample() :
+    timestamp(0),
+    duration(0),
+    numEvents(0),
+    maxQueueDepth(0),
+    averageQueueTime(0),
+    maxQueueTime(0),
+    busyTime(0),
+    maxTimerLateness(0) {
+}
+
+int GameThreadSample::eventsPerSecond() const {
+
+    return duration > 0 ? (int) (Q_INT64_C(1000000) * numEvents / duration) : 0;
+}
+
+int GameThreadSample::utilization() const {
+
+    return duration > 0 ? (int) (100 * busyTime / duration) : 0;
+}
+
+
+GameThreadMetrics::GameThreadMetrics() :
+    m_samples(NumSamples),
+    m_numSamplesTaken(0),
+    m_numEvents(0),
+    m_maxQueueDepth(0),
+    m_totalQueueTime(0),
+    m_maxQueueTime(0),
+    m_idleTime(0),
+    m_maxTimerLateness(0) {
+}
+
+void GameThreadMetrics::recordEvent(qint64 queueTime, int queueDepth) {
+
+    m_numEvents++;
+    m_maxQueueDepth = qMax(m_maxQueueDepth, queueDepth);
+    m_totalQueueTime += queueTime;
+    m_maxQueueTime = qMax(m_maxQueueTime, queueTime);
+}
+
+void GameThreadMetrics::recordTimerLateness(qint64 lateness) {
+
+    m_maxTimerLateness = qMax(m_maxTimerLateness, lateness);
+}
+
+void GameThreadMetrics::recordIdleTime(qint64 idleTime) {
+
+    m_idleTime += idleTime;
+}
+
+void GameThreadMetrics::takeSample(qint64 timestamp, qint64 duration) {
+
+    GameThreadSample &sample = m_samples[m_numSamplesTaken % NumSamples];
+    sample.timestamp = timestamp;
+    sample.duration = duration;
+    sample.numEvents = m_numEvents;
+    sample.maxQueueDepth = m_maxQueueDepth;
+    sample.averageQueueTime = (m_numEvents > 0 ? m_totalQueueTime / m_numEvents : 0);
+    sample.maxQueueTime = m_maxQueueTime;
+    sample.busyTime = qBound(Q_INT64_C(0), duration - m_idleTime, duration);
+    sample.maxTimerLateness = m_maxTimerLateness;
+    m_numSamplesTaken++;
+
+    m_numEvents = 0;
+    m_maxQueueDepth = 0;
+    m_totalQueueTime = 0;
+    m_maxQueueTime = 0;
+    m_idleTime = 0;
+    m_maxTimerLateness = 0;
+}
+
+QVector<GameThreadSample> GameThreadMetrics::samples() const {
+
+    int numSamples = (int) qMin(m_numSamplesTaken, (quint64) NumSamples);
+
+    QVector<GameThreadSample> samples;
+    samples.reserve(numSamples);
+    for (quint64 i = m_numSamplesTaken - numSamples; i < m_numSamplesTaken; i++) {
+        samples.append(m_samples[i % NumSamples]);
+    }
+    return samples;
+}
+
+GameThreadSample GameThreadMetrics::summary(int numSamples) const {
+
+    numSamples = (int) qMin((quint64) qBound(0, numSamples, (int) NumSamples),
+                            m_numSamplesTaken);
+
+    GameThreadSample summary;
+    qint64 totalQueueTime = 0;
+    for (quint64 i = m_numSamplesTaken - numSamples; i < m_numSamplesTaken; i++) {
+        const GameThreadSample &sample = m_samples[i % NumSamples];
+        summary.timestamp = sample.timestamp;
+        summary.duration += sample.duration;
+        summary.numEvents += sample.numEvents;
+        summary.maxQueueDepth = qMax(summary.maxQueueDepth, sample.maxQueueDepth);
+        totalQueueTime += sample.averageQueueTime * sample.numEvents;
+        summary.maxQueueTime = qMax(summary.maxQueueTime, sample.maxQueueTime);
+        summary.busyTime += sample.busyTime;
+        summary.maxTimerLateness = qMax(summary.maxTimerLateness, sample.maxTimerLateness);
+    }
+    if (summary.numEvents > 0) {
+        summary.averageQueueTime = totalQueueTime / summary.numEvents;
+    }
+    return summary;
+}
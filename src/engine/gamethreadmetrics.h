@@ -0,0 +1,75 @@
+#ifndef GAMETHREADMETRICS_H
+#define GAMETHREADMETRICS_H
+
+#include <QVector>
+
+
+/**
+ * Load of the game thread during one sample interval.
+ */
+struct GameThreadSample {
+
+    qint64 timestamp; // end of the interval, in milliseconds since the epoch
+    qint64 duration; // in microseconds
+
+    int numEvents;
+    int maxQueueDepth;
+
+    qint64 averageQueueTime; // in microseconds
+    qint64 maxQueueTime; // in microseconds
+
+    qint64 busyTime; // in microseconds
+    qint64 maxTimerLateness; // in milliseconds
+
+    GameThreadSample();
+
+    int eventsPerSecond() const;
+    int utilization() const; // percentage of the interval the thread was busy
+};
+
+
+/**
+ * Collects the load of the game thread into a ring buffer of samples.
+ *
+ * The game thread records every event it processes, and takes a sample once every
+ * SampleInterval milliseconds. All methods may only be called from the game thread.
+ */
+class GameThreadMetrics {
+
+    public:
+        static const int SampleInterval = 1000;
+        static const int NumSamples = 300;
+
+        GameThreadMetrics();
+
+        void recordEvent(qint64 queueTime, int queueDepth);
+        void recordTimerLateness(qint64 lateness);
+        void recordIdleTime(qint64 idleTime);
+
+        void takeSample(qint64 timestamp, qint64 duration);
+
+        quint64 numSamplesTaken() const { return m_numSamplesTaken; }
+
+        /**
+         * Returns the samples in the ring buffer, from the oldest to the most recent one.
+         */
+        QVector<GameThreadSample> samples() const;
+
+        /**
+         * Returns a single sample that summarizes the given number of most recent samples.
+         */
+        GameThreadSample summary(int numSamples) const;
+
+    private:
+        QVector<GameThreadSample> m_samples;
+        quint64 m_numSamplesTaken;
+
+        int m_numEvents;
+        int m_maxQueueDepth;
+        qint64 m_totalQueueTime;
+        qint64 m_maxQueueTime;
+        qint64 m_idleTime;
+        qint64 m_maxTimerLateness;
+};
+
+#endif // GAMETHREADMETRICS_H
@@ -0,0 +1,327 @@
+#include "journalstoragebackend.h"
+
+#include <unistd.h>
+#include <zlib.h>
+
+#include <QDataStream>
+#include <QDir>
+#include <QFileInfo>
+
+#ifdef Q_OS_WIN
+#include <io.h>
+#endif
+
+#include "diskutil.h"
+#include "filestoragebackend.h"
+#include "fileutil.h"
+#include "logutil.h"
+
+
+static const qint64 MinimumCompactionSize = 4 * 1024 * 1024;
+
+static const int RecordHeaderSize = 8;
+
+
+JournalStorageBackend::JournalStorageBackend(const QString &directory) :
+    StorageBackend(),
+    m_directory(directory),
+    m_journal(directory + "/journal"),
+    m_snapshotSize(0) {
+
+    recover();
+}
+
+JournalStorageBackend::~JournalStorageBackend() {
+
+    flush();
+}
+
+QDateTime JournalStorageBackend::lastModified() {
+
+    return m_lastModified;
+}
+
+QStringList JournalStorageBackend::objectKeys() {
+
+    QStringList keys = m_objects.keys();
+    keys.sort();
+    return keys;
+}
+
+bool JournalStorageBackend::readObject(const QString &key, QString *jsonString) {
+
+    // called concurrently during startup, so we should not detach
+    auto it = m_objects.constFind(key);
+    if (it == m_objects.constEnd()) {
+        return false;
+    }
+
+    *jsonString = it.value();
+    return true;
+}
+
+bool JournalStorageBackend::writeObject(const QString &key, const QString &jsonString) {
+
+    QByteArray payload;
+    QDataStream stream(&payload, QIODevice::WriteOnly);
+    stream << (quint8) WriteOperation << key << jsonString;
+
+    m_objects[key] = jsonString;
+    return appendRecord(payload);
+}
+
+bool JournalStorageBackend::patchObject(const QString &key,
+                                        const QMap<QString, QString> &properties) {
+
+    if (!m_objects.contains(key)) {
+        LogUtil::logError("Could not patch unknown object %1", key);
+        return false;
+    }
+
+    QByteArray payload;
+    QDataStream stream(&payload, QIODevice::WriteOnly);
+    stream << (quint8) PatchOperation << key << properties;
+
+    m_objects[key] = patchJson(m_objects[key], properties);
+    return appendRecord(payload);
+}
+
+bool JournalStorageBackend::removeObject(const QString &key) {
+
+    if (m_objects.remove(key) == 0) {
+        return false;
+    }
+
+    QByteArray payload;
+    QDataStream stream(&payload, QIODevice::WriteOnly);
+    stream << (quint8) RemoveOperation << key;
+
+    return appendRecord(payload);
+}
+
+void JournalStorageBackend::flush() {
+
+    if (!m_journal.isOpen()) {
+        return;
+    }
+
+    if (!syncFile(m_journal)) {
+        LogUtil::logError("Could not sync journal %1", m_journal.fileName());
+    }
+
+    if (m_journal.size() > qMax(m_snapshotSize, MinimumCompactionSize)) {
+        compact();
+    }
+}
+
+bool JournalStorageBackend::compact() {
+
+    QString snapshotPath = m_directory + "/snapshot";
+    QFile snapshot(snapshotPath + ".new");
+    if (!snapshot.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        LogUtil::logError("Could not open file %1 for writing", snapshot.fileName());
+        return false;
+    }
+
+    for (auto it = m_objects.constBegin(); it != m_objects.constEnd(); ++it) {
+        QByteArray payload;
+        QDataStream stream(&payload, QIODevice::WriteOnly);
+        stream << (quint8) WriteOperation << it.key() << it.value();
+
+        if (snapshot.write(encodeRecord(payload)) == -1) {
+            LogUtil::logError("Could not write snapshot %1", snapshot.fileName());
+            snapshot.remove();
+            return false;
+        }
+    }
+
+    if (!syncFile(snapshot)) {
+        LogUtil::logError("Could not sync snapshot %1", snapshot.fileName());
+        snapshot.remove();
+        return false;
+    }
+    m_snapshotSize = snapshot.size();
+    snapshot.close();
+
+    if (!FileUtil::replaceFile(snapshot.fileName(), snapshotPath)) {
+        LogUtil::logError("Could not replace snapshot %1", snapshotPath);
+        return false;
+    }
+
+    // replaying the journal on top of the new snapshot would yield the same state, so there is
+    // no harm if we crash before the journal is truncated
+    if (!m_journal.resize(0)) {
+        LogUtil::logError("Could not truncate journal %1", m_journal.fileName());
+        return false;
+    }
+    return true;
+}
+
+void JournalStorageBackend::recover() {
+
+    if (!QDir(m_directory).exists() && !QDir().mkpath(m_directory)) {
+        LogUtil::logError("Could not create journal directory: %1", m_directory);
+        return;
+    }
+
+    QFile snapshot(m_directory + "/snapshot");
+    bool hasSnapshot = snapshot.exists();
+    bool hasJournal = m_journal.exists();
+
+    // compaction rewrites the files without changing their contents, so we remember when they
+    // were last modified before that
+    if (hasSnapshot) {
+        m_lastModified = QFileInfo(snapshot).lastModified();
+    }
+    if (hasJournal) {
+        m_lastModified = qMax(m_lastModified, QFileInfo(m_journal).lastModified());
+    }
+
+    if (hasSnapshot) {
+        if (!snapshot.open(QIODevice::ReadOnly)) {
+            LogUtil::logError("Could not open snapshot %1", snapshot.fileName());
+        } else {
+            m_snapshotSize = snapshot.size();
+            if (replay(snapshot) != m_snapshotSize) {
+                LogUtil::logError("Snapshot %1 is corrupt, objects may be missing",
+                                  snapshot.fileName());
+            }
+            snapshot.close();
+        }
+    }
+
+    bool needsCompaction = false;
+    if (hasJournal) {
+        if (!m_journal.open(QIODevice::ReadWrite)) {
+            LogUtil::logError("Could not open journal %1", m_journal.fileName());
+            return;
+        }
+
+        qint64 size = m_journal.size();
+        qint64 validSize = replay(m_journal);
+        if (validSize != size) {
+            LogUtil::logInfo("Discarding %1 bytes of incomplete records from journal %2",
+                             QString::number(size - validSize), m_journal.fileName());
+            m_journal.resize(validSize);
+        }
+        m_journal.close();
+
+        needsCompaction = (validSize > 0);
+    }
+
+    if (!hasSnapshot && !hasJournal) {
+        FileStorageBackend files(DiskUtil::dataDir());
+        m_lastModified = files.lastModified();
+        for (const QString &key : files.objectKeys()) {
+            QString jsonString;
+            if (files.readObject(key, &jsonString)) {
+                m_objects[key] = jsonString;
+            }
+        }
+        LogUtil::logInfo("Imported %1 objects into journal directory %2",
+                         QString::number(m_objects.size()), m_directory);
+
+        needsCompaction = true;
+    }
+
+    if (!m_journal.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        LogUtil::logError("Could not open journal %1 for writing", m_journal.fileName());
+        return;
+    }
+
+    if (needsCompaction) {
+        compact();
+    }
+}
+
+qint64 JournalStorageBackend::replay(QFile &file) {
+
+    QByteArray data = file.readAll();
+
+    qint64 offset = 0;
+    while (data.size() - offset >= RecordHeaderSize) {
+        QDataStream header(data.mid(offset, RecordHeaderSize));
+        quint32 length, checksum;
+        header >> length >> checksum;
+
+        if (length > data.size() - offset - RecordHeaderSize) {
+            break;
+        }
+
+        QByteArray payload = data.mid(offset + RecordHeaderSize, length);
+        if (crc32(0L, (const Bytef *) payload.constData(), payload.size()) != checksum ||
+            !applyRecord(payload)) {
+            break;
+        }
+
+        offset += RecordHeaderSize + length;
+    }
+    return offset;
+}
+
+bool JournalStorageBackend::applyRecord(const QByteArray &payload) {
+
+    QDataStream stream(payload);
+    quint8 operation;
+    QString key;
+    stream >> operation >> key;
+
+    switch (operation) {
+        case WriteOperation: {
+            QString jsonString;
+            stream >> jsonString;
+            m_objects[key] = jsonString;
+            break;
+        }
+        case PatchOperation: {
+            QMap<QString, QString> properties;
+            stream >> properties;
+            if (m_objects.contains(key)) {
+                m_objects[key] = patchJson(m_objects[key], properties);
+            }
+            break;
+        }
+        case RemoveOperation:
+            m_objects.remove(key);
+            break;
+        default:
+            return false;
+    }
+
+    return stream.status() == QDataStream::Ok;
+}
+
+bool JournalStorageBackend::appendRecord(const QByteArray &payload) {
+
+    if (!m_journal.isOpen()) {
+        return false;
+    }
+
+    m_lastModified = QDateTime::currentDateTime();
+    return m_journal.write(encodeRecord(payload)) != -1;
+}
+
+QByteArray JournalStorageBackend::encodeRecord(const QByteArray &payload) {
+
+    QByteArray record;
+    record.reserve(RecordHeaderSize + payload.size());
+
+    QDataStream stream(&record, QIODevice::WriteOnly);
+    stream << (quint32) payload.size()
+           << (quint32) crc32(0L, (const Bytef *) payload.constData(), payload.size());
+    record.append(payload);
+    return record;
+}
+
+bool JournalStorageBackend::syncFile(QFile &file) {
+
+    if (!file.flush()) {
+        return false;
+    }
+
+#ifdef Q_OS_WIN
+    return _commit(file.handle()) == 0;
+#else
+    return fsync(file.handle()) == 0;
+#endif
+}
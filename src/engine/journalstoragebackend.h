@@ -0,0 +1,70 @@
+#ifndef JOURNALSTORAGEBACKEND_H
+#define JOURNALSTORAGEBACKEND_H
+
+#include <QFile>
+#include <QHash>
+
+#include "storagebackend.h"
+
+
+/**
+ * Storage backend that appends all modifications to a write-ahead journal.
+ *
+ * The directory contains a snapshot file holding the full state at the time of the last
+ * compaction, and a journal file to which object writes, patches and removals are appended.
+ * Every record is prefixed with its length and a CRC-32 checksum. On startup, the snapshot is
+ * loaded and the journal replayed on top of it, discarding a torn record at the end of the
+ * journal, after which the result is compacted into a new snapshot. The journal is also
+ * compacted whenever it grows larger than the snapshot.
+ *
+ * When the directory does not contain a snapshot or a journal yet, the objects are imported from
+ * the per-object files in the data directory.
+ *
+ * The current JSON string of every object is kept in memory, so that compaction does not need to
+ * read back from disk.
+ */
+class JournalStorageBackend : public StorageBackend {
+
+    public:
+        JournalStorageBackend(const QString &directory);
+        virtual ~JournalStorageBackend();
+
+        virtual QDateTime lastModified();
+
+        virtual QStringList objectKeys();
+        virtual bool readObject(const QString &key, QString *jsonString);
+
+        virtual bool writeObject(const QString &key, const QString &jsonString);
+        virtual bool patchObject(const QString &key, const QMap<QString, QString> &properties);
+        virtual bool removeObject(const QString &key);
+
+        virtual void flush();
+
+        bool compact();
+
+    private:
+        enum Operation {
+            WriteOperation = 1,
+            PatchOperation,
+            RemoveOperation
+        };
+
+        QString m_directory;
+
+        QFile m_journal;
+        qint64 m_snapshotSize;
+
+        QDateTime m_lastModified;
+
+        QHash<QString, QString> m_objects;
+
+        void recover();
+        qint64 replay(QFile &file);
+        bool applyRecord(const QByteArray &payload);
+        bool appendRecord(const QByteArray &payload);
+
+        static QByteArray encodeRecord(const QByteArray &payload);
+        static bool syncFile(QFile &file);
+};
+
+#endif // JOURNALSTORAGEBACKEND_H
@@ -0,0 +1,470 @@
+#include "jsonreader.h"
+
+#include <climits>
+
+#include <QVariantList>
+#include <QVariantMap>
+
+
+// limits the recursion in readValue(), so that malformed input cannot overflow the stack
+static const int MaxDepth = 256;
+
+
+JsonReader::JsonReader(const QString &json) :
+    m_json(json),
+    m_begin(m_json.constData()),
+    m_position(m_begin),
+    m_end(m_begin + m_json.size()),
+    m_state(BeforeDocument),
+    m_token(End),
+    m_tokenBegin(m_begin),
+    m_stringBegin(nullptr),
+    m_stringLength(0),
+    m_stringIsBuffered(false),
+    m_bool(false),
+    m_errorOffset(-1) {
+}
+
+JsonReader::Token JsonReader::next() {
+
+    if (m_token == Error) {
+        return Error;
+    }
+
+    skipWhitespace();
+
+    if (m_containers.isEmpty()) {
+        if (m_state == BeforeDocument) {
+            if (m_position == m_end) {
+                return m_token = End;
+            }
+            if (*m_position != '{' && *m_position != '[') {
+                return setError("Expected object or array");
+            }
+            return readValueToken();
+        }
+
+        if (m_position != m_end) {
+            return setError("Unexpected data after end of document");
+        }
+        return m_token = End;
+    }
+
+    char container = m_containers[m_containers.size() - 1];
+    char closingCharacter = (container == '{' ? '}' : ']');
+
+    switch (m_state) {
+        case AfterOpen:
+            if (m_position != m_end && *m_position == closingCharacter) {
+                break;
+            }
+            return container == '{' ? readKey() : readValueToken();
+        case AfterKey:
+            if (m_position == m_end || *m_position != ':') {
+                return setError("Expected colon");
+            }
+            m_position++;
+            skipWhitespace();
+            return readValueToken();
+        case AfterValue:
+            if (m_position == m_end) {
+                return setError("Unexpected end of document");
+            }
+            if (*m_position == ',') {
+                m_position++;
+                skipWhitespace();
+                return container == '{' ? readKey() : readValueToken();
+            }
+            if (*m_position != closingCharacter) {
+                return setError("Expected comma or end of container");
+            }
+            break;
+        default:
+            return setError("Invalid state");
+    }
+
+    m_tokenBegin = m_position;
+    m_position++;
+    m_containers.removeLast();
+    m_state = AfterValue;
+    return m_token = (container == '{' ? EndObject : EndArray);
+}
+
+QStringRef JsonReader::stringRef() const {
+
+    if (m_stringIsBuffered) {
+        return QStringRef(&m_stringBuffer);
+    } else {
+        return QStringRef(&m_json, m_stringBegin - m_begin, m_stringLength);
+    }
+}
+
+QVariant JsonReader::readValue() {
+
+    switch (m_token) {
+        case String:
+            return string();
+        case Number:
+            return m_number;
+        case Bool:
+            return m_bool;
+        case BeginObject: {
+            QVariantMap map;
+            while (next() == Key) {
+                QString key = string();
+                next();
+                QVariant value = readValue();
+                if (m_token == Error) {
+                    return QVariant();
+                }
+                map.insert(key, value);
+            }
+            return m_token == EndObject ? QVariant(map) : QVariant();
+        }
+        case BeginArray: {
+            QVariantList list;
+            while (next() != EndArray) {
+                QVariant value = readValue();
+                if (m_token == Error) {
+                    return QVariant();
+                }
+                list.append(value);
+            }
+            return list;
+        }
+        default:
+            return QVariant();
+    }
+}
+
+bool JsonReader::skipValue() {
+
+    if (m_token == BeginObject || m_token == BeginArray) {
+        int depth = m_containers.size();
+        while (m_containers.size() >= depth) {
+            if (next() == Error) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    return m_token != Error && m_token != End;
+}
+
+QVariant JsonReader::parse(const QString &json, bool *ok) {
+
+    JsonReader reader(json);
+    QVariant result;
+    if (reader.next() != End) {
+        result = reader.readValue();
+        reader.next();
+    }
+
+    if (ok) {
+        *ok = !reader.hasError();
+    }
+    return reader.hasError() ? QVariant() : result;
+}
+
+JsonReader::Token JsonReader::readKey() {
+
+    m_tokenBegin = m_position;
+    if (m_position == m_end || *m_position != '"') {
+        return setError("Expected key");
+    }
+    if (!readString()) {
+        return Error;
+    }
+
+    m_state = AfterKey;
+    return m_token = Key;
+}
+
+JsonReader::Token JsonReader::readValueToken() {
+
+    m_tokenBegin = m_position;
+    if (m_position == m_end) {
+        return setError("Unexpected end of document");
+    }
+
+    switch (m_position->unicode()) {
+        case '{':
+            return readContainer('{', BeginObject);
+        case '[':
+            return readContainer('[', BeginArray);
+        case '"':
+            if (!readString()) {
+                return Error;
+            }
+            m_token = String;
+            break;
+        case '-':
+        case '0': case '1': case '2': case '3': case '4':
+        case '5': case '6': case '7': case '8': case '9':
+            if (!readNumber()) {
+                return Error;
+            }
+            m_token = Number;
+            break;
+        case 't':
+        case 'T':
+            if (!readLiteral("true")) {
+                return Error;
+            }
+            m_bool = true;
+            m_token = Bool;
+            break;
+        case 'f':
+        case 'F':
+            if (!readLiteral("false")) {
+                return Error;
+            }
+            m_bool = false;
+            m_token = Bool;
+            break;
+        case 'n':
+        case 'N':
+            if (!readLiteral("null")) {
+                return Error;
+            }
+            m_token = Null;
+            break;
+        default:
+            return setError("Unexpected character");
+    }
+
+    m_state = AfterValue;
+    return m_token;
+}
+
+JsonReader::Token JsonReader::readContainer(char container, Token token) {
+
+    if (m_containers.size() >= MaxDepth) {
+        return setError("Maximum nesting depth exceeded");
+    }
+
+    m_position++;
+    m_containers.append(container);
+    m_state = AfterOpen;
+    return m_token = token;
+}
+
+bool JsonReader::readString() {
+
+    const QChar *begin = ++m_position;
+    const QChar *position = begin;
+    while (position != m_end && *position != '"' && *position != '\\') {
+        position++;
+    }
+    if (position == m_end) {
+        setError("Unterminated string");
+        return false;
+    }
+
+    if (*position == '"') {
+        m_stringBegin = begin;
+        m_stringLength = position - begin;
+        m_stringIsBuffered = false;
+        m_position = position + 1;
+        return true;
+    }
+
+    // resizing keeps the capacity of the buffer, unless it is still shared with a returned string
+    m_stringBuffer.resize(0);
+    m_stringBuffer.append(begin, position - begin);
+    while (position != m_end && *position != '"') {
+        if (*position != '\\') {
+            m_stringBuffer.append(*position);
+            position++;
+            continue;
+        }
+
+        m_position = position;
+        if (++position == m_end) {
+            break;
+        }
+
+        switch (position->unicode()) {
+            case '"':
+            case '\\':
+            case '/':
+                m_stringBuffer.append(*position);
+                break;
+            case 'b':
+                m_stringBuffer.append(QChar('\b'));
+                break;
+            case 'f':
+                m_stringBuffer.append(QChar('\f'));
+                break;
+            case 'n':
+                m_stringBuffer.append(QChar('\n'));
+                break;
+            case 'r':
+                m_stringBuffer.append(QChar('\r'));
+                break;
+            case 't':
+                m_stringBuffer.append(QChar('\t'));
+                break;
+            case 'u': {
+                if (m_end - position < 5) {
+                    setError("Invalid escape sequence");
+                    return false;
+                }
+                ushort character = 0;
+                for (int i = 1; i <= 4; i++) {
+                    ushort digit = position[i].unicode();
+                    if (digit >= '0' && digit <= '9') {
+                        digit -= '0';
+                    } else if (digit >= 'a' && digit <= 'f') {
+                        digit -= 'a' - 10;
+                    } else if (digit >= 'A' && digit <= 'F') {
+                        digit -= 'A' - 10;
+                    } else {
+                        setError("Invalid escape sequence");
+                        return false;
+                    }
+                    character = (character << 4) | digit;
+                }
+                // surrogate pairs are encoded as two escape sequences, so they need no special
+                // handling in UTF-16
+                m_stringBuffer.append(QChar(character));
+                position += 4;
+                break;
+            }
+            default:
+                setError("Invalid escape sequence");
+                return false;
+        }
+        position++;
+    }
+    if (position == m_end) {
+        setError("Unterminated string");
+        return false;
+    }
+
+    m_stringIsBuffered = true;
+    m_position = position + 1;
+    return true;
+}
+
+bool JsonReader::readNumber() {
+
+    const QChar *position = m_position;
+    bool negative = (*position == '-');
+    if (negative) {
+        position++;
+    }
+
+    const QChar *digits = position;
+    while (position != m_end && position->unicode() >= '0' && position->unicode() <= '9') {
+        position++;
+    }
+    int numDigits = position - digits;
+    if (numDigits == 0) {
+        setError("Invalid number");
+        return false;
+    }
+
+    bool integral = true;
+    if (position != m_end && *position == '.') {
+        const QChar *fraction = ++position;
+        while (position != m_end && position->unicode() >= '0' && position->unicode() <= '9') {
+            position++;
+        }
+        if (position == fraction) {
+            setError("Invalid number");
+            return false;
+        }
+        integral = false;
+    }
+    if (position != m_end && (*position == 'e' || *position == 'E')) {
+        position++;
+        if (position != m_end && (*position == '+' || *position == '-')) {
+            position++;
+        }
+        const QChar *exponent = position;
+        while (position != m_end && position->unicode() >= '0' && position->unicode() <= '9') {
+            position++;
+        }
+        if (position == exponent) {
+            setError("Invalid number");
+            return false;
+        }
+        integral = false;
+    }
+
+    // any number of up to 18 digits fits in a qint64
+    if (integral && numDigits <= 18) {
+        qint64 value = 0;
+        for (const QChar *digit = digits; digit != position; digit++) {
+            value = 10 * value + (digit->unicode() - '0');
+        }
+        if (negative) {
+            value = -value;
+        }
+        if (value >= INT_MIN && value <= INT_MAX) {
+            m_number = QVariant((int) value);
+        } else {
+            m_number = QVariant((qlonglong) value);
+        }
+    } else {
+        bool ok;
+        double value = QString::fromRawData(m_position, position - m_position).toDouble(&ok);
+        if (!ok) {
+            setError("Invalid number");
+            return false;
+        }
+        m_number = QVariant(value);
+    }
+
+    m_position = position;
+    return true;
+}
+
+bool JsonReader::readLiteral(const char *literal) {
+
+    const QChar *position = m_position;
+    for (; *literal; literal++, position++) {
+        if (position == m_end) {
+            setError("Unexpected end of document");
+            return false;
+        }
+        ushort character = position->unicode();
+        if (character >= 'A' && character <= 'Z') {
+            character += 'a' - 'A';
+        }
+        if (character != *literal) {
+            setError("Invalid literal");
+            return false;
+        }
+    }
+
+    m_position = position;
+    return true;
+}
+
+void JsonReader::skipWhitespace() {
+
+    while (m_position != m_end) {
+        switch (m_position->unicode()) {
+            case ' ':
+            case '\t':
+            case '\n':
+            case '\r':
+            case '\f':
+            case '\v':
+                m_position++;
+                break;
+            default:
+                return;
+        }
+    }
+}
+
+JsonReader::Token JsonReader::setError(const char *message) {
+
+    m_errorString = message;
+    m_errorOffset = m_position - m_begin;
+    return m_token = Error;
+}
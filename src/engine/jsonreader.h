@@ -0,0 +1,127 @@
+#ifndef JSONREADER_H
+#define JSONREADER_H
+
+#include <QString>
+#include <QStringRef>
+#include <QVarLengthArray>
+#include <QVariant>
+
+
+/**
+ * Pull-style JSON reader that tokenizes a document without building a tree of values.
+ *
+ * Every call to next() advances to the next token. Separators are validated by the reader
+ * itself, so consumers only see the structure and the values. Strings that contain no escape
+ * sequences are referenced directly in the input, others are decoded into a buffer that is
+ * reused for the entire document.
+ *
+ * The accepted syntax is the same as that of the parser which was used before: the document
+ * must be an object or an array, literals are matched case-insensitively, and an empty document
+ * is not an error. Numbers are returned as Int when they fit, and as LongLong or Double
+ * otherwise.
+ */
+class JsonReader {
+
+    public:
+        enum Token {
+            Error,
+            End,
+            BeginObject,
+            EndObject,
+            BeginArray,
+            EndArray,
+            Key,
+            String,
+            Number,
+            Bool,
+            Null
+        };
+
+        explicit JsonReader(const QString &json);
+
+        Token next();
+
+        Token token() const { return m_token; }
+
+        bool hasError() const { return m_token == Error; }
+        const QString &errorString() const { return m_errorString; }
+        int errorOffset() const { return m_errorOffset; }
+
+        /**
+         * Returns the current key or string value. The reference is only valid until the next
+         * call to next().
+         */
+        QStringRef stringRef() const;
+        QString string() const { return stringRef().toString(); }
+
+        /**
+         * Returns the offsets in the document of the first character of the current token and
+         * of the character following it. After skipValue(), the latter is the end of the
+         * skipped value.
+         */
+        int tokenOffset() const { return m_tokenBegin - m_begin; }
+        int offset() const { return m_position - m_begin; }
+
+        const QVariant &numberValue() const { return m_number; }
+        bool boolValue() const { return m_bool; }
+
+        /**
+         * Reads the value starting at the current token into a variant, advancing to its last
+         * token. Returns an invalid variant for null values and on errors.
+         */
+        QVariant readValue();
+
+        /**
+         * Skips the value starting at the current token, advancing to its last token. Returns
+         * false on errors.
+         */
+        bool skipValue();
+
+        /**
+         * Parses an entire document into a variant.
+         *
+         * @param ok Optional pointer that is set to false if the document is not valid.
+         */
+        static QVariant parse(const QString &json, bool *ok = nullptr);
+
+    private:
+        enum State {
+            BeforeDocument,
+            AfterOpen,
+            AfterKey,
+            AfterValue
+        };
+
+        QString m_json;
+        const QChar *m_begin;
+        const QChar *m_position;
+        const QChar *m_end;
+
+        QVarLengthArray<char, 16> m_containers;
+        State m_state;
+        Token m_token;
+        const QChar *m_tokenBegin;
+
+        const QChar *m_stringBegin;
+        int m_stringLength;
+        QString m_stringBuffer;
+        bool m_stringIsBuffered;
+
+        QVariant m_number;
+        bool m_bool;
+
+        QString m_errorString;
+        int m_errorOffset;
+
+        Token readKey();
+        Token readValueToken();
+        Token readContainer(char container, Token token);
+        bool readString();
+        bool readNumber();
+        bool readLiteral(const char *literal);
+        void skipWhitespace();
+
+        Token setError(const char *message);
+};
+
+#endif // JSONREADER_H
@@ -0,0 +1,251 @@
+#include "jsonwriter.h"
+
+#include <QDateTime>
+#include <QStringList>
+
+#include "logutil.h"
+#include "metatyperegistry.h"
+
+
+JsonWriter::JsonWriter(int capacity) {
+
+    // with reserved capacity, resizing the buffer to zero does not free it
+    m_buffer.reserve(capacity);
+}
+
+void JsonWriter::writeBool(bool value) {
+
+    if (value) {
+        m_buffer.append("true", 4);
+    } else {
+        m_buffer.append("false", 5);
+    }
+}
+
+void JsonWriter::writeInt(qint64 value) {
+
+    if (value < 0) {
+        m_buffer.append('-');
+        writeUInt(-(quint64) value);
+    } else {
+        writeUInt(value);
+    }
+}
+
+void JsonWriter::writeUInt(quint64 value) {
+
+    char digits[20];
+    int length = 0;
+    do {
+        digits[sizeof(digits) - ++length] = '0' + value % 10;
+        value /= 10;
+    } while (value > 0);
+
+    m_buffer.append(digits + sizeof(digits) - length, length);
+}
+
+void JsonWriter::writeDouble(double value) {
+
+    // same formatting as QString::number()
+    m_buffer.append(QByteArray::number(value));
+}
+
+void JsonWriter::writeString(const QString &string) {
+
+    const ushort *data = string.utf16();
+    int length = string.length();
+
+    // every UTF-16 code unit takes at most three bytes, including escape characters
+    int offset = m_buffer.size();
+    m_buffer.resize(offset + 3 * length + 2);
+    char *begin = m_buffer.data() + offset;
+    char *out = begin;
+
+    *out++ = '"';
+    for (int i = 0; i < length; i++) {
+        uint character = data[i];
+        if (character < 0x80) {
+            if (character == '\\' || character == '"') {
+                *out++ = '\\';
+                *out++ = character;
+            } else if (character == '\n') {
+                *out++ = '\\';
+                *out++ = 'n';
+            } else {
+                *out++ = character;
+            }
+        } else if (character < 0x800) {
+            *out++ = 0xc0 | (character >> 6);
+            *out++ = 0x80 | (character & 0x3f);
+        } else {
+            if (QChar::isSurrogate(character)) {
+                if (QChar::isHighSurrogate(character) && i + 1 < length &&
+                    QChar::isLowSurrogate(data[i + 1])) {
+                    character = QChar::surrogateToUcs4(character, data[++i]);
+                    *out++ = 0xf0 | (character >> 18);
+                    *out++ = 0x80 | ((character >> 12) & 0x3f);
+                    *out++ = 0x80 | ((character >> 6) & 0x3f);
+                    *out++ = 0x80 | (character & 0x3f);
+                    continue;
+                }
+                character = QChar::ReplacementCharacter;
+            }
+            *out++ = 0xe0 | (character >> 12);
+            *out++ = 0x80 | ((character >> 6) & 0x3f);
+            *out++ = 0x80 | (character & 0x3f);
+        }
+    }
+    *out++ = '"';
+
+    m_buffer.resize(offset + (out - begin));
+}
+
+void JsonWriter::writeString(const QByteArray &utf8) {
+
+    const char *data = utf8.constData();
+    int length = utf8.length();
+
+    int offset = m_buffer.size();
+    m_buffer.resize(offset + 2 * length + 2);
+    char *begin = m_buffer.data() + offset;
+    char *out = begin;
+
+    *out++ = '"';
+    for (int i = 0; i < length; i++) {
+        char character = data[i];
+        if (character == '\\' || character == '"') {
+            *out++ = '\\';
+            *out++ = character;
+        } else if (character == '\n') {
+            *out++ = '\\';
+            *out++ = 'n';
+        } else {
+            *out++ = character;
+        }
+    }
+    *out++ = '"';
+
+    m_buffer.resize(offset + (out - begin));
+}
+
+bool JsonWriter::writeVariant(const QVariant &variant, Options options) {
+
+    switch (variant.type()) {
+        case QVariant::Bool:
+            writeBool(variant.toBool());
+            return true;
+        case QVariant::Int:
+            writeInt(variant.toInt());
+            return true;
+        case QVariant::UInt:
+            writeUInt(variant.toUInt());
+            return true;
+        case QVariant::Double:
+            writeDouble(variant.toDouble());
+            return true;
+        case QVariant::String: {
+            QString string = variant.toString();
+            if (string.isEmpty()) {
+                return false;
+            }
+            writeString(string);
+            return true;
+        }
+        case QVariant::List: {
+            QVariantList list = variant.toList();
+            if (list.isEmpty()) {
+                return false;
+            }
+            m_buffer.append("[ ", 2);
+            for (int i = 0; i < list.size(); i++) {
+                if (i > 0) {
+                    m_buffer.append(", ", 2);
+                }
+                writeVariant(list[i]);
+            }
+            m_buffer.append(" ]", 2);
+            return true;
+        }
+        case QVariant::StringList: {
+            QStringList stringList = variant.toStringList();
+            if (stringList.isEmpty()) {
+                return false;
+            }
+            m_buffer.append("[ ", 2);
+            for (int i = 0; i < stringList.size(); i++) {
+                if (i > 0) {
+                    m_buffer.append(", ", 2);
+                }
+                writeString(stringList[i]);
+            }
+            m_buffer.append(" ]", 2);
+            return true;
+        }
+        case QVariant::DateTime:
+            writeInt(variant.toDateTime().toMSecsSinceEpoch());
+            return true;
+        case QVariant::Map: {
+            int begin = m_buffer.size();
+            m_buffer.append("{ ", 2);
+            bool empty = true;
+            QVariantMap map = variant.toMap();
+            for (auto it = map.constBegin(); it != map.constEnd(); ++it) {
+                int size = m_buffer.size();
+                if (!empty) {
+                    m_buffer.append(", ", 2);
+                }
+                writeString(it.key());
+                m_buffer.append(": ", 2);
+
+                bool written;
+                if (options & IncludeTypeInfo) {
+                    const QVariant &value = it.value();
+                    m_buffer.append("[ ", 2);
+                    writeInt(value.type());
+                    m_buffer.append(", ", 2);
+                    writeInt(value.userType());
+                    m_buffer.append(", ", 2);
+                    written = writeVariant(value, options);
+                    m_buffer.append(" ]", 2);
+                } else {
+                    written = writeVariant(it.value(), options);
+                }
+
+                if (written) {
+                    empty = false;
+                } else {
+                    m_buffer.resize(size);
+                }
+            }
+            if (empty) {
+                m_buffer.resize(begin);
+                return false;
+            }
+            m_buffer.append(" }", 2);
+            return true;
+        }
+        case QVariant::UserType: {
+            MetaTypeRegistry::JsonConverters converters =
+                    MetaTypeRegistry::jsonConverters(QMetaType::typeName(variant.userType()));
+            if (converters.typeToJsonStringConverter) {
+                QString jsonString = converters.typeToJsonStringConverter(variant);
+                if (jsonString.isEmpty()) {
+                    return false;
+                }
+                writeRaw(jsonString);
+                return true;
+            } else {
+                const char *typeName = QMetaType::typeName(variant.userType());
+                if (typeName) {
+                    LogUtil::logError("User type not serializable: %1", typeName);
+                } else {
+                    LogUtil::logError("Unknown user type: %1", QString::number(variant.userType()));
+                }
+                return false;
+            }
+        }
+        default:
+            LogUtil::logError("Unknown type: %1", variant.typeName());
+            return false;
+    }
+}
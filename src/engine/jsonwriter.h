@@ -0,0 +1,64 @@
+#ifndef JSONWRITER_H
+#define JSONWRITER_H
+
+#include <QByteArray>
+#include <QString>
+#include <QVariant>
+
+#include "constants.h"
+
+
+/**
+ * Streaming JSON writer that serializes directly into a UTF-8 encoded buffer.
+ *
+ * The buffer keeps its capacity when the writer is cleared, so a single writer can be reused
+ * for serializing many objects without reallocating. Values are formatted the same way as in
+ * the object files in the data directory.
+ */
+class JsonWriter {
+
+    public:
+        explicit JsonWriter(int capacity = 1024);
+
+        const QByteArray &data() const { return m_buffer; }
+        int size() const { return m_buffer.size(); }
+        bool isEmpty() const { return m_buffer.isEmpty(); }
+
+        QString toString() const { return QString::fromUtf8(m_buffer); }
+
+        void clear() { m_buffer.resize(0); }
+        void truncate(int size) { m_buffer.resize(size); }
+
+        void writeRaw(char character) { m_buffer.append(character); }
+        void writeRaw(const char *string) { m_buffer.append(string); }
+        void writeRaw(const char *string, int length) { m_buffer.append(string, length); }
+        void writeRaw(const QByteArray &data) { m_buffer.append(data); }
+        void writeRaw(const QString &string) { m_buffer.append(string.toUtf8()); }
+
+        void writeBool(bool value);
+        void writeInt(qint64 value);
+        void writeUInt(quint64 value);
+        void writeDouble(double value);
+
+        /**
+         * Writes a quoted and escaped string.
+         */
+        void writeString(const QString &string);
+
+        /**
+         * Writes a quoted and escaped string from data that is already UTF-8 encoded, for
+         * example another JSON document.
+         */
+        void writeString(const QByteArray &utf8);
+
+        /**
+         * Writes a value the way ConversionUtil::toJsonString() would. Returns false, without
+         * writing anything, if that function would return an empty string.
+         */
+        bool writeVariant(const QVariant &variant, Options options = NoOptions);
+
+    private:
+        QByteArray m_buffer;
+};
+
+#endif // JSONWRITER_H
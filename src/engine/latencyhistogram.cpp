@@ -0,0 +1,67 @@
+#include "latencyhistogram.h"
+
+#include <cmath>
+#include <cstring>
+
+
+LatencyHistogram::LatencyHistogram() {
+
+    reset();
+}
+
+void LatencyHistogram::record(qint64 value) {
+
+    value = qBound(Q_INT64_C(0), value, (Q_INT64_C(1) << MaxValueBits) - 1);
+
+    m_counts[bucketIndex(value)]++;
+    m_count++;
+    m_max = qMax(m_max, value);
+}
+
+void LatencyHistogram::reset() {
+
+    memset(m_counts, 0, sizeof(m_counts));
+    m_count = 0;
+    m_max = 0;
+}
+
+qint64 LatencyHistogram::percentile(double percentage) const {
+
+    if (m_count == 0) {
+        return 0;
+    }
+
+    quint64 target = (quint64) std::ceil(qBound(0.0, percentage, 100.0) * m_count / 100.0);
+    target = qMax(target, Q_UINT64_C(1));
+
+    quint64 count = 0;
+    for (int i = 0; i < NumBuckets; i++) {
+        count += m_counts[i];
+        if (count >= target) {
+            return qMin(highestValueInBucket(i), m_max);
+        }
+    }
+    return m_max;
+}
+
+int LatencyHistogram::bucketIndex(qint64 value) {
+
+    // the first two sets of sub-buckets have a width of 1, every following set covers twice the
+    // range of the previous one using the same number of sub-buckets
+    int shift = 0;
+    while ((value >> shift) >= 2 * SubBucketCount) {
+        shift++;
+    }
+    return shift * SubBucketCount + (int) (value >> shift);
+}
+
+qint64 LatencyHistogram::highestValueInBucket(int index) {
+
+    if (index < 2 * SubBucketCount) {
+        return index;
+    }
+
+    int shift = index / SubBucketCount - 1;
+    qint64 subBucket = index % SubBucketCount + SubBucketCount;
+    return ((subBucket + 1) << shift) - 1;
+}
@@ -0,0 +1,47 @@
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+#include <QtGlobal>
+
+
+/**
+ * Histogram of latencies in microseconds, in the style of HdrHistogram.
+ *
+ * Values are counted in buckets that get wider as the values get larger, so every bucket
+ * covers a range of at most about 3% of its values. Recording a value is a constant-time
+ * update of a fixed-size array, no matter how many values are recorded. Values of more than
+ * about 71 minutes are counted as 71 minutes.
+ */
+class LatencyHistogram {
+
+    public:
+        LatencyHistogram();
+
+        void record(qint64 value);
+
+        void reset();
+
+        quint64 count() const { return m_count; }
+        qint64 max() const { return m_max; }
+
+        /**
+         * Returns the value below which the given percentage of the recorded values lie, or
+         * 0 if nothing was recorded.
+         */
+        qint64 percentile(double percentage) const;
+
+    private:
+        static const int SubBucketBits = 5;
+        static const int SubBucketCount = 1 << SubBucketBits;
+        static const int MaxValueBits = 32;
+        static const int NumBuckets = (MaxValueBits - SubBucketBits + 1) * SubBucketCount;
+
+        quint64 m_counts[NumBuckets];
+        quint64 m_count;
+        qint64 m_max;
+
+        static int bucketIndex(qint64 value);
+        static qint64 highestValueInBucket(int index);
+};
+
+#endif // LATENCYHISTOGRAM_H
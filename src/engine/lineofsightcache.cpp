@@ -0,0 +1,192 @@
+#include "lineofsightcache.h"
+
+#include <algorithm>
+#include <queue>
+
+#include "room.h"
+#include "roomgraph.h"
+
+
+LineOfSightCache::LineOfSightCache(RoomGraph *roomGraph) :
+    m_roomGraph(roomGraph),
+    m_numSightLines(0),
+    m_numUses(0),
+    m_epoch(0) {
+}
+
+const QVector<SightLine> &LineOfSightCache::sightLines(Room *room, double minAttenuation) {
+
+    m_numUses++;
+
+    int index = room->graphIndex();
+    if (index == -1) {
+        m_unindexedSightLines.clear();
+        SightLine sightLine = { room, -1, 1.0 };
+        m_unindexedSightLines.append(sightLine);
+        return m_unindexedSightLines;
+    }
+
+    auto it = m_entries.find(index);
+    if (it != m_entries.end()) {
+        if (isValid(it.value(), minAttenuation)) {
+            it.value().lastUse = m_numUses;
+            return it.value().sightLines;
+        }
+        m_numSightLines -= it.value().sightLines.size();
+    } else {
+        if (m_numSightLines > MaxCachedSightLines) {
+            evict();
+        }
+        it = m_entries.insert(index, Entry());
+    }
+
+    Entry &entry = it.value();
+    computeSightLines(room, minAttenuation, entry);
+    entry.lastUse = m_numUses;
+    m_numSightLines += entry.sightLines.size();
+    return entry.sightLines;
+}
+
+void LineOfSightCache::clear() {
+
+    m_entries.clear();
+    m_numSightLines = 0;
+}
+
+bool LineOfSightCache::isWithinSight(Room *sourceRoom, const Vector3D &sourceVector,
+                                     const RoomEdge &edge) {
+
+    const Vector3D &targetVector = edge.direction;
+    if (sourceVector == targetVector) {
+        return true;
+    }
+
+    if (~sourceRoom->flags() & RoomFlags::HasWalls) {
+        if (targetVector.z == sourceVector.z) {
+            return true;
+        }
+    } else {
+        if (targetVector.x != sourceVector.x || targetVector.y != sourceVector.y) {
+            return false;
+        }
+    }
+
+    return ((~sourceRoom->flags() & RoomFlags::HasCeiling && targetVector.z >= sourceVector.z) ||
+            (~sourceRoom->flags() & RoomFlags::HasFloor && targetVector.z <= sourceVector.z));
+}
+
+bool LineOfSightCache::isValid(const Entry &entry, double minAttenuation) const {
+
+    if (entry.minAttenuation > minAttenuation) {
+        return false;
+    }
+
+    for (const SightLine &sightLine : entry.sightLines) {
+        if (m_roomGraph->roomVersion(sightLine.roomIndex) > entry.version) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void LineOfSightCache::computeSightLines(Room *room, double minAttenuation, Entry &entry) {
+
+    // make sure pending changes are applied, so they don't bump versions after the fact
+    m_roomGraph->update();
+
+    entry.sightLines.clear();
+    entry.minAttenuation = minAttenuation;
+    entry.version = m_roomGraph->version();
+
+    int numIndices = m_roomGraph->numIndices();
+    if (m_attenuations.size() < numIndices) {
+        m_attenuations.resize(numIndices);
+        m_stamps.fill(0, numIndices);
+        m_epoch = 0;
+    }
+    m_epoch++;
+    if (m_epoch == 0) {
+        m_stamps.fill(0);
+        m_epoch = 1;
+    }
+
+    // a room is finalized once it is taken from the queue, after which its attenuation is set
+    // to -1 so that it is not reached again
+    typedef std::pair<double, int> QueueItem;
+    std::priority_queue<QueueItem> queue;
+
+    int originIndex = room->graphIndex();
+    m_stamps[originIndex] = m_epoch;
+    m_attenuations[originIndex] = 1.0;
+    queue.push(QueueItem(1.0, originIndex));
+
+    while (!queue.empty()) {
+        QueueItem item = queue.top();
+        queue.pop();
+
+        double attenuation = item.first;
+        int index = item.second;
+        if (m_attenuations[index] < 0.0 || attenuation < m_attenuations[index]) {
+            continue; // already finalized through a stronger line of sight
+        }
+        m_attenuations[index] = -1.0;
+
+        Room *sourceRoom = m_roomGraph->room(index);
+        SightLine sightLine = { sourceRoom, index, attenuation };
+        entry.sightLines.append(sightLine);
+
+        if (index != originIndex) {
+            attenuation *= sourceRoom->eventMultiplier(GameEventType::Visual);
+        }
+
+        Vector3D sourceVector = (sourceRoom->position() - room->position()).normalized();
+        for (const RoomEdge &edge : m_roomGraph->edges(sourceRoom)) {
+            if (!edge.canSeeThrough()) {
+                continue;
+            }
+
+            int targetIndex = edge.oppositeIndex;
+            bool isSeen = (m_stamps[targetIndex] == m_epoch);
+            if (isSeen && m_attenuations[targetIndex] < 0.0) {
+                continue;
+            }
+
+            double targetAttenuation = attenuation * edge.eventMultiplier(GameEventType::Visual);
+            if (targetAttenuation < minAttenuation ||
+                (isSeen && targetAttenuation <= m_attenuations[targetIndex])) {
+                continue;
+            }
+
+            if (index != originIndex && !isWithinSight(sourceRoom, sourceVector, edge)) {
+                continue;
+            }
+
+            m_stamps[targetIndex] = m_epoch;
+            m_attenuations[targetIndex] = targetAttenuation;
+            queue.push(QueueItem(targetAttenuation, targetIndex));
+        }
+    }
+
+    entry.sightLines.squeeze();
+}
+
+void LineOfSightCache::evict() {
+
+    // drop the least recently used half of the results
+    QVector<quint64> lastUses;
+    lastUses.reserve(m_entries.size());
+    for (const Entry &entry : m_entries) {
+        lastUses.append(entry.lastUse);
+    }
+    std::nth_element(lastUses.begin(), lastUses.begin() + lastUses.size() / 2, lastUses.end());
+    quint64 threshold = lastUses[lastUses.size() / 2];
+
+    for (auto it = m_entries.begin(); it != m_entries.end();) {
+        if (it.value().lastUse < threshold) {
+            m_numSightLines -= it.value().sightLines.size();
+            it = m_entries.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
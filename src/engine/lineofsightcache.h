@@ -0,0 +1,94 @@
+#ifndef LINEOFSIGHTCACHE_H
+#define LINEOFSIGHTCACHE_H
+
+#include <QHash>
+#include <QVector>
+
+#include "vector3d.h"
+
+
+class Room;
+class RoomGraph;
+struct RoomEdge;
+
+
+/**
+ * Room that can be seen from another room.
+ */
+struct SightLine {
+
+    Room *room;
+    int roomIndex;
+
+    // multiplier for the strength of a visual event arriving in the room, relative to the
+    // strength in the room it is seen from, not yet including the multiplier of the room itself
+    double attenuation;
+};
+
+
+/**
+ * Caches for every room which other rooms can be seen from it.
+ *
+ * The rooms visible from a room are found by following the strongest line of sight through
+ * every room, taking into account whether portals can be seen through, the visual multipliers
+ * of portals and rooms, and whether walls, ceilings and floors block the view. The result only
+ * includes rooms down to a minimum attenuation, and is recomputed when a lower attenuation is
+ * asked for.
+ *
+ * Cached results are only checked when they are used: a result is valid as long as none of the
+ * rooms it contains have changed since it was computed, which is tracked through the versions
+ * of the room graph. When too many sight lines are cached, the least recently used results are
+ * dropped.
+ *
+ * All methods may only be called from the game thread.
+ */
+class LineOfSightCache {
+
+    public:
+        static const int MaxCachedSightLines = 1 << 20;
+
+        LineOfSightCache(RoomGraph *roomGraph);
+
+        /**
+         * Returns the rooms visible from the given room, including the room itself, in order
+         * of decreasing attenuation. The returned list may also contain rooms with a lower
+         * attenuation than the one asked for, and stays valid until the next call to
+         * sightLines() or clear().
+         */
+        const QVector<SightLine> &sightLines(Room *room, double minAttenuation);
+
+        int numCachedSightLines() const { return m_numSightLines; }
+
+        void clear();
+
+    private:
+        struct Entry {
+            QVector<SightLine> sightLines;
+            double minAttenuation;
+            quint64 version;
+            quint64 lastUse;
+        };
+
+        RoomGraph *m_roomGraph;
+
+        QHash<int, Entry> m_entries;
+        int m_numSightLines;
+        quint64 m_numUses;
+
+        // result for rooms that are not in the room graph, which only see themselves
+        QVector<SightLine> m_unindexedSightLines;
+
+        // scratch space for computing sight lines, indexed by room index
+        QVector<double> m_attenuations;
+        QVector<quint32> m_stamps;
+        quint32 m_epoch;
+
+        static bool isWithinSight(Room *sourceRoom, const Vector3D &sourceVector,
+                                  const RoomEdge &edge);
+
+        bool isValid(const Entry &entry, double minAttenuation) const;
+        void computeSightLines(Room *room, double minAttenuation, Entry &entry);
+        void evict();
+};
+
+#endif // LINEOFSIGHTCACHE_H
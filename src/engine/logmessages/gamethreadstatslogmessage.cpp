@@ -0,0 +1,33 @@
+#include "gamethreadstatslogmessage.h"
+
+#include <QList>
+#include <QPair>
+
+#include "diskutil.h"
+
+
+GameThreadStatsLogMessage::GameThreadStatsLogMessage(const GameThreadSample &sample) :
+    LogMessage(),
+    m_sample(sample) {
+}
+
+GameThreadStatsLogMessage::~GameThreadStatsLogMessage() {
+}
+
+void GameThreadStatsLogMessage::log() {
+
+    // one line per value, in the same format as the other stats files, so they can be
+    // retrieved through api-log-retrieve
+    QList<QPair<QString, qint64> > values;
+    values << qMakePair(QString("eventsPerSecond"), (qint64) m_sample.eventsPerSecond())
+           << qMakePair(QString("utilization"), (qint64) m_sample.utilization())
+           << qMakePair(QString("maxQueueDepth"), (qint64) m_sample.maxQueueDepth)
+           << qMakePair(QString("averageQueueTime"), m_sample.averageQueueTime)
+           << qMakePair(QString("maxQueueTime"), m_sample.maxQueueTime)
+           << qMakePair(QString("maxTimerLateness"), m_sample.maxTimerLateness);
+
+    for (const auto &value : values) {
+        DiskUtil::appendToLogFile("gamethreadstats", value.first.leftJustified(20) +
+                                                     QString::number(value.second));
+    }
+}
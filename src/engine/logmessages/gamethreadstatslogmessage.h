@@ -0,0 +1,20 @@
+#ifndef GAMETHREADSTATSLOGMESSAGE_H
+#define GAMETHREADSTATSLOGMESSAGE_H
+
+#include "gamethreadmetrics.h"
+#include "logmessage.h"
+
+
+class GameThreadStatsLogMessage : public LogMessage {
+
+    public:
+        GameThreadStatsLogMessage(const GameThreadSample &sample);
+        virtual ~GameThreadStatsLogMessage();
+
+        virtual void log();
+
+    private:
+        GameThreadSample m_sample;
+};
+
+#endif // GAMETHREADSTATSLOGMESSAGE_H
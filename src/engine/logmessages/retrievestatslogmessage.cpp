@@ -7,6 +7,7 @@
 
 #include "asyncreplyevent.h"
 #include "diskutil.h"
+#include "player.h"
 #include "realm.h"
 #include "conversionutil.h"
 
@@ -14,7 +15,7 @@
 RetrieveStatsLogMessage::RetrieveStatsLogMessage(Player *recipient, const QString &requestId,
                                                  const QString &type, int numDays) :
     LogMessage(),
-    m_recipient(recipient),
+    m_recipientId(recipient->id()),
     m_requestId(requestId),
     m_type(type),
     m_numDays(numDays) {
@@ -66,5 +67,5 @@ void RetrieveStatsLogMessage::log() {
                             "\"data\": { %2 } "
                             "}").arg(m_requestId, stringList.join(", "));
 
-    Realm::instance()->enqueueEvent(new AsyncReplyEvent(m_recipient, reply));
+    Realm::instance()->enqueueEvent(new AsyncReplyEvent(m_recipientId, reply));
 }
@@ -18,7 +18,7 @@ class RetrieveStatsLogMessage : public LogMessage {
         virtual void log();
 
     private:
-        Player *m_recipient;
+        uint m_recipientId;
         QString m_requestId;
         QString m_type;
         int m_numDays;
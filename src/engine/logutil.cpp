@@ -7,6 +7,7 @@
 
 #include "commandlogmessage.h"
 #include "errorlogmessage.h"
+#include "gamethreadstatslogmessage.h"
 #include "npctalklogmessage.h"
 #include "playerdeathstatslogmessage.h"
 #include "realm.h"
@@ -178,3 +179,10 @@ void LogUtil::countPlayerDeath(const QString &identifier, int count) {
         Realm::instance()->enqueueLogMessage(new PlayerDeathStatsLogMessage(identifier, count));
     }
 }
+
+void LogUtil::logGameThreadStats(const GameThreadSample &sample) {
+
+    if (isLoggingEnabled()) {
+        Realm::instance()->enqueueLogMessage(new GameThreadStatsLogMessage(sample));
+    }
+}
@@ -6,6 +6,7 @@
 
 
 class QScriptValue;
+struct GameThreadSample;
 
 
 class LogUtil : public QObject {
@@ -54,6 +55,8 @@ class LogUtil : public QObject {
 
         Q_INVOKABLE static void countPlayerDeath(const QString &identifier, int count = 1);
 
+        static void logGameThreadStats(const GameThreadSample &sample);
+
     private:
         static bool s_loggingEnabled;
 };
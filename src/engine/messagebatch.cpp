@@ -0,0 +1,96 @@
+#include "messagebatch.h"
+
+#include <QThread>
+
+#include "player.h"
+#include "session.h"
+
+
+MessageBatch::MessageBatch() :
+    m_lastColor(Silver),
+    m_lastMessageIndex(-1) {
+}
+
+void MessageBatch::send(Character *recipient, const QString &message, int color) {
+
+    if (!recipient->isPlayer()) {
+        return;
+    }
+
+    Session *session = static_cast<Player *>(recipient)->session();
+    if (!session) {
+        return;
+    }
+
+    if (m_lastMessageIndex == -1 || color != m_lastColor || message != m_lastMessage) {
+        QString formattedMessage = Player::formatMessage(message, color);
+        auto it = m_messageIndices.constFind(formattedMessage);
+        if (it != m_messageIndices.constEnd()) {
+            m_lastMessageIndex = it.value();
+        } else {
+            m_lastMessageIndex = m_messages.size();
+            m_messages.append(formattedMessage);
+            m_messageIndices.insert(formattedMessage, m_lastMessageIndex);
+        }
+        m_lastMessage = message;
+        m_lastColor = color;
+    }
+
+    Delivery delivery;
+    delivery.session = session;
+    delivery.messageIndex = m_lastMessageIndex;
+    m_deliveries.append(delivery);
+}
+
+void MessageBatch::flush() {
+
+    if (m_deliveries.isEmpty()) {
+        return;
+    }
+
+    MessageBatchDispatcher *dispatcher = MessageBatchDispatcher::instance();
+    if (dispatcher && dispatcher->thread() != QThread::currentThread()) {
+        QMetaObject::invokeMethod(dispatcher, "deliver", Qt::QueuedConnection,
+                                  Q_ARG(MessageBatch, *this));
+    } else {
+        deliver();
+    }
+
+    m_deliveries.clear();
+    m_messages.clear();
+    m_messageIndices.clear();
+    m_lastMessage.clear();
+    m_lastMessageIndex = -1;
+}
+
+void MessageBatch::deliver() const {
+
+    for (const Delivery &delivery : m_deliveries) {
+        if (delivery.session) {
+            delivery.session->send(m_messages[delivery.messageIndex]);
+        }
+    }
+}
+
+
+MessageBatchDispatcher *MessageBatchDispatcher::s_instance = nullptr;
+
+MessageBatchDispatcher::MessageBatchDispatcher(QObject *parent) :
+    QObject(parent) {
+
+    qRegisterMetaType<MessageBatch>();
+
+    s_instance = this;
+}
+
+MessageBatchDispatcher::~MessageBatchDispatcher() {
+
+    if (s_instance == this) {
+        s_instance = nullptr;
+    }
+}
+
+void MessageBatchDispatcher::deliver(const MessageBatch &batch) {
+
+    batch.deliver();
+}
@@ -0,0 +1,98 @@
+#ifndef MESSAGEBATCH_H
+#define MESSAGEBATCH_H
+
+#include <QHash>
+#include <QMetaType>
+#include <QObject>
+#include <QPointer>
+#include <QString>
+#include <QVector>
+
+#include "constants.h"
+
+
+class Character;
+class Session;
+
+
+/**
+ * Messages for multiple players that are handed to the sessions all at once.
+ *
+ * Game events collect the messages for all the players they reach, and send them once they
+ * are done. Every distinct message is formatted and stored only once, no matter how many
+ * players receive it, and the batch as a whole is handed to the thread the sessions live in
+ * using a single queued call, rather than one queued signal per player.
+ *
+ * Characters that are not players receive nothing from a batch.
+ */
+class MessageBatch {
+
+    public:
+        MessageBatch();
+
+        void send(Character *recipient, const QString &message, int color = Silver);
+
+        bool isEmpty() const { return m_deliveries.isEmpty(); }
+
+        int numDeliveries() const { return m_deliveries.size(); }
+        int numMessages() const { return m_messages.size(); }
+
+        /**
+         * Hands all collected messages to the sessions and empties the batch.
+         *
+         * If called from the thread the sessions live in, the messages are written right away.
+         */
+        void flush();
+
+        /**
+         * Writes all messages to their sessions. May only be called from the thread the
+         * sessions live in.
+         */
+        void deliver() const;
+
+    private:
+        struct Delivery {
+            QPointer<Session> session;
+            int messageIndex;
+        };
+
+        QVector<Delivery> m_deliveries;
+        QVector<QString> m_messages;
+
+        // maps formatted messages to their index in m_messages
+        QHash<QString, int> m_messageIndices;
+
+        // the last message given to send(), so repeated messages don't need to be formatted
+        // and looked up again
+        QString m_lastMessage;
+        int m_lastColor;
+        int m_lastMessageIndex;
+};
+
+Q_DECLARE_METATYPE(MessageBatch)
+
+
+/**
+ * Receives message batches in the thread the sessions live in.
+ *
+ * A single dispatcher should be created in that thread before any batches are flushed. Without
+ * a dispatcher, batches are delivered from the thread that flushes them.
+ */
+class MessageBatchDispatcher : public QObject {
+
+    Q_OBJECT
+
+    public:
+        MessageBatchDispatcher(QObject *parent = nullptr);
+        virtual ~MessageBatchDispatcher();
+
+        static MessageBatchDispatcher *instance() { return s_instance; }
+
+    public slots:
+        void deliver(const MessageBatch &batch);
+
+    private:
+        static MessageBatchDispatcher *s_instance;
+};
+
+#endif // MESSAGEBATCH_H
@@ -0,0 +1,123 @@
+#ifndef MPSCQUEUE_H
+#define MPSCQUEUE_H
+
+#include <atomic>
+
+#include <QtGlobal>
+
+
+/**
+ * Bounded lock-free queue for multiple producers and a single consumer.
+ *
+ * Every cell carries a sequence number that tells producers whether the cell is free and the
+ * consumer whether it has been filled, so neither side ever needs to take a lock. The capacity
+ * is rounded up to a power of two.
+ */
+template <typename T>
+class MpscQueue {
+
+    public:
+        explicit MpscQueue(int capacity) {
+
+            int size = 2;
+            while (size < capacity) {
+                size *= 2;
+            }
+
+            m_mask = size - 1;
+            m_cells = new Cell[size];
+            for (int i = 0; i < size; i++) {
+                m_cells[i].sequence.store(i, std::memory_order_relaxed);
+            }
+
+            m_enqueuePosition.store(0, std::memory_order_relaxed);
+            m_dequeuePosition = 0;
+        }
+
+        ~MpscQueue() {
+
+            delete[] m_cells;
+        }
+
+        int capacity() const { return int(m_mask + 1); }
+
+        /**
+         * May be called from any thread. Returns false if the queue is full.
+         */
+        bool enqueue(const T &value) {
+
+            quintptr position = m_enqueuePosition.load(std::memory_order_relaxed);
+            Cell *cell;
+            while (true) {
+                cell = &m_cells[position & m_mask];
+                quintptr sequence = cell->sequence.load(std::memory_order_acquire);
+                qintptr difference = qintptr(sequence) - qintptr(position);
+                if (difference == 0) {
+                    if (m_enqueuePosition.compare_exchange_weak(position, position + 1,
+                                                                std::memory_order_relaxed)) {
+                        break;
+                    }
+                } else if (difference < 0) {
+                    return false;
+                } else {
+                    position = m_enqueuePosition.load(std::memory_order_relaxed);
+                }
+            }
+
+            cell->value = value;
+            cell->sequence.store(position + 1, std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * May only be called from the consumer thread. Returns false if the queue is empty.
+         */
+        bool dequeue(T &value) {
+
+            Cell *cell = &m_cells[m_dequeuePosition & m_mask];
+            quintptr sequence = cell->sequence.load(std::memory_order_acquire);
+            if (sequence != m_dequeuePosition + 1) {
+                return false;
+            }
+
+            value = cell->value;
+            cell->sequence.store(m_dequeuePosition + m_mask + 1, std::memory_order_release);
+            m_dequeuePosition++;
+            return true;
+        }
+
+        /**
+         * May only be called from the consumer thread. The size is only approximate while
+         * producers are enqueuing.
+         */
+        int size() const {
+
+            quintptr enqueuePosition = m_enqueuePosition.load(std::memory_order_relaxed);
+            return int(qMax(enqueuePosition, m_dequeuePosition) - m_dequeuePosition);
+        }
+
+        /**
+         * May only be called from the consumer thread.
+         */
+        bool isEmpty() const {
+
+            const Cell *cell = &m_cells[m_dequeuePosition & m_mask];
+            return cell->sequence.load(std::memory_order_acquire) != m_dequeuePosition + 1;
+        }
+
+    private:
+        struct Cell {
+            std::atomic<quintptr> sequence;
+            T value;
+        };
+
+        Cell *m_cells;
+        quintptr m_mask;
+
+        alignas(64) std::atomic<quintptr> m_enqueuePosition;
+        alignas(64) quintptr m_dequeuePosition;
+
+        Q_DISABLE_COPY(MpscQueue)
+};
+
+#endif // MPSCQUEUE_H
@@ -0,0 +1,174 @@
+#include "parallelpropagator.h"
+
+#include <QRunnable>
+
+#include "gameevent.h"
+#include "room.h"
+#include "roomgraph.h"
+
+
+// the lower bits of a claim hold the key, consisting of the position of the claiming room in
+// the list of visits and the number of the edge through which it claims, offset by one so that
+// key 0 can mark rooms that have been settled already; the upper bits hold the epoch
+static const int KeyBits = 44;
+static const int EdgeBits = 16;
+static const quint64 KeyMask = (Q_UINT64_C(1) << KeyBits) - 1;
+static const quint64 MaxEpoch = (Q_UINT64_C(1) << (64 - KeyBits)) - 1;
+
+
+class ParallelPropagator::PropagateTask : public QRunnable {
+
+    public:
+        PropagateTask(ParallelPropagator *propagator, const GameEvent *event, int taskIndex,
+                      int begin, int end) :
+            QRunnable(),
+            m_propagator(propagator),
+            m_event(event),
+            m_taskIndex(taskIndex),
+            m_begin(begin),
+            m_end(end) {
+        }
+
+        virtual void run() {
+
+            m_propagator->claimRooms(m_event, m_taskIndex, m_begin, m_end);
+        }
+
+    private:
+        ParallelPropagator *m_propagator;
+        const GameEvent *m_event;
+        int m_taskIndex;
+        int m_begin;
+        int m_end;
+};
+
+
+ParallelPropagator::ParallelPropagator(RoomGraph *roomGraph) :
+    m_roomGraph(roomGraph),
+    m_claims(nullptr),
+    m_numClaims(0),
+    m_epoch(0) {
+}
+
+ParallelPropagator::~ParallelPropagator() {
+
+    m_threadPool.waitForDone();
+
+    delete[] m_claims;
+}
+
+void ParallelPropagator::setMaxThreadCount(int maxThreadCount) {
+
+    m_threadPool.setMaxThreadCount(qMax(maxThreadCount, 1));
+}
+
+const QVector<RoomVisit> &ParallelPropagator::propagate(const GameEvent *event, Room *origin,
+                                                        double strength) {
+
+    // the tasks may only read from the graph, so pending changes are applied up-front
+    m_roomGraph->update();
+
+    int numIndices = m_roomGraph->numIndices();
+    if (m_numClaims < numIndices) {
+        delete[] m_claims;
+        m_claims = new std::atomic<quint64>[numIndices];
+        m_numClaims = numIndices;
+        m_epoch = MaxEpoch; // makes sure the new claims are cleared below
+    }
+    m_epoch++;
+    if (m_epoch > MaxEpoch) {
+        for (int i = 0; i < m_numClaims; i++) {
+            m_claims[i].store(0, std::memory_order_relaxed);
+        }
+        m_epoch = 1;
+    }
+
+    m_visits.clear();
+    m_roomIndices.clear();
+    settle(origin->graphIndex(), strength);
+
+    int levelBegin = 0;
+    while (levelBegin < m_visits.size()) {
+        int levelEnd = m_visits.size();
+        int numRooms = levelEnd - levelBegin;
+        int numTasks = qBound(1, numRooms / MinRoomsPerTask, m_threadPool.maxThreadCount());
+        if (m_taskClaims.size() < numTasks) {
+            m_taskClaims.resize(numTasks);
+        }
+
+        if (numTasks == 1) {
+            claimRooms(event, 0, levelBegin, levelEnd);
+        } else {
+            for (int i = 0; i < numTasks; i++) {
+                m_threadPool.start(new PropagateTask(this, event, i,
+                                                     levelBegin + i * numRooms / numTasks,
+                                                     levelBegin + (i + 1) * numRooms / numTasks));
+            }
+            m_threadPool.waitForDone();
+        }
+
+        // the claims that were not overruled form the next level, and because every task
+        // covers a consecutive part of this level, they are already in the order of their keys
+        for (int i = 0; i < numTasks; i++) {
+            for (const Claim &claim : m_taskClaims[i]) {
+                if (m_claims[claim.roomIndex].load(std::memory_order_relaxed) == claim.value) {
+                    settle(claim.roomIndex, claim.strength);
+                }
+            }
+        }
+
+        levelBegin = levelEnd;
+    }
+
+    return m_visits;
+}
+
+void ParallelPropagator::claimRooms(const GameEvent *event, int taskIndex, int begin, int end) {
+
+    QVector<Claim> &claims = m_taskClaims[taskIndex];
+    claims.clear();
+
+    const RoomVisit *visits = m_visits.constData();
+    const int *roomIndices = m_roomIndices.constData();
+    quint64 epochBits = m_epoch << KeyBits;
+
+    Q_ASSERT(end <= (1 << (KeyBits - EdgeBits)));
+    for (int i = begin; i < end; i++) {
+        const RoomVisit &visit = visits[i];
+        RoomEdgeRange edges = m_roomGraph->edgesAt(roomIndices[i]);
+        Q_ASSERT(edges.size() < (1 << EdgeBits));
+
+        quint64 key = (quint64(i) << EdgeBits) + 1;
+        for (const RoomEdge *edge = edges.begin(); edge != edges.end(); edge++, key++) {
+            std::atomic<quint64> &slot = m_claims[edge->oppositeIndex];
+            quint64 current = slot.load(std::memory_order_relaxed);
+            if (current == epochBits) {
+                continue; // settled already
+            }
+
+            double propagatedStrength;
+            if (!event->propagatesThrough(visit.room, visit.strength, *edge,
+                                          &propagatedStrength)) {
+                continue;
+            }
+
+            quint64 value = epochBits | key;
+            while ((current & ~KeyMask) != epochBits || (current & KeyMask) > key) {
+                if (slot.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+                    Claim claim = { edge->oppositeIndex, propagatedStrength, value };
+                    claims.append(claim);
+                    break;
+                }
+            }
+        }
+    }
+}
+
+void ParallelPropagator::settle(int roomIndex, double strength) {
+
+    m_claims[roomIndex].store(m_epoch << KeyBits, std::memory_order_relaxed);
+
+    RoomVisit visit = { m_roomGraph->room(roomIndex), strength };
+    m_visits.append(visit);
+    m_roomIndices.append(roomIndex);
+}
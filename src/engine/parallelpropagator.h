@@ -0,0 +1,86 @@
+#ifndef PARALLELPROPAGATOR_H
+#define PARALLELPROPAGATOR_H
+
+#include <atomic>
+
+#include <QThreadPool>
+#include <QVector>
+
+
+class GameEvent;
+class Room;
+class RoomGraph;
+
+
+/**
+ * Room reached by a game event, with the strength the event has when entering it.
+ */
+struct RoomVisit {
+
+    Room *room;
+    double strength;
+};
+
+
+/**
+ * Determines which rooms a game event reaches, spreading the work over a pool of threads.
+ *
+ * Rooms are walked breadth-first, one level at a time. The rooms of a level are divided over
+ * tasks, which walk the edges of their rooms and claim the rooms on the other side. When a room
+ * is claimed more than once, the claim from the room that comes first in the level wins, and
+ * within that room the claim through its first edge. That way, the rooms are visited in exactly
+ * the same order and with the same strengths as when the event propagates on the game thread.
+ *
+ * The game thread waits while the tasks run, so the rooms and the room graph are only read from.
+ * Events only determine where they go this way; their side effects are applied afterwards, on
+ * the game thread.
+ */
+class ParallelPropagator {
+
+    public:
+        static const int MinRoomsPerTask = 64;
+
+        ParallelPropagator(RoomGraph *roomGraph);
+        ~ParallelPropagator();
+
+        int maxThreadCount() const { return m_threadPool.maxThreadCount(); }
+        void setMaxThreadCount(int maxThreadCount);
+
+        /**
+         * Returns the rooms reached by the given event, starting with the origin, in the order
+         * in which they should be visited. The returned list stays valid until the next call.
+         *
+         * May only be called from the game thread.
+         */
+        const QVector<RoomVisit> &propagate(const GameEvent *event, Room *origin,
+                                            double strength);
+
+    private:
+        class PropagateTask;
+
+        struct Claim {
+            int roomIndex;
+            double strength;
+            quint64 value;
+        };
+
+        RoomGraph *m_roomGraph;
+
+        QThreadPool m_threadPool;
+
+        // claims indexed by room index, combining the epoch of the propagation with a key
+        // that orders claims the way the game thread would visit the rooms
+        std::atomic<quint64> *m_claims;
+        int m_numClaims;
+        quint64 m_epoch;
+
+        QVector<RoomVisit> m_visits;
+        QVector<int> m_roomIndices;
+
+        QVector<QVector<Claim> > m_taskClaims;
+
+        void claimRooms(const GameEvent *event, int taskIndex, int begin, int end);
+        void settle(int roomIndex, double strength);
+};
+
+#endif // PARALLELPROPAGATOR_H
@@ -0,0 +1,224 @@
+#include "roomgraph.h"
+
+#include "room.h"
+
+
+static const int MinCompactionSize = 1024;
+
+
+RoomGraph::RoomGraph() :
+    m_numStaleEdges(0),
+    m_version(0) {
+}
+
+void RoomGraph::addRoom(Room *room) {
+
+    Q_ASSERT(room->m_graphIndex == -1);
+
+    int index;
+    if (m_freeIndices.isEmpty()) {
+        index = m_rooms.size();
+        m_rooms.append(room);
+        m_ranges.append(EdgeRange());
+        m_roomVersions.append(0);
+    } else {
+        index = m_freeIndices.takeLast();
+        m_rooms[index] = room;
+    }
+    room->m_graphIndex = index;
+
+    markDirty(index);
+}
+
+void RoomGraph::removeRoom(Room *room) {
+
+    int index = room->m_graphIndex;
+    if (index == -1) {
+        return;
+    }
+
+    invalidateRoom(room);
+
+    EdgeRange &range = m_ranges[index];
+    m_numStaleEdges += range.count;
+    range.count = 0;
+
+    m_rooms[index] = nullptr;
+    m_freeIndices.append(index);
+    room->m_graphIndex = -1;
+}
+
+void RoomGraph::invalidateRoom(Room *room) {
+
+    int index = room->m_graphIndex;
+    if (index == -1) {
+        return;
+    }
+
+    // the old edges are still around until the graph is updated, so they tell us which
+    // neighbours have edges pointing back to this room
+    const EdgeRange &range = m_ranges[index];
+    for (int i = range.offset; i < range.offset + range.count; i++) {
+        markDirty(m_edges[i].oppositeIndex);
+    }
+    markDirty(index);
+}
+
+void RoomGraph::updatePortal(Portal *portal) {
+
+    Room *rooms[] = { portal->room().unsafeCast<Room *>(), portal->room2().unsafeCast<Room *>() };
+    if (!rooms[0] || !rooms[1]) {
+        return;
+    }
+
+    for (Room *room : rooms) {
+        if (room->m_graphIndex == -1) {
+            continue;
+        }
+
+        touch(room->m_graphIndex);
+
+        const EdgeRange &range = m_ranges[room->m_graphIndex];
+        if (range.dirty) {
+            continue;
+        }
+
+        for (int i = range.offset; i < range.offset + range.count; i++) {
+            if (m_edges[i].portalId == portal->id()) {
+                setEdgeProperties(m_edges[i], portal);
+            }
+        }
+    }
+}
+
+void RoomGraph::updateRoom(Room *room) {
+
+    if (room->m_graphIndex != -1) {
+        touch(room->m_graphIndex);
+    }
+}
+
+RoomEdgeRange RoomGraph::edges(Room *room) {
+
+    if (!m_dirtyIndices.isEmpty()) {
+        update();
+    }
+
+    int index = room->m_graphIndex;
+    if (index == -1) {
+        return RoomEdgeRange(nullptr, nullptr);
+    }
+
+    const EdgeRange &range = m_ranges[index];
+    const RoomEdge *begin = m_edges.constData() + range.offset;
+    return RoomEdgeRange(begin, begin + range.count);
+}
+
+RoomEdgeRange RoomGraph::edgesAt(int index) const {
+
+    const EdgeRange &range = m_ranges[index];
+    const RoomEdge *begin = m_edges.constData() + range.offset;
+    return RoomEdgeRange(begin, begin + range.count);
+}
+
+void RoomGraph::update() {
+
+    for (int index : m_dirtyIndices) {
+        if (m_rooms[index]) {
+            rebuildEdges(index);
+        }
+        m_ranges[index].dirty = false;
+    }
+    m_dirtyIndices.clear();
+
+    if (m_numStaleEdges > MinCompactionSize && m_numStaleEdges > m_edges.size() / 2) {
+        compact();
+    }
+}
+
+void RoomGraph::markDirty(int index) {
+
+    EdgeRange &range = m_ranges[index];
+    if (!range.dirty) {
+        range.dirty = true;
+        m_dirtyIndices.append(index);
+    }
+
+    touch(index);
+}
+
+void RoomGraph::touch(int index) {
+
+    m_version++;
+    m_roomVersions[index] = m_version;
+}
+
+void RoomGraph::rebuildEdges(int index) {
+
+    Room *room = m_rooms[index];
+
+    EdgeRange &range = m_ranges[index];
+    m_numStaleEdges += range.count;
+    range.offset = m_edges.size();
+    range.count = 0;
+
+    for (const GameObjectPtr &portalPtr : room->portals()) {
+        Portal *portal = portalPtr.unsafeCast<Portal *>();
+        if (!portal) {
+            continue;
+        }
+
+        Room *room1 = portal->room().unsafeCast<Room *>();
+        Room *room2 = portal->room2().unsafeCast<Room *>();
+        Room *oppositeRoom = (room == room1 ? room2 : room1);
+        if (!oppositeRoom || oppositeRoom->m_graphIndex == -1) {
+            continue;
+        }
+
+        RoomEdge edge;
+        edge.oppositeRoom = oppositeRoom;
+        edge.oppositeIndex = oppositeRoom->m_graphIndex;
+        edge.portalId = portal->id();
+        edge.direction = (oppositeRoom->position() - room->position()).normalized();
+        setEdgeProperties(edge, portal);
+        m_edges.append(edge);
+        range.count++;
+    }
+}
+
+void RoomGraph::compact() {
+
+    QVector<RoomEdge> edges;
+    edges.reserve(m_edges.size() - m_numStaleEdges);
+    for (EdgeRange &range : m_ranges) {
+        int offset = edges.size();
+        for (int i = range.offset; i < range.offset + range.count; i++) {
+            edges.append(m_edges[i]);
+        }
+        range.offset = offset;
+    }
+
+    m_edges = edges;
+    m_numStaleEdges = 0;
+}
+
+void RoomGraph::setEdgeProperties(RoomEdge &edge, Portal *portal) {
+
+    edge.flags = PortalFlags::NoFlags;
+    if (portal->canSeeThrough()) {
+        edge.flags |= PortalFlags::CanSeeThrough;
+    }
+    if (portal->canHearThrough()) {
+        edge.flags |= PortalFlags::CanHearThrough;
+    }
+    if (portal->canShootThrough()) {
+        edge.flags |= PortalFlags::CanShootThrough;
+    }
+    if (portal->canPassThrough()) {
+        edge.flags |= PortalFlags::CanPassThrough;
+    }
+
+    for (int i = 0; i < GameEventType::NumValues; i++) {
+        edge.multipliers[i] = portal->eventMultiplier((GameEventType::Values) i);
+    }
+}
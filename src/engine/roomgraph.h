@@ -0,0 +1,160 @@
+#ifndef ROOMGRAPH_H
+#define ROOMGRAPH_H
+
+#include <QVector>
+
+#include "gameevent.h"
+#include "portal.h"
+#include "vector3d.h"
+
+
+class Room;
+
+
+/**
+ * Edge of the room graph, leading from a room to the room on the other side of one of its
+ * portals.
+ */
+struct RoomEdge {
+
+    Room *oppositeRoom;
+    int oppositeIndex;
+
+    uint portalId;
+
+    // normalized vector from the room to the opposite room
+    Vector3D direction;
+
+    // only the CanSeeThrough, CanHearThrough, CanShootThrough and CanPassThrough flags are set,
+    // and they already take into account whether the portal is open
+    PortalFlags flags;
+
+    // portal multipliers, including the attenuation over the distance between the rooms
+    double multipliers[GameEventType::NumValues];
+
+    bool canSeeThrough() const { return flags & PortalFlags::CanSeeThrough; }
+    bool canHearThrough() const { return flags & PortalFlags::CanHearThrough; }
+    bool canShootThrough() const { return flags & PortalFlags::CanShootThrough; }
+    bool canPassThrough() const { return flags & PortalFlags::CanPassThrough; }
+
+    double eventMultiplier(GameEventType eventType) const {
+        return multipliers[eventType.value];
+    }
+};
+
+
+class RoomEdgeRange {
+
+    public:
+        RoomEdgeRange(const RoomEdge *begin, const RoomEdge *end) :
+            m_begin(begin),
+            m_end(end) {
+        }
+
+        const RoomEdge *begin() const { return m_begin; }
+        const RoomEdge *end() const { return m_end; }
+
+        int size() const { return m_end - m_begin; }
+
+    private:
+        const RoomEdge *m_begin;
+        const RoomEdge *m_end;
+};
+
+
+/**
+ * Adjacency structure of all rooms in the realm, used for propagating game events.
+ *
+ * Every room gets a dense index, and the edges of every room are stored consecutively in a
+ * single array, so walking the neighbours of a room does not touch any portal objects.
+ *
+ * The graph is kept up-to-date incrementally: rooms whose portals change are marked dirty and
+ * their edges are rewritten at the end of the array the next time the graph is used, while
+ * changes to the flags and multipliers of a portal are patched in place. Once more than half
+ * of the array consists of outdated edges, it is compacted again.
+ *
+ * Every change that may affect what can be seen from or through a room also bumps the version
+ * of that room, so that caches derived from the graph can tell whether they are still valid.
+ *
+ * All methods may only be called from the game thread.
+ */
+class RoomGraph {
+
+    public:
+        RoomGraph();
+
+        void addRoom(Room *room);
+        void removeRoom(Room *room);
+
+        /**
+         * Marks the edges of the given room and its neighbours as outdated, for when the room
+         * gained or lost a portal or was moved.
+         */
+        void invalidateRoom(Room *room);
+
+        /**
+         * Updates the edges through the given portal after its flags or multipliers changed.
+         */
+        void updatePortal(Portal *portal);
+
+        /**
+         * Bumps the version of the given room after its flags or multipliers changed.
+         */
+        void updateRoom(Room *room);
+
+        /**
+         * Returns the edges of the given room. The range stays valid until the next call to
+         * edges() or update().
+         */
+        RoomEdgeRange edges(Room *room);
+
+        /**
+         * Returns the edges of the room with the given index, without applying pending changes
+         * first. As long as the game thread does not modify the graph, this may be called from
+         * any thread.
+         */
+        RoomEdgeRange edgesAt(int index) const;
+
+        int numIndices() const { return m_rooms.size(); }
+        Room *room(int index) const { return m_rooms[index]; }
+
+        int numEdges() const { return m_edges.size() - m_numStaleEdges; }
+
+        quint64 version() const { return m_version; }
+        quint64 roomVersion(int index) const { return m_roomVersions[index]; }
+
+        /**
+         * Rewrites the edges of all dirty rooms.
+         */
+        void update();
+
+    private:
+        struct EdgeRange {
+            int offset;
+            int count;
+            bool dirty;
+
+            EdgeRange() : offset(0), count(0), dirty(false) {}
+        };
+
+        QVector<Room *> m_rooms;
+        QVector<EdgeRange> m_ranges;
+        QVector<int> m_freeIndices;
+
+        QVector<RoomEdge> m_edges;
+        int m_numStaleEdges;
+
+        QVector<int> m_dirtyIndices;
+
+        quint64 m_version;
+        QVector<quint64> m_roomVersions;
+
+        void markDirty(int index);
+        void touch(int index);
+        void rebuildEdges(int index);
+        void compact();
+
+        static void setEdgeProperties(RoomEdge &edge, Portal *portal);
+};
+
+#endif // ROOMGRAPH_H
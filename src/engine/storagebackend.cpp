@@ -0,0 +1,115 @@
+#include "storagebackend.h"
+
+#include <QDir>
+
+#include "diskutil.h"
+#include "filestoragebackend.h"
+#include "journalstoragebackend.h"
+#include "jsonreader.h"
+#include "jsonwriter.h"
+#include "logutil.h"
+
+
+static void writeJsonProperty(JsonWriter &writer, const QString &name, const QByteArray &value,
+                              bool *first) {
+
+    if (value.isEmpty()) {
+        return;
+    }
+
+    writer.writeRaw(*first ? "  " : ",\n  ");
+    writer.writeString(name);
+    writer.writeRaw(": ", 2);
+    writer.writeRaw(value);
+    *first = false;
+}
+
+
+StorageBackend::~StorageBackend() {
+}
+
+StorageBackend *StorageBackend::create() {
+
+    QString backend = QString(qgetenv("PT_STORAGE_BACKEND")).toLower();
+    if (backend == "journal") {
+        return new JournalStorageBackend(DiskUtil::dataDir() + "/journal");
+    }
+
+    if (!backend.isEmpty() && backend != "files") {
+        LogUtil::logError("Unknown storage backend: %1\n"
+                          "Falling back to files.", backend);
+    }
+    return new FileStorageBackend(DiskUtil::dataDir());
+}
+
+QString StorageBackend::objectKey(const QString &objectType, uint id) {
+
+    return QString("%1.%2").arg(objectType.toLower()).arg(id, 9, 10, QChar('0'));
+}
+
+void StorageBackend::flush() {
+}
+
+bool StorageBackend::exportObjects(const QString &directory) {
+
+    if (!QDir(directory).exists() && !QDir().mkpath(directory)) {
+        LogUtil::logError("Could not create export directory: %1", directory);
+        return false;
+    }
+
+    bool result = true;
+    for (const QString &key : objectKeys()) {
+        QString jsonString;
+        if (!readObject(key, &jsonString) ||
+            !DiskUtil::writeFile(directory + "/" + key, jsonString)) {
+            LogUtil::logError("Could not export object: %1", key);
+            result = false;
+        }
+    }
+    return result;
+}
+
+QString StorageBackend::patchJson(const QString &jsonString,
+                                  const QMap<QString, QString> &properties) {
+
+    // the values of the properties that are kept are copied as they are, without parsing them
+    // into variants and serializing them again
+    QMap<QString, QString> remainingProperties = properties;
+    JsonWriter writer(jsonString.size() + 64 * properties.size());
+    bool first = true;
+    writer.writeRaw("{\n", 2);
+
+    JsonReader reader(jsonString);
+    if (reader.next() == JsonReader::BeginObject) {
+        while (reader.next() == JsonReader::Key) {
+            QString name = reader.string();
+            reader.next();
+            int valueOffset = reader.tokenOffset();
+            if (!reader.skipValue()) {
+                break;
+            }
+
+            auto it = remainingProperties.find(name);
+            if (it != remainingProperties.end()) {
+                writeJsonProperty(writer, name, it.value().toUtf8(), &first);
+                remainingProperties.erase(it);
+            } else {
+                writeJsonProperty(writer, name,
+                                  jsonString.midRef(valueOffset,
+                                                    reader.offset() - valueOffset).toUtf8(),
+                                  &first);
+            }
+        }
+    }
+    if (reader.hasError()) {
+        LogUtil::logError("Invalid JSON while patching object, remaining properties dropped: %1",
+                          reader.errorString());
+    }
+
+    for (auto it = remainingProperties.constBegin(); it != remainingProperties.constEnd(); ++it) {
+        writeJsonProperty(writer, it.key(), it.value().toUtf8(), &first);
+    }
+
+    writer.writeRaw("\n}", 2);
+    return writer.toString();
+}
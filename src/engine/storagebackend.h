@@ -0,0 +1,64 @@
+#ifndef STORAGEBACKEND_H
+#define STORAGEBACKEND_H
+
+#include <QDateTime>
+#include <QMap>
+#include <QStringList>
+
+
+/**
+ * Interface for the storage that game objects are loaded from and synced to.
+ *
+ * Objects are identified by keys of the form "<type>.<id>", for example "room.000000012", which
+ * is also the file name used by the per-object layout. Objects are stored as the JSON strings
+ * generated by GameObject::toJsonString().
+ *
+ * Objects are read during startup, possibly from multiple threads at once, so readObject() must
+ * be thread-safe. After that, all writes come from the sync thread.
+ */
+class StorageBackend {
+
+    public:
+        virtual ~StorageBackend();
+
+        /**
+         * Creates the backend selected through the PT_STORAGE_BACKEND environment variable.
+         * Valid values are "files" (the default) and "journal".
+         */
+        static StorageBackend *create();
+
+        static QString objectKey(const QString &objectType, uint id);
+
+        /**
+         * Returns the time at which the stored objects were last changed, which is used to
+         * determine whether a binary snapshot is still up-to-date.
+         */
+        virtual QDateTime lastModified() = 0;
+
+        virtual QStringList objectKeys() = 0;
+        virtual bool readObject(const QString &key, QString *jsonString) = 0;
+
+        virtual bool writeObject(const QString &key, const QString &jsonString) = 0;
+        virtual bool patchObject(const QString &key, const QMap<QString, QString> &properties) = 0;
+        virtual bool removeObject(const QString &key) = 0;
+
+        /**
+         * Called by the sync thread after every batch of writes, and by the realm before it
+         * writes the binary snapshot. Backends may rewrite their files here, but not after.
+         */
+        virtual void flush();
+
+        /**
+         * Writes all objects to the given directory using the per-object file layout.
+         */
+        bool exportObjects(const QString &directory);
+
+        /**
+         * Replaces the given properties in an object's JSON string. Properties with an empty
+         * value are removed, matching the behavior of GameObject::toJsonString().
+         */
+        static QString patchJson(const QString &jsonString,
+                                 const QMap<QString, QString> &properties);
+};
+
+#endif // STORAGEBACKEND_H
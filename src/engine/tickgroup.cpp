@@ -0,0 +1,52 @@
+#include "tickgroup.h"
+
+
+TickGroup::TickGroup(int id, int interval) :
+    m_id(id),
+    m_interval(interval),
+    m_timerId(0),
+    m_buckets(qBound(1, interval / 1000, 64)),
+    m_nextSubscriptionBucket(0),
+    m_nextTickBucket(0) {
+}
+
+void TickGroup::subscribe(GameObject *object) {
+
+    if (m_subscriptions.contains(object)) {
+        return;
+    }
+
+    Subscription subscription;
+    subscription.bucket = m_nextSubscriptionBucket;
+    subscription.index = m_buckets[subscription.bucket].size();
+    m_buckets[subscription.bucket].append(object);
+    m_subscriptions.insert(object, subscription);
+
+    m_nextSubscriptionBucket = (m_nextSubscriptionBucket + 1) % m_buckets.size();
+}
+
+void TickGroup::unsubscribe(GameObject *object) {
+
+    auto it = m_subscriptions.find(object);
+    if (it == m_subscriptions.end()) {
+        return;
+    }
+
+    Subscription subscription = it.value();
+    m_subscriptions.erase(it);
+
+    QVector<GameObject *> &bucket = m_buckets[subscription.bucket];
+    GameObject *last = bucket.last();
+    bucket.removeLast();
+    if (last != object) {
+        bucket[subscription.index] = last;
+        m_subscriptions[last].index = subscription.index;
+    }
+}
+
+QVector<GameObject *> TickGroup::nextBucket() {
+
+    QVector<GameObject *> bucket = m_buckets[m_nextTickBucket];
+    m_nextTickBucket = (m_nextTickBucket + 1) % m_buckets.size();
+    return bucket;
+}
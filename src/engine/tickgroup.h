@@ -0,0 +1,58 @@
+#ifndef TICKGROUP_H
+#define TICKGROUP_H
+
+#include <QHash>
+#include <QVector>
+
+
+class GameObject;
+
+/**
+ * A set of objects that share a single periodic tick.
+ *
+ * Subscribers are spread over a number of buckets, one of which is processed every time the
+ * group's timer fires, so that all subscribers are ticked once per interval without all of them
+ * being ticked at the same moment.
+ */
+class TickGroup {
+
+    public:
+        TickGroup(int id, int interval);
+
+        int id() const { return m_id; }
+        int interval() const { return m_interval; }
+
+        int numBuckets() const { return m_buckets.size(); }
+        int tickInterval() const { return m_interval / m_buckets.size(); }
+
+        int timerId() const { return m_timerId; }
+        void setTimerId(int timerId) { m_timerId = timerId; }
+
+        bool isEmpty() const { return m_subscriptions.isEmpty(); }
+        int size() const { return m_subscriptions.size(); }
+
+        bool contains(GameObject *object) const { return m_subscriptions.contains(object); }
+
+        void subscribe(GameObject *object);
+        void unsubscribe(GameObject *object);
+
+        QVector<GameObject *> nextBucket();
+
+    private:
+        struct Subscription {
+            int bucket;
+            int index;
+        };
+
+        int m_id;
+        int m_interval;
+        int m_timerId;
+
+        QHash<GameObject *, Subscription> m_subscriptions;
+        QVector<QVector<GameObject *> > m_buckets;
+
+        int m_nextSubscriptionBucket;
+        int m_nextTickBucket;
+};
+
+#endif // TICKGROUP_H
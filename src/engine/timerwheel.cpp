@@ -0,0 +1,234 @@
+#include "timerwheel.h"
+
+#include <limits>
+
+
+static inline int countTrailingZeros(quint64 value) {
+
+#ifdef __GNUC__
+    return __builtin_ctzll(value);
+#else
+    int count = 0;
+    while (!(value & 1)) {
+        value >>= 1;
+        count++;
+    }
+    return count;
+#endif
+}
+
+static inline int highestBit(quint64 value) {
+
+#ifdef __GNUC__
+    return 63 - __builtin_clzll(value);
+#else
+    int bit = -1;
+    while (value) {
+        value >>= 1;
+        bit++;
+    }
+    return bit;
+#endif
+}
+
+
+TimerWheel::TimerWheel(qint64 currentTime) :
+    m_currentTime(currentTime),
+    m_nodes(NumLists),
+    m_freeNode(-1) {
+
+    for (int i = 0; i < NumLists; i++) {
+        Node &sentinel = m_nodes[i];
+        sentinel.list = i;
+        sentinel.previous = i;
+        sentinel.next = i;
+    }
+
+    for (int i = 0; i < NumLevels; i++) {
+        m_occupiedSlots[i] = 0;
+    }
+}
+
+void TimerWheel::insert(const Timer &timer) {
+
+    Q_ASSERT(!m_nodeIndices.contains(timer.id));
+
+    int nodeIndex = allocateNode();
+    m_nodes[nodeIndex].timer = timer;
+    m_nodeIndices.insert(timer.id, nodeIndex);
+
+    place(nodeIndex);
+}
+
+bool TimerWheel::remove(int id) {
+
+    auto it = m_nodeIndices.find(id);
+    if (it == m_nodeIndices.end()) {
+        return false;
+    }
+
+    int nodeIndex = it.value();
+    m_nodeIndices.erase(it);
+
+    unlink(nodeIndex);
+
+    m_nodes[nodeIndex].next = m_freeNode;
+    m_freeNode = nodeIndex;
+    return true;
+}
+
+void TimerWheel::advance(qint64 currentTime) {
+
+    while (m_currentTime < currentTime) {
+        qint64 time = nextEventTime();
+        if (time > currentTime) {
+            m_currentTime = currentTime;
+            break;
+        }
+
+        m_currentTime = time;
+
+        const int overflowShift = NumLevels * SlotBits;
+        if ((time & ((Q_INT64_C(1) << overflowShift) - 1)) == 0) {
+            cascade(OverflowList);
+        }
+
+        for (int level = NumLevels - 1; level > 0; level--) {
+            int shift = level * SlotBits;
+            if ((time & ((Q_INT64_C(1) << shift) - 1)) == 0) {
+                cascade(level * NumSlots + ((time >> shift) & (NumSlots - 1)));
+            }
+        }
+
+        cascade(time & (NumSlots - 1));
+    }
+}
+
+bool TimerWheel::hasExpiredTimers() const {
+
+    return m_nodes.at(ExpiredList).next != ExpiredList;
+}
+
+TimerWheel::Timer TimerWheel::takeExpiredTimer() {
+
+    Q_ASSERT(hasExpiredTimers());
+
+    Timer timer = m_nodes[m_nodes[ExpiredList].next].timer;
+    remove(timer.id);
+    return timer;
+}
+
+qint64 TimerWheel::nextTimeout() const {
+
+    if (hasExpiredTimers()) {
+        return m_currentTime;
+    }
+
+    qint64 time = nextEventTime();
+    return (time == std::numeric_limits<qint64>::max() ? -1 : time);
+}
+
+int TimerWheel::allocateNode() {
+
+    if (m_freeNode == -1) {
+        m_nodes.append(Node());
+        return m_nodes.size() - 1;
+    }
+
+    int nodeIndex = m_freeNode;
+    m_freeNode = m_nodes[nodeIndex].next;
+    return nodeIndex;
+}
+
+void TimerWheel::place(int nodeIndex) {
+
+    qint64 timestamp = m_nodes[nodeIndex].timer.timestamp;
+    if (timestamp <= m_currentTime) {
+        link(nodeIndex, ExpiredList);
+        return;
+    }
+
+    int level = highestBit(quint64(timestamp ^ m_currentTime)) / SlotBits;
+    if (level >= NumLevels) {
+        link(nodeIndex, OverflowList);
+        return;
+    }
+
+    int shift = level * SlotBits;
+    link(nodeIndex, level * NumSlots + ((timestamp >> shift) & (NumSlots - 1)));
+}
+
+void TimerWheel::link(int nodeIndex, int list) {
+
+    int tail = m_nodes[list].previous;
+
+    Node &node = m_nodes[nodeIndex];
+    node.list = list;
+    node.previous = tail;
+    node.next = list;
+
+    m_nodes[tail].next = nodeIndex;
+    m_nodes[list].previous = nodeIndex;
+
+    if (list < OverflowList) {
+        m_occupiedSlots[list / NumSlots] |= Q_UINT64_C(1) << (list % NumSlots);
+    }
+}
+
+void TimerWheel::unlink(int nodeIndex) {
+
+    Node &node = m_nodes[nodeIndex];
+    m_nodes[node.previous].next = node.next;
+    m_nodes[node.next].previous = node.previous;
+
+    int list = node.list;
+    if (list < OverflowList && m_nodes[list].next == list) {
+        m_occupiedSlots[list / NumSlots] &= ~(Q_UINT64_C(1) << (list % NumSlots));
+    }
+}
+
+void TimerWheel::cascade(int list) {
+
+    int nodeIndex = m_nodes[list].next;
+    if (nodeIndex == list) {
+        return;
+    }
+
+    m_nodes[m_nodes[list].previous].next = -1;
+    m_nodes[list].previous = list;
+    m_nodes[list].next = list;
+
+    if (list < OverflowList) {
+        m_occupiedSlots[list / NumSlots] &= ~(Q_UINT64_C(1) << (list % NumSlots));
+    }
+
+    while (nodeIndex != -1) {
+        int next = m_nodes[nodeIndex].next;
+        place(nodeIndex);
+        nodeIndex = next;
+    }
+}
+
+qint64 TimerWheel::nextEventTime() const {
+
+    for (int level = 0; level < NumLevels; level++) {
+        int shift = level * SlotBits;
+        int index = (m_currentTime >> shift) & (NumSlots - 1);
+        if (index == NumSlots - 1) {
+            continue;
+        }
+
+        quint64 mask = m_occupiedSlots[level] & (~Q_UINT64_C(0) << (index + 1));
+        if (mask) {
+            qint64 blockStart = (m_currentTime >> (shift + SlotBits)) << (shift + SlotBits);
+            return blockStart + (qint64(countTrailingZeros(mask)) << shift);
+        }
+    }
+
+    if (m_nodes.at(OverflowList).next != OverflowList) {
+        const int overflowShift = NumLevels * SlotBits;
+        return ((m_currentTime >> overflowShift) + 1) << overflowShift;
+    }
+
+    return std::numeric_limits<qint64>::max();
+}
@@ -0,0 +1,78 @@
+#ifndef TIMERWHEEL_H
+#define TIMERWHEEL_H
+
+#include <QHash>
+#include <QVector>
+
+
+class GameObject;
+
+/**
+ * Hierarchical timing wheel with millisecond resolution.
+ *
+ * Timers are kept in 6 levels of 64 slots each, where a slot at level N spans 64^N milliseconds.
+ * Inserting and cancelling a timer are O(1), regardless of the number of live timers. Timers are
+ * cascaded to lower levels when the wheel advances past their slot's start, and are moved to a
+ * FIFO list of expired timers once their timestamp is reached.
+ */
+class TimerWheel {
+
+    public:
+        struct Timer {
+            int id;
+            qint64 timestamp;
+            GameObject *object;
+            int interval;
+        };
+
+        TimerWheel(qint64 currentTime);
+
+        void insert(const Timer &timer);
+        bool remove(int id);
+
+        void advance(qint64 currentTime);
+
+        bool hasExpiredTimers() const;
+        Timer takeExpiredTimer();
+
+        qint64 nextTimeout() const;
+
+        int size() const { return m_nodeIndices.size(); }
+        bool isEmpty() const { return m_nodeIndices.isEmpty(); }
+
+    private:
+        static const int NumLevels = 6;
+        static const int NumSlots = 64;
+        static const int SlotBits = 6;
+
+        static const int OverflowList = NumLevels * NumSlots;
+        static const int ExpiredList = OverflowList + 1;
+        static const int NumLists = ExpiredList + 1;
+
+        struct Node {
+            Timer timer;
+            int list;
+            int previous;
+            int next;
+        };
+
+        qint64 m_currentTime;
+
+        QVector<Node> m_nodes;
+        int m_freeNode;
+
+        quint64 m_occupiedSlots[NumLevels];
+
+        QHash<int, int> m_nodeIndices;
+
+        int allocateNode();
+
+        void place(int nodeIndex);
+        void link(int nodeIndex, int list);
+        void unlink(int nodeIndex);
+        void cascade(int list);
+
+        qint64 nextEventTime() const;
+};
+
+#endif // TIMERWHEEL_H
@@ -3,6 +3,7 @@
 #include "application.h"
 #include "engine.h"
 #include "logutil.h"
+#include "storagebackend.h"
 
 
 void signalHandler(int param) {
@@ -18,6 +19,15 @@ int main(int argc, char *argv[]) {
 
     Application application(argc, argv);
 
+    QStringList arguments = application.arguments();
+    int exportIndex = arguments.indexOf("--export");
+    if (exportIndex > 0 && exportIndex + 1 < arguments.size()) {
+        StorageBackend *storageBackend = StorageBackend::create();
+        bool exported = storageBackend->exportObjects(arguments[exportIndex + 1]);
+        delete storageBackend;
+        return exported ? 0 : 1;
+    }
+
     signal(SIGINT, signalHandler);
     signal(SIGTERM, signalHandler);
 
@@ -4,11 +4,17 @@
 
 #include "test_container.h"
 #include "test_crashes.h"
+#include "test_eventqueue.h"
 #include "test_floodevent.h"
 #include "test_help.h"
+#include "test_messagebatch.h"
+#include "test_metrics.h"
 #include "test_movement.h"
 #include "test_openandclose.h"
+#include "test_playerloading.h"
+#include "test_pointers.h"
 #include "test_serialization.h"
+#include "test_timers.h"
 #include "test_visualevents.h"
 
 
@@ -24,6 +30,12 @@ int main(int argc, char *argv[]) {
     HelpTest test6;
     OpenAndCloseTest test7;
     FloodEventTest test8;
+    TimersTest test9;
+    EventQueueTest test10;
+    PointersTest test11;
+    MetricsTest test12;
+    MessageBatchTest test13;
+    PlayerLoadingTest test14;
 
     QTest::qExec(&test1);
     QTest::qExec(&test2);
@@ -33,6 +45,12 @@ int main(int argc, char *argv[]) {
     QTest::qExec(&test6);
     QTest::qExec(&test7);
     QTest::qExec(&test8);
+    QTest::qExec(&test9);
+    QTest::qExec(&test10);
+    QTest::qExec(&test11);
+    QTest::qExec(&test12);
+    QTest::qExec(&test13);
+    QTest::qExec(&test14);
 
     return 0;
 }
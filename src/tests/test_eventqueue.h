@@ -0,0 +1,288 @@
+#ifndef TEST_EVENTQUEUE_H
+#define TEST_EVENTQUEUE_H
+
+#include "testcase.h"
+
+#include <algorithm>
+#include <atomic>
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QStringList>
+#include <QTest>
+#include <QThread>
+#include <QVector>
+
+#include "event.h"
+#include "mpscqueue.h"
+#include "realm.h"
+
+
+class LatencyEvent : public Event {
+
+    public:
+        LatencyEvent(const QElapsedTimer *timer, QVector<qint64> *latencies,
+                     std::atomic<int> *numProcessed) :
+            Event(),
+            m_timer(timer),
+            m_enqueueTime(timer->nsecsElapsed()),
+            m_latencies(latencies),
+            m_numProcessed(numProcessed) {
+        }
+
+        virtual void process() {
+
+            m_latencies->append(m_timer->nsecsElapsed() - m_enqueueTime);
+            m_numProcessed->fetch_add(1);
+        }
+
+        virtual QString toString() const {
+
+            return "Latency";
+        }
+
+    private:
+        const QElapsedTimer *m_timer;
+        qint64 m_enqueueTime;
+        QVector<qint64> *m_latencies;
+        std::atomic<int> *m_numProcessed;
+};
+
+class EventProducerThread : public QThread {
+
+    public:
+        EventProducerThread(int numEvents, const QElapsedTimer *timer, QVector<qint64> *latencies,
+                            std::atomic<int> *numProcessed) :
+            QThread(),
+            m_numEvents(numEvents),
+            m_timer(timer),
+            m_latencies(latencies),
+            m_numProcessed(numProcessed) {
+        }
+
+    protected:
+        virtual void run() {
+
+            Realm *realm = Realm::instance();
+            for (int i = 0; i < m_numEvents; i++) {
+                realm->enqueueEvent(new LatencyEvent(m_timer, m_latencies, m_numProcessed));
+                if (i % 64 == 0) {
+                    QThread::yieldCurrentThread();
+                }
+            }
+        }
+
+    private:
+        int m_numEvents;
+        const QElapsedTimer *m_timer;
+        QVector<qint64> *m_latencies;
+        std::atomic<int> *m_numProcessed;
+};
+
+class OrderEvent : public Event {
+
+    public:
+        OrderEvent(const QString &name, QStringList *order, std::atomic<int> *numProcessed) :
+            Event(),
+            m_name(name),
+            m_order(order),
+            m_numProcessed(numProcessed) {
+        }
+
+        virtual void process() {
+
+            m_order->append(m_name);
+            m_numProcessed->fetch_add(1);
+        }
+
+        virtual QString toString() const {
+
+            return "Order";
+        }
+
+    private:
+        QString m_name;
+        QStringList *m_order;
+        std::atomic<int> *m_numProcessed;
+};
+
+class RemoteEnqueueThread : public QThread {
+
+    public:
+        RemoteEnqueueThread(Event *event) :
+            QThread(),
+            m_event(event) {
+        }
+
+    protected:
+        virtual void run() {
+
+            Realm::instance()->enqueueEvent(m_event);
+        }
+
+    private:
+        Event *m_event;
+};
+
+/**
+ * Has another thread enqueue an event and waits for it, then enqueues an event from the game
+ * thread itself.
+ */
+class MixedEnqueueEvent : public Event {
+
+    public:
+        MixedEnqueueEvent(QStringList *order, std::atomic<int> *numProcessed) :
+            Event(),
+            m_order(order),
+            m_numProcessed(numProcessed) {
+        }
+
+        virtual void process() {
+
+            RemoteEnqueueThread thread(new OrderEvent("remote", m_order, m_numProcessed));
+            thread.start();
+            thread.wait();
+
+            Realm::instance()->enqueueEvent(new OrderEvent("local", m_order, m_numProcessed));
+        }
+
+        virtual QString toString() const {
+
+            return "MixedEnqueue";
+        }
+
+    private:
+        QStringList *m_order;
+        std::atomic<int> *m_numProcessed;
+};
+
+class QueueProducerThread : public QThread {
+
+    public:
+        QueueProducerThread(MpscQueue<quint32> *queue, quint32 producerId, int numValues) :
+            QThread(),
+            m_queue(queue),
+            m_producerId(producerId),
+            m_numValues(numValues) {
+        }
+
+    protected:
+        virtual void run() {
+
+            for (int i = 0; i < m_numValues; i++) {
+                while (!m_queue->enqueue((m_producerId << 24) | quint32(i))) {
+                    QThread::yieldCurrentThread();
+                }
+            }
+        }
+
+    private:
+        MpscQueue<quint32> *m_queue;
+        quint32 m_producerId;
+        int m_numValues;
+};
+
+class EventQueueTest : public TestCase {
+
+    Q_OBJECT
+
+    private slots:
+        void testMpscQueueOrdering() {
+
+            const int numProducers = 8;
+            const int numValues = 100000;
+
+            MpscQueue<quint32> queue(1024);
+            QCOMPARE(queue.capacity(), 1024);
+
+            QList<QueueProducerThread *> producers;
+            for (int i = 0; i < numProducers; i++) {
+                producers.append(new QueueProducerThread(&queue, i, numValues));
+            }
+            for (QueueProducerThread *producer : producers) {
+                producer->start();
+            }
+
+            QVector<int> nextValues(numProducers, 0);
+            int numDequeued = 0;
+            while (numDequeued < numProducers * numValues) {
+                quint32 value;
+                if (!queue.dequeue(value)) {
+                    QThread::yieldCurrentThread();
+                    continue;
+                }
+
+                int producerId = value >> 24;
+                QCOMPARE(int(value & 0xffffff), nextValues[producerId]);
+                nextValues[producerId]++;
+                numDequeued++;
+            }
+
+            for (QueueProducerThread *producer : producers) {
+                producer->wait();
+            }
+            qDeleteAll(producers);
+
+            QVERIFY(queue.isEmpty());
+        }
+
+        void testLocalAndRemoteEventOrder() {
+
+            QStringList order;
+            std::atomic<int> numProcessed(0);
+
+            Realm::instance()->enqueueEvent(new MixedEnqueueEvent(&order, &numProcessed));
+
+            for (int i = 0; i < 500 && numProcessed.load() < 2; i++) {
+                QThread::msleep(10);
+            }
+
+            QCOMPARE(numProcessed.load(), 2);
+            QCOMPARE(order, QStringList() << "remote" << "local");
+        }
+
+        void testEnqueueToProcessLatency() {
+
+            const int numProducers = 8;
+            const int numEventsPerProducer = 50000;
+            const int numEvents = numProducers * numEventsPerProducer;
+
+            QElapsedTimer timer;
+            timer.start();
+
+            QVector<qint64> latencies;
+            latencies.reserve(numEvents);
+            std::atomic<int> numProcessed(0);
+
+            QList<EventProducerThread *> producers;
+            for (int i = 0; i < numProducers; i++) {
+                producers.append(new EventProducerThread(numEventsPerProducer, &timer, &latencies,
+                                                         &numProcessed));
+            }
+
+            qint64 start = timer.nsecsElapsed();
+            for (EventProducerThread *producer : producers) {
+                producer->start();
+            }
+            for (EventProducerThread *producer : producers) {
+                producer->wait();
+            }
+            qDeleteAll(producers);
+
+            for (int i = 0; i < 1000 && numProcessed.load() < numEvents; i++) {
+                QThread::msleep(10);
+            }
+            qint64 end = timer.nsecsElapsed();
+
+            QCOMPARE(numProcessed.load(), numEvents);
+
+            std::sort(latencies.begin(), latencies.end());
+            qDebug() << "Processing" << numEvents << "events from" << numProducers << "producers took "
+                     << (end - start) / 1000000 << "ms";
+            qDebug() << "Enqueue-to-process latency: p50" << latencies[numEvents / 2] / 1000 << "us, p99"
+                     << latencies[numEvents * 99 / 100] / 1000 << "us, max"
+                     << latencies.last() / 1000 << "us";
+        }
+};
+
+#endif // TEST_EVENTQUEUE_H
@@ -11,6 +11,7 @@
 
 #include "character.h"
 #include "floodevent.h"
+#include "parallelpropagator.h"
 #include "portal.h"
 #include "realm.h"
 #include "room.h"
@@ -112,6 +113,70 @@ class FloodEventTest : public TestCase {
             QCOMPARE(event->numVisitedRooms(), 10000);
         }
 
+        void testParallelPropagation() {
+
+            Realm *realm = Realm::instance();
+            ParallelPropagator &propagator = realm->parallelPropagator();
+
+            // characters spread over the grid reveal the order in which rooms are visited
+            for (int i = 0; i < 20; i++) {
+                Character *character = new Character(realm);
+                character->setName(QString("Character %1").arg(i));
+                Room *room = m_rooms[(i * 997) % m_rooms.length()].cast<Room *>();
+                room->addCharacter(character);
+                character->setCurrentRoom(room);
+                m_characters.append(character);
+            }
+
+            Room *origin = m_rooms[m_rooms.length() / 2].cast<Room *>();
+            const double strength = -40.0;
+
+            FloodEvent *event = new FloodEvent(origin, strength);
+            int maxThreadCount = propagator.maxThreadCount();
+            propagator.setMaxThreadCount(1);
+            QVector<RoomVisit> visits = propagator.propagate(event, origin, strength);
+            propagator.setMaxThreadCount(qMax(maxThreadCount, 4));
+            const QVector<RoomVisit> &parallelVisits = propagator.propagate(event, origin,
+                                                                            strength);
+            delete event;
+
+            QVERIFY(visits.size() > 1);
+            QVERIFY(visits.size() < m_rooms.length());
+            QCOMPARE(parallelVisits.size(), visits.size());
+            for (int i = 0; i < visits.size(); i++) {
+                QCOMPARE(parallelVisits[i].room, visits[i].room);
+                QCOMPARE(parallelVisits[i].strength, visits[i].strength);
+            }
+
+            // the side effects happen in the same order as when propagating on the game thread
+            FloodEvent *serialEvent = new FloodEvent(origin, strength);
+            serialEvent->setDescription("The water is up above your waist");
+
+            qint64 start = QDateTime::currentMSecsSinceEpoch();
+            serialEvent->fire();
+            qint64 end = QDateTime::currentMSecsSinceEpoch();
+            qint64 serialTime = end - start;
+
+            FloodEvent *parallelEvent = new FloodEvent(origin, strength);
+            parallelEvent->setDescription("The water is up above your waist");
+            parallelEvent->setParallelPropagation(true);
+
+            start = QDateTime::currentMSecsSinceEpoch();
+            parallelEvent->fire();
+            end = QDateTime::currentMSecsSinceEpoch();
+            qint64 parallelTime = end - start;
+
+            qDebug() << "Flooding" << visits.size() << "rooms took" << serialTime
+                     << "ms on the game thread and" << parallelTime << "ms in parallel";
+
+            QCOMPARE(serialEvent->numVisitedRooms(), visits.size());
+            QCOMPARE(parallelEvent->numVisitedRooms(), visits.size());
+            QVERIFY(!serialEvent->affectedCharacters().isEmpty());
+            QCOMPARE(parallelEvent->affectedCharacters(), serialEvent->affectedCharacters());
+
+            propagator.setMaxThreadCount(maxThreadCount);
+        }
+
     private:
         GameObjectPtrList m_rooms;
         GameObjectPtrList m_characters;
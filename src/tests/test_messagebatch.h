@@ -0,0 +1,148 @@
+#ifndef TEST_MESSAGEBATCH_H
+#define TEST_MESSAGEBATCH_H
+
+#include "testcase.h"
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDebug>
+#include <QSignalSpy>
+#include <QTest>
+
+#include "character.h"
+#include "messagebatch.h"
+#include "player.h"
+#include "realm.h"
+#include "room.h"
+#include "session.h"
+#include "soundevent.h"
+
+
+class MessageBatchTest : public TestCase {
+
+    Q_OBJECT
+
+    private slots:
+        virtual void init() {
+
+            Realm *realm = Realm::instance();
+
+            m_room = new Room(realm);
+            m_room->setName("Auditorium");
+
+            const int numPlayers = 300;
+            for (int i = 0; i < numPlayers; i++) {
+                Player *player = new Player(realm);
+                player->setName(QString("Listener%1").arg(player->id()));
+                player->setCurrentRoom(m_room);
+
+                Session *session = new Session(realm, "Mock", "", this);
+                player->setSession(session);
+
+                m_players.append(player);
+                m_sessions.append(session);
+            }
+        }
+
+        virtual void cleanup() {
+
+            qDeleteAll(m_sessions);
+            m_sessions.clear();
+            m_players.clear();
+        }
+
+        void testSharedMessages() {
+
+            Realm *realm = Realm::instance();
+            Character *character = new Character(realm);
+
+            MessageBatch batch;
+            batch.send(m_players[0], "You hear a shout.");
+            batch.send(m_players[1], "You hear a shout.");
+            batch.send(character, "You hear a shout.");
+            batch.send(m_players[2], "You hear a distant shout.");
+            batch.send(m_players[3], "You hear a shout.");
+            QCOMPARE(batch.numDeliveries(), 4);
+            QCOMPARE(batch.numMessages(), 2);
+
+            QSignalSpy spy0(m_sessions[0], SIGNAL(write(QString)));
+            QSignalSpy spy2(m_sessions[2], SIGNAL(write(QString)));
+            batch.flush();
+            QVERIFY(batch.isEmpty());
+
+            QCOMPARE(spy0.count(), 1);
+            QCOMPARE(spy0.takeFirst()[0].toString(), QString("You hear a shout.\n"));
+            QCOMPARE(spy2.count(), 1);
+            QCOMPARE(spy2.takeFirst()[0].toString(), QString("You hear a distant shout.\n"));
+
+            // sessions that are gone by the time the batch is delivered are skipped
+            batch.send(m_players[0], "You hear a shout.");
+            batch.send(m_players[1], "You hear a shout.");
+            delete m_sessions.takeFirst();
+            QSignalSpy spy1(m_sessions[0], SIGNAL(write(QString)));
+            batch.flush();
+            QCOMPARE(spy1.count(), 1);
+        }
+
+        void testFanOut() {
+
+            const int numIterations = 100;
+            QString message = "You hear a loud shout.";
+
+            // one queued call per player
+            qint64 start = QDateTime::currentMSecsSinceEpoch();
+            for (int i = 0; i < numIterations; i++) {
+                for (Player *player : m_players) {
+                    QMetaObject::invokeMethod(player->session(), "send", Qt::QueuedConnection,
+                                              Q_ARG(QString, Player::formatMessage(message)));
+                }
+                QCoreApplication::processEvents();
+            }
+            qint64 end = QDateTime::currentMSecsSinceEpoch();
+            qint64 perPlayerTime = end - start;
+
+            // one queued call per event
+            MessageBatchDispatcher *dispatcher = MessageBatchDispatcher::instance();
+            QVERIFY(dispatcher);
+
+            start = QDateTime::currentMSecsSinceEpoch();
+            for (int i = 0; i < numIterations; i++) {
+                MessageBatch batch;
+                for (Player *player : m_players) {
+                    batch.send(player, message);
+                }
+                QMetaObject::invokeMethod(dispatcher, "deliver", Qt::QueuedConnection,
+                                          Q_ARG(MessageBatch, batch));
+                QCoreApplication::processEvents();
+            }
+            end = QDateTime::currentMSecsSinceEpoch();
+            qint64 batchTime = end - start;
+
+            qDebug() << "Sending" << numIterations << "messages to" << m_players.size()
+                     << "players took" << perPlayerTime << "ms one by one and" << batchTime
+                     << "ms in batches";
+
+            // a sound event reaches everyone in the room with a single batch
+            QSignalSpy spy(m_sessions.last(), SIGNAL(write(QString)));
+
+            start = QDateTime::currentMSecsSinceEpoch();
+            for (int i = 0; i < numIterations; i++) {
+                SoundEvent *event = new SoundEvent(m_room, 5.0);
+                event->setDescription(message);
+                event->fire();
+                QCOMPARE(event->affectedCharacters().size(), m_players.size());
+            }
+            end = QDateTime::currentMSecsSinceEpoch();
+            qDebug() << "Firing" << numIterations << "sound events took" << (end - start) << "ms";
+
+            QCOMPARE(spy.count(), numIterations);
+            QCOMPARE(spy.takeFirst()[0].toString(), Player::formatMessage(message));
+        }
+
+    private:
+        Room *m_room;
+        QList<Player *> m_players;
+        QList<Session *> m_sessions;
+};
+
+#endif // TEST_MESSAGEBATCH_H
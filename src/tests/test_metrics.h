@@ -0,0 +1,142 @@
+#ifndef TEST_METRICS_H
+#define TEST_METRICS_H
+
+#include "testcase.h"
+
+#include <QTest>
+
+#include "commandinterpreter.h"
+#include "gameobjectsyncthread.h"
+#include "gamethreadmetrics.h"
+#include "latencyhistogram.h"
+#include "player.h"
+#include "realm.h"
+#include "room.h"
+
+
+class MetricsTest : public TestCase {
+
+    Q_OBJECT
+
+    private slots:
+        void testLatencyHistogram() {
+
+            LatencyHistogram histogram;
+            QCOMPARE(histogram.count(), Q_UINT64_C(0));
+            QCOMPARE(histogram.percentile(50), Q_INT64_C(0));
+
+            for (int i = 1; i <= 1000; i++) {
+                histogram.record(i);
+            }
+            QCOMPARE(histogram.count(), Q_UINT64_C(1000));
+            QCOMPARE(histogram.max(), Q_INT64_C(1000));
+
+            // values above 64 are only accurate to within about 3%
+            QVERIFY(qAbs(histogram.percentile(50) - 500) <= 16);
+            QVERIFY(qAbs(histogram.percentile(99) - 990) <= 32);
+            QCOMPARE(histogram.percentile(100), Q_INT64_C(1000));
+
+            histogram.record(Q_INT64_C(1) << 40);
+            QCOMPARE(histogram.max(), (Q_INT64_C(1) << 32) - 1);
+            QCOMPARE(histogram.percentile(100), histogram.max());
+
+            histogram.reset();
+            QCOMPARE(histogram.count(), Q_UINT64_C(0));
+            QCOMPARE(histogram.max(), Q_INT64_C(0));
+        }
+
+        void testCommandLatencies() {
+
+            Realm *realm = Realm::instance();
+            Player *player = (Player *) realm->getPlayer("Arie");
+            CommandInterpreter *interpreter = realm->commandInterpreter();
+
+            interpreter->resetCommandLatencies();
+            player->execute("look");
+            player->execute("look");
+
+            QVERIFY(interpreter->commandLatencies().contains("look"));
+            QCOMPARE(interpreter->commandLatencies()["look"].count(), Q_UINT64_C(2));
+
+            interpreter->resetCommandLatencies();
+            QVERIFY(interpreter->commandLatencies().isEmpty());
+        }
+
+        void testGameThreadMetrics() {
+
+            GameThreadMetrics metrics;
+            QVERIFY(metrics.samples().isEmpty());
+
+            metrics.recordEvent(100, 3);
+            metrics.recordEvent(300, 1);
+            metrics.recordTimerLateness(5);
+            metrics.recordIdleTime(750000);
+            metrics.takeSample(1000, 1000000);
+
+            QCOMPARE(metrics.samples().size(), 1);
+            GameThreadSample sample = metrics.samples()[0];
+            QCOMPARE(sample.eventsPerSecond(), 2);
+            QCOMPARE(sample.utilization(), 25);
+            QCOMPARE(sample.maxQueueDepth, 3);
+            QCOMPARE(sample.averageQueueTime, Q_INT64_C(200));
+            QCOMPARE(sample.maxQueueTime, Q_INT64_C(300));
+            QCOMPARE(sample.maxTimerLateness, Q_INT64_C(5));
+
+            // the ring buffer only keeps the most recent samples
+            for (int i = 2; i <= GameThreadMetrics::NumSamples + 10; i++) {
+                metrics.recordEvent(400, 0);
+                metrics.takeSample(1000 * i, 1000000);
+            }
+            QVector<GameThreadSample> samples = metrics.samples();
+            QCOMPARE(samples.size(), (int) GameThreadMetrics::NumSamples);
+            QCOMPARE(samples.first().timestamp, Q_INT64_C(11000));
+            QCOMPARE(samples.last().timestamp,
+                     (qint64) 1000 * (GameThreadMetrics::NumSamples + 10));
+
+            GameThreadSample summary = metrics.summary(60);
+            QCOMPARE(summary.numEvents, 60);
+            QCOMPARE(summary.eventsPerSecond(), 1);
+            QCOMPARE(summary.utilization(), 100);
+            QCOMPARE(summary.averageQueueTime, Q_INT64_C(400));
+        }
+
+        void testWriteCoalescing() {
+
+            Realm *realm = Realm::instance();
+            GameObjectSyncThread &syncThread = realm->syncThread();
+
+            realm->enqueueModifiedObjects();
+            syncThread.waitForIdle();
+            quint64 numModifications = syncThread.numModifications();
+            quint64 numWrites = syncThread.numWrites();
+
+            // modifications within the sync window are written at once
+            Room *room = new Room(realm);
+            room->setName("Workshop");
+            room->setDescription("A dusty workshop.");
+            room->setDescription("A dusty workshop, full of tools.");
+            realm->enqueueModifiedObjects();
+            syncThread.waitForIdle();
+
+            QVERIFY(syncThread.numModifications() - numModifications >= 3);
+            QCOMPARE(syncThread.numWrites() - numWrites, Q_UINT64_C(1));
+
+            // as are modifications of different objects, but those need one write per object
+            Room *otherRoom = new Room(realm);
+            room->setName("Old Workshop");
+            otherRoom->setName("New Workshop");
+            otherRoom->setDescription("A shiny workshop.");
+            realm->enqueueModifiedObjects();
+            syncThread.waitForIdle();
+
+            QVERIFY(syncThread.numModifications() - numModifications >= 6);
+            QCOMPARE(syncThread.numWrites() - numWrites, Q_UINT64_C(3));
+
+            room->setDeleted();
+            otherRoom->setDeleted();
+            realm->enqueueModifiedObjects();
+            syncThread.waitForIdle();
+        }
+};
+
+#endif // TEST_METRICS_H
@@ -0,0 +1,126 @@
+#ifndef TEST_PLAYERLOADING_H
+#define TEST_PLAYERLOADING_H
+
+#include "testcase.h"
+
+#include <QTest>
+
+#include "character.h"
+#include "container.h"
+#include "item.h"
+#include "player.h"
+#include "realm.h"
+
+
+class PlayerLoadingTest : public TestCase {
+
+    Q_OBJECT
+
+    private slots:
+        void testAsyncLoad() {
+
+            Realm *realm = Realm::instance();
+
+            Player *player = new Player(realm);
+            player->setName("Bert");
+            Item *item = new Item(realm);
+            item->setName("stick");
+            player->addInventoryItem(item);
+            uint itemId = item->id();
+
+            realm->evictPlayer(player);
+            QVERIFY(!realm->getLoadedPlayer("Bert"));
+            QVERIFY(!realm->getObject(GameObjectType::Item, itemId));
+            QVERIFY(realm->hasPlayer("Bert"));
+
+            QCOMPARE(loadAsync("Bert"), QString("Bert"));
+
+            player = qobject_cast<Player *>(realm->getLoadedPlayer("Bert"));
+            QVERIFY(player);
+            QCOMPARE(player->inventory().size(), 1);
+            QVERIFY(realm->getObject(GameObjectType::Item, itemId));
+            QCOMPARE(player->inventory()[0]->name(), QString("stick"));
+
+            // players in memory and unknown players are reported from a later event as well
+            QCOMPARE(loadAsync("Bert"), QString("Bert"));
+            QCOMPARE(loadAsync("Nobody"), QString());
+        }
+
+        void testEvictAndReload() {
+
+            Realm *realm = Realm::instance();
+
+            Player *player = new Player(realm);
+            player->setName("Carl");
+            Container *bag = new Container(realm);
+            bag->setName("bag");
+            player->addInventoryItem(bag);
+            Item *coin = new Item(realm);
+            coin->setName("coin");
+            bag->addItem(coin);
+            Item *sword = new Item(realm);
+            sword->setName("sword");
+            player->addInventoryItem(sword);
+            player->setWeapon(sword);
+            uint playerId = player->id(), bagId = bag->id(), coinId = coin->id(),
+                 swordId = sword->id();
+
+            // an object that is not evicted pointing to an item that is
+            Character *merchant = new Character(realm);
+            merchant->setName("merchant");
+            merchant->addSellableItem(sword);
+
+            for (int i = 0; i < 2; i++) {
+                realm->evictPlayer(player);
+                QVERIFY(!realm->getLoadedPlayer("Carl"));
+                for (uint id : QList<uint>() << playerId << bagId << coinId << swordId) {
+                    QVERIFY(!realm->getObject(GameObjectType::Unknown, id));
+                    QVERIFY(realm->isUnloaded(id));
+                }
+
+                // the pointer keeps referring to the sword, but is not resolved
+                QCOMPARE(merchant->sellableItems().size(), 1);
+                QCOMPARE(merchant->sellableItems()[0].id(), swordId);
+                QVERIFY(!merchant->sellableItems()[0].unsafeCast<GameObject *>());
+
+                player = qobject_cast<Player *>(realm->getPlayer("Carl"));
+                QVERIFY(player);
+                QCOMPARE(player->id(), playerId);
+                QVERIFY(!realm->isUnloaded(playerId));
+                QCOMPARE(player->inventory().size(), 2);
+                QCOMPARE(player->weapon()->name(), QString("sword"));
+                QCOMPARE(player->weapon()->id(), swordId);
+
+                bag = qobject_cast<Container *>(realm->getObject(GameObjectType::Container,
+                                                                 bagId));
+                QVERIFY(bag);
+                QCOMPARE(bag->items().size(), 1);
+                QCOMPARE(bag->items()[0]->name(), QString("coin"));
+
+                // the pointer is resolved again to the newly loaded sword
+                QCOMPARE(merchant->sellableItems()[0].unsafeCast<GameObject *>(),
+                         realm->getObject(GameObjectType::Item, swordId));
+            }
+        }
+
+    private:
+        QString loadAsync(const QString &name) {
+
+            evaluate("asyncResult = undefined;"
+                     "Realm.getPlayerAsync('" + name + "', function(player) {"
+                     "    asyncResult = (player ? player.name : '');"
+                     "});");
+
+            int waitTimeMs = 0;
+            while (evaluate("asyncResult === undefined").toBool()) {
+                QTest::qWait(20);
+                waitTimeMs += 20;
+                if (waitTimeMs >= 5000) {
+                    return "(timeout)";
+                }
+            }
+            return evaluate("asyncResult").toString();
+        }
+};
+
+#endif // TEST_PLAYERLOADING_H
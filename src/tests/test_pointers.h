@@ -0,0 +1,248 @@
+#ifndef TEST_POINTERS_H
+#define TEST_POINTERS_H
+
+#include "testcase.h"
+
+#include <QDateTime>
+#include <QDebug>
+#include <QList>
+#include <QTest>
+
+#include "character.h"
+#include "gameexception.h"
+#include "realm.h"
+#include "room.h"
+
+
+class PointersTest : public TestCase {
+
+    Q_OBJECT
+
+    private slots:
+        virtual void init() {
+
+            Realm *realm = Realm::instance();
+
+            m_room = new Room(realm);
+            for (int i = 0; i < 1000; i++) {
+                Character *character = new Character(realm);
+                character->setName(QString("Character %1").arg(i));
+                m_room->addCharacter(character);
+                character->setCurrentRoom(m_room);
+            }
+        }
+
+        virtual void cleanup() {
+
+            for (const GameObjectPtr &character : m_room->characters()) {
+                character->setDeleted();
+            }
+            m_room->setCharacters(GameObjectPtrList());
+        }
+
+        void testCopyCharacters() {
+
+            QCOMPARE(m_room->characters().length(), 1000);
+
+            {
+                qint64 start = QDateTime::currentMSecsSinceEpoch();
+
+                int numCharacters = 0;
+                for (int i = 0; i < 1000; i++) {
+                    GameObjectPtrList characters = m_room->characters();
+                    numCharacters += characters.length();
+                }
+
+                qint64 end = QDateTime::currentMSecsSinceEpoch();
+                qDebug() << "Copying characters 1000 times took " << (end - start) << "ms";
+
+                QCOMPARE(numCharacters, 1000 * 1000);
+            }
+
+            {
+                qint64 start = QDateTime::currentMSecsSinceEpoch();
+
+                QList<GameObjectPtrList> copies;
+                for (int i = 0; i < 100; i++) {
+                    copies.append(m_room->characters());
+                }
+                while (!copies.isEmpty()) {
+                    copies.removeFirst();
+                }
+
+                qint64 end = QDateTime::currentMSecsSinceEpoch();
+                qDebug() << "Keeping 100 copies of characters alive took " << (end - start) << "ms";
+            }
+        }
+
+        void testLargeLists() {
+
+            GameObjectPtrList characters = m_room->characters();
+
+            GameObjectPtrList list;
+            {
+                qint64 start = QDateTime::currentMSecsSinceEpoch();
+
+                for (int i = 0; i < 10; i++) {
+                    for (const GameObjectPtr &character : characters) {
+                        list.append(character);
+                    }
+                }
+
+                qint64 end = QDateTime::currentMSecsSinceEpoch();
+                qDebug() << "Appending 10000 items took " << (end - start) << "ms";
+            }
+
+            QCOMPARE(list.length(), 10000);
+
+            {
+                qint64 start = QDateTime::currentMSecsSinceEpoch();
+
+                int numMatches = 0;
+                for (int i = 0; i < list.length(); i++) {
+                    if (list[i] == characters[i % 1000]) {
+                        numMatches++;
+                    }
+                }
+
+                qint64 end = QDateTime::currentMSecsSinceEpoch();
+                qDebug() << "Indexing 10000 items took " << (end - start) << "ms";
+
+                QCOMPARE(numMatches, 10000);
+            }
+
+            {
+                qint64 start = QDateTime::currentMSecsSinceEpoch();
+
+                for (int i = 0; i < 100; i++) {
+                    GameObjectPtrList copy = list;
+                    QCOMPARE(copy.length(), 10000);
+                }
+
+                qint64 end = QDateTime::currentMSecsSinceEpoch();
+                qDebug() << "Copying 10000 items 100 times took " << (end - start) << "ms";
+            }
+
+            {
+                qint64 start = QDateTime::currentMSecsSinceEpoch();
+
+                for (int i = 0; i < 1000; i++) {
+                    list.removeAt(0);
+                }
+
+                qint64 end = QDateTime::currentMSecsSinceEpoch();
+                qDebug() << "Removing 1000 items from the front took " << (end - start) << "ms";
+            }
+
+            QCOMPARE(list.length(), 9000);
+            QVERIFY(list.first() == characters.first());
+            QVERIFY(list.last() == characters.last());
+        }
+
+        void testPointersAreClearedOnDelete() {
+
+            Realm *realm = Realm::instance();
+
+            Character *character = new Character(realm);
+
+            GameObjectPtrList list;
+            list.append(character);
+            list.append(m_room->characters().first());
+            list.append(character);
+
+            delete character;
+
+            QCOMPARE(list.length(), 1);
+            QVERIFY(list.first() == m_room->characters().first());
+        }
+
+        void testPointersAreRelocated() {
+
+            Realm *realm = Realm::instance();
+
+            Character *first = new Character(realm);
+            Character *second = new Character(realm);
+
+            // neighbouring items that point to the same object are also neighbours in the
+            // object's list of pointers
+            GameObjectPtrList list;
+            for (int i = 0; i < 10; i++) {
+                list.append(i % 3 == 0 ? first : second);
+            }
+            list.removeAt(0);
+            list.removeAt(4);
+            list.reserve(1000);
+            QCOMPARE(list.length(), 8);
+
+            GameObjectPtrList copy = list;
+            copy.removeAt(1);
+
+            delete second;
+
+            QCOMPARE(list.length(), 3);
+            QVERIFY(list[0] == first);
+            QVERIFY(list[2] == first);
+            QCOMPARE(copy.length(), 3);
+
+            delete first;
+
+            QVERIFY(list.isEmpty());
+            QVERIFY(copy.isEmpty());
+        }
+
+        void testObjectLookup() {
+
+            Realm *realm = Realm::instance();
+
+            Character *character = new Character(realm);
+            uint id = character->id();
+            QVERIFY(id > 0);
+
+            QVERIFY(realm->getObject(GameObjectType::Character, id) == character);
+            QVERIFY(realm->getObject(GameObjectType::Unknown, id) == character);
+            QVERIFY(realm->getObject("Character", id) == character);
+            QVERIFY(realm->getObject(GameObjectType::Room, id) == nullptr);
+            QVERIFY(realm->getObject(GameObjectType::Unknown, 0) == realm);
+
+            // IDs are not handed out again, so a stale ID cannot resolve to another object
+            delete character;
+            QVERIFY(realm->getObject(GameObjectType::Character, id) == nullptr);
+
+            Character *other = new Character(realm);
+            QVERIFY(other->id() > id);
+            QVERIFY(realm->getObject(GameObjectType::Character, id) == nullptr);
+            QVERIFY(realm->getObject(GameObjectType::Character, other->id()) == other);
+            delete other;
+
+            QVERIFY(realm->getObject(GameObjectType::Unknown, Realm::MaxObjectId) == nullptr);
+            QVERIFY(realm->getObject(GameObjectType::Unknown, 0xffffffff) == nullptr);
+
+            // IDs beyond the object table are looked up in a hash, without growing the table
+            Character *distant = new Character(realm, 0x7fffffff);
+            QVERIFY(realm->getObject(GameObjectType::Character, 0x7fffffff) == distant);
+            QVERIFY(realm->getObject(GameObjectType::Room, 0x7fffffff) == nullptr);
+            other = new Character(realm);
+            QCOMPARE(other->id(), (uint) 0x80000000);
+            QVERIFY(realm->getObject(GameObjectType::Character, other->id()) == other);
+            delete other;
+            delete distant;
+            QVERIFY(realm->getObject(GameObjectType::Character, 0x7fffffff) == nullptr);
+
+            int numObjects = realm->numObjects(GameObjectType::Unknown);
+            bool thrown = false;
+            try {
+                new Character(realm, Realm::MaxObjectId + 1);
+            } catch (GameException &exception) {
+                QCOMPARE(exception.cause(), GameException::InvalidObjectId);
+                thrown = true;
+            }
+            QVERIFY(thrown);
+            QCOMPARE(realm->numObjects(GameObjectType::Unknown), numObjects);
+            QVERIFY(realm->getObject(GameObjectType::Unknown, Realm::MaxObjectId + 1) == nullptr);
+        }
+
+    private:
+        Room *m_room;
+};
+
+#endif // TEST_POINTERS_H
@@ -3,12 +3,26 @@
 
 #include "testcase.h"
 
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
 #include <QFile>
+#include <QFileInfo>
 #include <QTest>
 
+#include "binarysnapshot.h"
 #include "characterstats.h"
+#include "container.h"
 #include "diskutil.h"
+#include "gameobjectsnapshot.h"
+#include "item.h"
+#include "journalstoragebackend.h"
+#include "jsonreader.h"
+#include "jsonwriter.h"
+#include "portal.h"
 #include "realm.h"
+#include "room.h"
+#include "storagebackend.h"
 
 
 class SerializationTest : public TestCase {
@@ -107,6 +121,559 @@ class SerializationTest : public TestCase {
                 "}"));
             }
         }
+
+        void testBinarySnapshot() {
+
+            QString path = QDir::temp().filePath("plaintext-test.snapshot");
+
+            BinarySnapshotWriter writer;
+            writer.addObject("Room", 12, "{\n"
+                "  \"name\": \"Room \\\"C\\\"\\nline\",\n"
+                "  \"position\": [ 0, 50, 0 ],\n"
+                "  \"weight\": 3,\n"
+                "  \"cost\": 1.5,\n"
+                "  \"admin\": true\n"
+            "}");
+            writer.addObject("Item", 13, "{ \"name\": \"key\" }");
+            QVERIFY(writer.write(path));
+
+            BinarySnapshotReader reader(path);
+            QVERIFY(reader.open());
+            QCOMPARE(reader.numObjects(), 2);
+            QCOMPARE(reader.objectKey(0), QString("item.000000013"));
+            QCOMPARE(reader.indexOf("Room", 12), 1);
+            QCOMPARE(reader.indexOf("Room", 13), -1);
+
+            QCOMPARE(reader.objectJson(0), QString("{ \"name\": \"key\" }"));
+            QVERIFY(reader.objectJson(1).isEmpty());
+
+            QMap<QString, QString> jsonProperties;
+            QVariantMap properties = reader.objectProperties(1, &jsonProperties);
+            QCOMPARE(properties["name"].toString(), QString("Room \"C\"\nline"));
+            QCOMPARE(properties["weight"].toInt(), 3);
+            QCOMPARE(properties["cost"].toDouble(), 1.5);
+            QCOMPARE(properties["admin"].toBool(), true);
+            QCOMPARE(jsonProperties.size(), 1);
+            QCOMPARE(jsonProperties["position"], QString("[ 0, 50, 0 ]"));
+
+            QFile::remove(path);
+        }
+
+        void testJournalRecovery() {
+
+            QString directory = QDir::temp().filePath("plaintext-journal-test");
+            QDir(directory).removeRecursively();
+
+            {
+                JournalStorageBackend journal(directory);
+                journal.writeObject("room.000000100", "{\n"
+                    "  \"name\": \"Room C\",\n"
+                    "  \"type\": \"Room\"\n"
+                "}");
+                journal.writeObject("item.000000101", "{\n"
+                    "  \"name\": \"key\"\n"
+                "}");
+
+                QMap<QString, QString> properties;
+                properties["name"] = "\"Hall\"";
+                properties["flags"] = "\"Dark\"";
+                QVERIFY(journal.patchObject("room.000000100", properties));
+                QVERIFY(journal.removeObject("item.000000101"));
+                journal.flush();
+            }
+
+            // simulate a crash in the middle of appending a record
+            {
+                QFile file(directory + "/journal");
+                QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Append));
+                file.write(QByteArray("\x00\x00\x01\x00\x12\x34", 6));
+            }
+
+            JournalStorageBackend journal(directory);
+            QVERIFY(journal.objectKeys().contains("room.000000100"));
+            QVERIFY(!journal.objectKeys().contains("item.000000101"));
+
+            QString jsonString;
+            QVERIFY(journal.readObject("room.000000100", &jsonString));
+            QCOMPARE(jsonString, QString("{\n"
+                "  \"name\": \"Hall\",\n"
+                "  \"type\": \"Room\",\n"
+                "  \"flags\": \"Dark\"\n"
+            "}"));
+
+            QCOMPARE(QFile(directory + "/journal").size(), (qint64) 0);
+
+            QDir(directory).removeRecursively();
+        }
+
+        void testJsonWriter() {
+
+            JsonWriter writer;
+            writer.writeString(QString::fromUtf8("a \"b\"\\\n\xc3\xa9\xe2\x82\xac\xf0\x9f\x98\x80"));
+            QCOMPARE(writer.data(),
+                     QByteArray("\"a \\\"b\\\"\\\\\\n\xc3\xa9\xe2\x82\xac\xf0\x9f\x98\x80\""));
+
+            QVariantMap map;
+            map["empty"] = QString();
+            map["number"] = 1.5;
+            map["list"] = QVariantList() << 1 << "two" << false;
+
+            writer.clear();
+            QVERIFY(writer.writeVariant(map, IncludeTypeInfo));
+            QCOMPARE(writer.toString(), QString("{ "
+                "\"list\": [ 9, 9, [ 1, \"two\", false ] ], "
+                "\"number\": [ 6, 6, 1.5 ] "
+            "}"));
+
+            writer.clear();
+            QVERIFY(!writer.writeVariant(QVariantMap()));
+            QVERIFY(!writer.writeVariant(QString()));
+            QVERIFY(writer.isEmpty());
+
+            writer.writeInt(-1234567890123LL);
+            QCOMPARE(writer.data(), QByteArray("-1234567890123"));
+        }
+
+        void benchmarkJsonSerialization() {
+
+            Realm *realm = Realm::instance();
+
+            // copies are neither registered nor synced
+            QVector<GameObject *> objects;
+            for (int i = 0; i < 1000; i++) {
+                Item *item = qobject_cast<Item *>(
+                        GameObject::createByObjectType(realm, GameObjectType::Item, 10000 + i,
+                                                       Copy));
+                item->setName(QString("item %1").arg(i));
+                item->setDescription("A plain item, used for benchmarking serialization.");
+                item->setPosition(Point3D(i, -i, 0));
+                item->setWeight(i / 10.0);
+                item->setCost(i);
+                objects.append(item);
+            }
+
+            QCOMPARE(objects[1]->toJsonString(SkipId), QString("{\n"
+                "  \"name\": \"item 1\",\n"
+                "  \"plural\": \"item 1s\",\n"
+                "  \"indefiniteArticle\": \"an\",\n"
+                "  \"description\": \"A plain item, used for benchmarking serialization.\",\n"
+                "  \"position\": [ 1, -1, 0 ],\n"
+                "  \"weight\": 0.1,\n"
+                "  \"cost\": 1,\n"
+                "  \"flags\": \"\"\n"
+            "}"));
+
+            // serializes 100,000 objects per iteration
+            JsonWriter writer;
+            QBENCHMARK {
+                for (int i = 0; i < 100; i++) {
+                    for (GameObject *object : objects) {
+                        writer.clear();
+                        object->writeJson(writer, (Options) (SkipId | IncludeTypeInfo));
+                    }
+                }
+            }
+
+            qDeleteAll(objects);
+        }
+
+        void testJsonReader() {
+
+            JsonReader reader("{ \"name\": \"a \\\"b\\\"\\n\\u00e9\\ud83d\\ude00\", "
+                              "\"list\": [ 1, -2.5, 3e2, 12345678901, TRUE, null ] }");
+            QCOMPARE(reader.next(), JsonReader::BeginObject);
+            QCOMPARE(reader.next(), JsonReader::Key);
+            QCOMPARE(reader.string(), QString("name"));
+            QCOMPARE(reader.next(), JsonReader::String);
+            QCOMPARE(reader.string(), QString::fromUtf8("a \"b\"\n\xc3\xa9\xf0\x9f\x98\x80"));
+            QCOMPARE(reader.next(), JsonReader::Key);
+            QCOMPARE(reader.next(), JsonReader::BeginArray);
+            QCOMPARE(reader.next(), JsonReader::Number);
+            QCOMPARE(reader.numberValue().type(), QVariant::Int);
+            QCOMPARE(reader.next(), JsonReader::Number);
+            QCOMPARE(reader.numberValue().toDouble(), -2.5);
+            QCOMPARE(reader.next(), JsonReader::Number);
+            QCOMPARE(reader.numberValue().toDouble(), 300.0);
+            QCOMPARE(reader.next(), JsonReader::Number);
+            QCOMPARE(reader.numberValue().toLongLong(), 12345678901LL);
+            QCOMPARE(reader.next(), JsonReader::Bool);
+            QCOMPARE(reader.boolValue(), true);
+            QCOMPARE(reader.next(), JsonReader::Null);
+            QCOMPARE(reader.next(), JsonReader::EndArray);
+            QCOMPARE(reader.next(), JsonReader::EndObject);
+            QCOMPARE(reader.next(), JsonReader::End);
+
+            bool ok;
+            QVariantMap map = JsonReader::parse("{ \"a\": { \"b\": [ ] }, \"c\": \"\" }",
+                                                &ok).toMap();
+            QVERIFY(ok);
+            QCOMPARE(map.keys(), QStringList() << "a" << "c");
+            QVERIFY(map["a"].toMap()["b"].toList().isEmpty());
+
+            QVERIFY(JsonReader::parse(" ", &ok).isNull());
+            QVERIFY(ok);
+
+            QStringList invalidDocuments;
+            invalidDocuments << "\"top-level string\"" << "{ \"a\": 1, }" << "{ \"a\" 1 }"
+                             << "[ 1 2 ]" << "{ \"a\": \"unterminated }" << "[ \"\\x\" ]"
+                             << "[ \"\\u12\" ]" << "[ 1. ]" << "[ - ]" << "[ nul ]" << "{ } }"
+                             << QString(1000, '[');
+            for (const QString &document : invalidDocuments) {
+                QVERIFY(JsonReader::parse(document, &ok).isNull());
+                QVERIFY2(!ok, qPrintable(document));
+            }
+
+            GameObjectPtr pointer;
+            QString string = "portal:3";
+            GameObjectPtr::fromJsonString(QStringRef(&string), pointer);
+            QCOMPARE(pointer.toString(), QString("portal:3"));
+
+            GameObjectPtr nullPointer;
+            string = "0";
+            GameObjectPtr::fromJsonString(QStringRef(&string), nullPointer);
+            QVERIFY(nullPointer.isNull());
+
+            bool thrown = false;
+            try {
+                string = "room:3:4";
+                GameObjectPtr::fromJsonString(QStringRef(&string), pointer);
+            } catch (const GameException &exception) {
+                Q_UNUSED(exception)
+                thrown = true;
+            }
+            QVERIFY(thrown);
+        }
+
+        void testJsonReaderFuzz() {
+
+            // documents that the reader should accept, which are then truncated and mutated
+            QStringList documents;
+            documents << "{\n"
+                "  \"name\": \"item \\\"1\\\"\",\n"
+                "  \"position\": [ 1, -1, 0 ],\n"
+                "  \"weight\": 0.1,\n"
+                "  \"cost\": 1e1,\n"
+                "  \"flags\": \"\",\n"
+                "  \"eventMultipliers\": { \"Sound\": 0.5 },\n"
+                "  \"container\": \"room:1\",\n"
+                "  \"hidden\": false,\n"
+                "  \"extra\": [ null, true, \"\\u00e9\" ]\n"
+            "}";
+            documents << "[ { \"a\": [ 1, 2.5, \"\\/\" ] }, { }, [ ] ]";
+
+            const char alphabet[] = "{}[]:,\"\\/ 0-.eEtfnu\n";
+            Realm *realm = Realm::instance();
+            Item *item = qobject_cast<Item *>(
+                    GameObject::createByObjectType(realm, GameObjectType::Item, 20000, Copy));
+
+            qsrand(42);
+            int numRejected = 0;
+            for (const QString &document : documents) {
+                bool ok;
+                JsonReader::parse(document, &ok);
+                QVERIFY(ok);
+
+                QStringList inputs;
+                for (int i = 1; i < document.length(); i++) {
+                    inputs << document.left(i);
+                    JsonReader::parse(inputs.last(), &ok);
+                    QVERIFY(!ok);
+                }
+                for (int i = 0; i < 200; i++) {
+                    QString input = document;
+                    for (int j = 1 + qrand() % 3; j > 0; j--) {
+                        int position = qrand() % (input.length() + 1);
+                        QChar character = QLatin1Char(alphabet[qrand() % (sizeof(alphabet) - 1)]);
+                        switch (qrand() % 3) {
+                            case 0: input.insert(position, character); break;
+                            case 1: input.remove(position, 1); break;
+                            default: input.replace(position, 1, character); break;
+                        }
+                    }
+                    inputs << input;
+                }
+
+                for (const QString &input : inputs) {
+                    QVariant result = JsonReader::parse(input, &ok);
+                    if (!ok) {
+                        QVERIFY(result.isNull());
+                        numRejected++;
+                    }
+
+                    JsonReader reader(input);
+                    int numTokens = 0;
+                    while (reader.next() != JsonReader::End && !reader.hasError()) {
+                        QVERIFY(++numTokens <= input.length());
+                    }
+                    QCOMPARE(reader.hasError(), !ok);
+
+                    try {
+                        item->loadJson(input);
+                        QVERIFY(ok);
+                    } catch (const GameException &exception) {
+                        Q_UNUSED(exception)
+                    }
+                }
+            }
+            QVERIFY(numRejected > 0);
+
+            delete item;
+        }
+
+        void benchmarkJsonParsing() {
+
+            QString directory = QFINDTESTDATA("../../data");
+            if (directory.isEmpty()) {
+                QSKIP("Data directory not found");
+            }
+
+            QStringList documents;
+            for (const QFileInfo &fileInfo : QDir(directory).entryInfoList(QDir::Files)) {
+                QFile file(fileInfo.filePath());
+                QVERIFY(file.open(QIODevice::ReadOnly));
+                documents << QString::fromUtf8(file.readAll());
+            }
+            QVERIFY(!documents.isEmpty());
+
+            int numCharacters = 0;
+            for (const QString &document : documents) {
+                bool ok;
+                JsonReader::parse(document, &ok);
+                QVERIFY2(ok, "All objects in the data directory should be accepted");
+                numCharacters += document.length();
+            }
+            qDebug() << "Parsing" << documents.size() << "objects (" << numCharacters
+                     << "characters) per iteration";
+
+            QBENCHMARK {
+                for (const QString &document : documents) {
+                    JsonReader::parse(document);
+                }
+            }
+        }
+
+        void testStoredProperties() {
+
+            Realm *realm = Realm::instance();
+            Portal *portal = qobject_cast<Portal *>(
+                    GameObject::createByObjectType(realm, GameObjectType::Portal, 20001, Copy));
+
+            const QVector<QMetaProperty> &properties = portal->storedMetaProperties();
+            int index = portal->storedPropertyIndex("room2");
+            QVERIFY(index > -1);
+            QCOMPARE(QString(properties[index].name()), QString("room2"));
+            QCOMPARE(portal->storedPropertyIndex("id"), -1);
+
+            portal->loadJson("{ \"name\": \"door\", \"room\": \"room:1\", "
+                               "\"room2\": \"room:2\" }");
+            portal->resolvePointers();
+            QCOMPARE(portal->room()->id(), (unsigned) 1);
+            QCOMPARE(portal->room2().cast<Room *>()->name(), QString("Room B"));
+            QVERIFY(portal->toJsonString(SkipId).contains("\"room2\": \"room:2\""));
+
+            delete portal;
+        }
+
+        void testCopy() {
+
+            Realm *realm = Realm::instance();
+            Portal *portal = new Portal(realm);
+            portal->loadJson("{ \"name\": \"gate\", \"description\": \"A heavy gate.\", "
+                               "\"room\": \"room:1\", \"room2\": \"room:2\" }");
+            portal->resolvePointers();
+
+            Portal *copy = qobject_cast<Portal *>(portal->copy());
+            QVERIFY(copy);
+            QVERIFY(copy->id() != portal->id());
+            QCOMPARE(copy->name(), QString("gate"));
+            QCOMPARE(copy->description(), QString("A heavy gate."));
+            QCOMPARE(copy->room2().cast<Room *>()->name(), QString("Room B"));
+            QCOMPARE(copy->toJsonString(SkipId), portal->toJsonString(SkipId));
+
+            copy->setDeleted();
+            portal->setDeleted();
+        }
+
+        void testSnapshot() {
+
+            Realm *realm = Realm::instance();
+            Room *room = (Room *) realm->getObject(GameObjectType::Room, 2);
+            int index = room->storedPropertyIndex("name");
+            QString name = room->name();
+
+            room->setName("Room C");
+            GameObjectSnapshot snapshot = room->snapshot();
+            QCOMPARE(snapshot.id, (unsigned) 2);
+            QVERIFY(snapshot.modifiedProperties & (Q_UINT64_C(1) << index));
+            QCOMPARE(snapshot.values[index].toString(), QString("Room C"));
+
+            // later modifications don't affect the snapshot
+            room->setName(name);
+            QCOMPARE(snapshot.values[index].toString(), QString("Room C"));
+            QCOMPARE(room->name(), name);
+        }
+
+        void testSnapshotPointerList() {
+
+            Realm *realm = Realm::instance();
+            Container *container = new Container(realm);
+            container->setName("chest");
+            const int numItems = 10000;
+            QList<Item *> items;
+            for (int i = 0; i < numItems; i++) {
+                Item *item = new Item(realm);
+                item->setName("coin");
+                container->addItem(item);
+                items.append(item);
+            }
+            int index = container->storedPropertyIndex("items");
+
+            // how snapshots used to copy the list, registering and unregistering every pointer
+            QElapsedTimer timer;
+            timer.start();
+            GameObjectPtrList copy = container->items();
+            copy.unresolvePointers();
+            qint64 copyTime = timer.nsecsElapsed();
+
+            timer.restart();
+            GameObjectSnapshot snapshot = container->snapshot();
+            qint64 snapshotTime = timer.nsecsElapsed();
+
+            qDebug() << "Snapshot of" << numItems << "pointers took" << snapshotTime / 1000
+                     << "us, copying and unresolving them took" << copyTime / 1000 << "us";
+
+            GameObjectPtrList list = snapshot.values[index].value<GameObjectPtrList>();
+            QCOMPARE(list.size(), numItems);
+            for (int i = 0; i < numItems; i++) {
+                QCOMPARE(list[i].id(), items[i]->id());
+                QVERIFY(!list[i].unsafeCast<GameObject *>());
+            }
+            QCOMPARE(GameObjectPtrList::toJsonString(list),
+                     GameObjectPtrList::toJsonString(container->items()));
+
+            for (int i = numItems - 1; i >= 0; i--) {
+                items[i]->setDeleted();
+            }
+            container->setDeleted();
+        }
+
+        void testModifiedProperties() {
+
+            Realm *realm = Realm::instance();
+            Room *room = (Room *) realm->getObject(GameObjectType::Room, 2);
+            int nameIndex = room->storedPropertyIndex("name");
+            int descriptionIndex = room->storedPropertyIndex("description");
+            QString name = room->name();
+            QString description = room->description();
+
+            realm->enqueueModifiedObjects();
+            realm->syncThread().waitForIdle();
+            QCOMPARE(room->snapshot().modifiedProperties, Q_UINT64_C(0));
+
+            room->setName("Room C");
+            QCOMPARE(room->snapshot().modifiedProperties, Q_UINT64_C(1) << nameIndex);
+
+            room->setDescription("A room with a view.");
+            GameObjectSnapshot snapshot = room->snapshot();
+            QCOMPARE(snapshot.modifiedProperties,
+                     (Q_UINT64_C(1) << nameIndex) | (Q_UINT64_C(1) << descriptionIndex));
+            for (int i = 0; i < snapshot.values.size(); i++) {
+                QCOMPARE(snapshot.values[i].isValid(), i == nameIndex || i == descriptionIndex);
+            }
+
+            // syncing clears the modifications
+            realm->enqueueModifiedObjects();
+            QCOMPARE(room->snapshot().modifiedProperties, Q_UINT64_C(0));
+
+            room->setName(name);
+            room->setDescription(description);
+            realm->enqueueModifiedObjects();
+            realm->syncThread().waitForIdle();
+        }
+
+        void testPatchJson() {
+
+            QString jsonString = "{\n"
+                "  \"name\": \"Room A\",\n"
+                "  \"description\": \"A \\\"quoted\\\",\\n multi-line description\",\n"
+                "  \"portals\": [ \"portal:3\", \"portal:4\" ],\n"
+                "  \"position\": [ 0, 0, 0 ],\n"
+                "  \"triggers\": { \"onenter\": \"(function() { return false; })\" },\n"
+                "  \"type\": \"Room\"\n"
+            "}";
+
+            // patching without modifications keeps the document as it is
+            QCOMPARE(StorageBackend::patchJson(jsonString, QMap<QString, QString>()), jsonString);
+
+            QMap<QString, QString> properties;
+            properties["name"] = "\"Room B\"";
+            properties["portals"] = "[ \"portal:5\" ]";
+            properties["position"] = "";
+            properties["flags"] = "\"Dark\"";
+            QString patchedString = StorageBackend::patchJson(jsonString, properties);
+            QCOMPARE(patchedString, QString("{\n"
+                "  \"name\": \"Room B\",\n"
+                "  \"description\": \"A \\\"quoted\\\",\\n multi-line description\",\n"
+                "  \"portals\": [ \"portal:5\" ],\n"
+                "  \"triggers\": { \"onenter\": \"(function() { return false; })\" },\n"
+                "  \"type\": \"Room\",\n"
+                "  \"flags\": \"Dark\"\n"
+            "}"));
+
+            bool ok;
+            QVariantMap map = JsonReader::parse(patchedString, &ok).toMap();
+            QVERIFY(ok);
+            QCOMPARE(map["description"].toString(),
+                     QString("A \"quoted\",\n multi-line description"));
+            QCOMPARE(map["triggers"].toMap().size(), 1);
+
+            // objects that have no stored JSON yet only get the given properties
+            properties.remove("position");
+            QCOMPARE(StorageBackend::patchJson(QString(), properties), QString("{\n"
+                "  \"flags\": \"Dark\",\n"
+                "  \"name\": \"Room B\",\n"
+                "  \"portals\": [ \"portal:5\" ]\n"
+            "}"));
+        }
+
+        void testBackup() {
+
+            QString path = QDir::temp().filePath("plaintext-test-backup.snapshot");
+
+            Realm *realm = Realm::instance();
+            Room *room = (Room *) realm->getObject(GameObjectType::Room, 1);
+            QString name = room->name();
+
+            QVERIFY(realm->startBackup(path));
+            QVERIFY(!realm->startBackup(path));
+
+            // the snapshots are taken by events, after which the backup is written in the
+            // background
+            int waitTimeMs = 0;
+            while (realm->isTakingBackupSnapshots() && waitTimeMs < 5000) {
+                QTest::qWait(20);
+                waitTimeMs += 20;
+            }
+            QVERIFY(!realm->isTakingBackupSnapshots());
+
+            // modifications after the snapshots were taken should not end up in the backup
+            room->setName("Room D");
+
+            QVERIFY(realm->backupThread().wait(5000));
+            QVERIFY(!realm->isBackupInProgress());
+            room->setName(name);
+
+            BinarySnapshotReader reader(path);
+            QVERIFY(reader.open());
+            int index = reader.indexOf("Room", 1);
+            QVERIFY(index > -1);
+            QMap<QString, QString> jsonProperties;
+            QVariantMap properties = reader.objectProperties(index, &jsonProperties);
+            QCOMPARE(properties["name"].toString(), name);
+            QCOMPARE(jsonProperties["portals"], QString("[ \"portal:3\" ]"));
+
+            QFile::remove(path);
+        }
 };
 
 #endif // TEST_SERIALIZATION_H
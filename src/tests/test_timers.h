@@ -0,0 +1,159 @@
+#ifndef TEST_TIMERS_H
+#define TEST_TIMERS_H
+
+#include "testcase.h"
+
+#include <QDateTime>
+#include <QDebug>
+#include <QTest>
+
+#include "tickgroup.h"
+#include "timerwheel.h"
+
+
+class TimersTest : public TestCase {
+
+    Q_OBJECT
+
+    private slots:
+        void testTimerWheel() {
+
+            const int numTimers = 100000;
+            const qint64 startTime = QDateTime::currentMSecsSinceEpoch();
+
+            TimerWheel wheel(startTime);
+
+            qsrand(1);
+
+            {
+                qint64 start = QDateTime::currentMSecsSinceEpoch();
+
+                for (int id = 1; id <= numTimers; id++) {
+                    TimerWheel::Timer timer;
+                    timer.id = id;
+                    timer.timestamp = startTime + 1 + (qrand() % 3600000);
+                    timer.object = nullptr;
+                    timer.interval = 0;
+                    wheel.insert(timer);
+                }
+
+                qint64 end = QDateTime::currentMSecsSinceEpoch();
+                qDebug() << "Inserting" << numTimers << "timers took " << (end - start) << "ms";
+            }
+
+            QCOMPARE(wheel.size(), numTimers);
+            QVERIFY(!wheel.hasExpiredTimers());
+
+            {
+                qint64 start = QDateTime::currentMSecsSinceEpoch();
+
+                for (int id = 2; id <= numTimers; id += 2) {
+                    QVERIFY(wheel.remove(id));
+                }
+
+                qint64 end = QDateTime::currentMSecsSinceEpoch();
+                qDebug() << "Cancelling" << (numTimers / 2) << "timers took " << (end - start) << "ms";
+            }
+
+            QCOMPARE(wheel.size(), numTimers / 2);
+            QVERIFY(!wheel.remove(2));
+
+            {
+                qint64 start = QDateTime::currentMSecsSinceEpoch();
+
+                int numExpired = 0;
+                qint64 lastTimestamp = startTime;
+                qint64 time = startTime;
+                while (!wheel.isEmpty()) {
+                    time = wheel.nextTimeout();
+                    wheel.advance(time);
+                    while (wheel.hasExpiredTimers()) {
+                        TimerWheel::Timer timer = wheel.takeExpiredTimer();
+                        QVERIFY(timer.id % 2 == 1);
+                        QVERIFY(timer.timestamp >= lastTimestamp);
+                        QVERIFY(timer.timestamp <= time);
+                        lastTimestamp = timer.timestamp;
+                        numExpired++;
+                    }
+                }
+
+                qint64 end = QDateTime::currentMSecsSinceEpoch();
+                qDebug() << "Expiring" << numExpired << "timers took " << (end - start) << "ms";
+
+                QCOMPARE(numExpired, numTimers / 2);
+            }
+        }
+
+        void testTimerWheelIntervals() {
+
+            const qint64 startTime = 1000000;
+
+            TimerWheel wheel(startTime);
+
+            TimerWheel::Timer timer;
+            timer.id = 1;
+            timer.timestamp = startTime + 45000;
+            timer.object = nullptr;
+            timer.interval = 45000;
+            wheel.insert(timer);
+
+            wheel.advance(startTime + 44999);
+            QVERIFY(!wheel.hasExpiredTimers());
+
+            for (int i = 1; i <= 10; i++) {
+                wheel.advance(startTime + i * 45000);
+                QVERIFY(wheel.hasExpiredTimers());
+
+                TimerWheel::Timer expired = wheel.takeExpiredTimer();
+                QCOMPARE(expired.id, 1);
+                QCOMPARE(expired.timestamp, startTime + i * 45000);
+
+                expired.timestamp += expired.interval;
+                wheel.insert(expired);
+                QVERIFY(!wheel.hasExpiredTimers());
+                QVERIFY(wheel.nextTimeout() > startTime + i * 45000);
+            }
+
+            QVERIFY(wheel.remove(1));
+            QVERIFY(wheel.isEmpty());
+            QCOMPARE(wheel.nextTimeout(), (qint64) -1);
+        }
+
+        void testTickGroup() {
+
+            const int numObjects = 10000;
+
+            TickGroup group(1, 45000);
+            QCOMPARE(group.numBuckets(), 45);
+            QCOMPARE(group.tickInterval(), 1000);
+
+            QVector<GameObject *> objects;
+            for (int i = 0; i < numObjects; i++) {
+                objects.append(reinterpret_cast<GameObject *>(quintptr(8 * (i + 1))));
+                group.subscribe(objects[i]);
+            }
+
+            for (int i = 0; i < numObjects; i += 3) {
+                group.unsubscribe(objects[i]);
+            }
+            QCOMPARE(group.size(), numObjects - (numObjects + 2) / 3);
+
+            QHash<GameObject *, int> numTicks;
+            int largestBucket = 0;
+            for (int i = 0; i < group.numBuckets(); i++) {
+                QVector<GameObject *> bucket = group.nextBucket();
+                largestBucket = qMax(largestBucket, bucket.size());
+                for (GameObject *object : bucket) {
+                    numTicks[object]++;
+                }
+            }
+
+            QCOMPARE(numTicks.size(), group.size());
+            for (int i = 0; i < numObjects; i++) {
+                QCOMPARE(numTicks.value(objects[i]), i % 3 == 0 ? 0 : 1);
+            }
+            QVERIFY(largestBucket <= numObjects / group.numBuckets() + 1);
+        }
+};
+
+#endif // TEST_TIMERS_H
@@ -7,12 +7,15 @@
 
 #include <QDateTime>
 #include <QDebug>
+#include <QSet>
 #include <QTest>
 
 #include "character.h"
+#include "lineofsightcache.h"
 #include "portal.h"
 #include "realm.h"
 #include "room.h"
+#include "roomgraph.h"
 #include "util.h"
 #include "visualevent.h"
 
@@ -144,6 +147,276 @@ class VisualEventsTest : public TestCase {
             QVERIFY(event->affectedCharacters().contains(m_characters[3]));
         }
 
+        void testOverlappingEvents() {
+
+            int numRooms = m_rooms.length();
+            Room *center = m_rooms[numRooms / 2].cast<Room *>();
+            Room *corner = m_rooms[0].cast<Room *>();
+
+            // both events are alive at the same time, so they must not share their visits
+            VisualEvent *event1 = new VisualEvent(center, 100.0);
+            VisualEvent *event2 = new VisualEvent(corner, 0.5);
+            event1->setDescription("You see a bright white flash.");
+            event2->setDescription("You see a faint glow.");
+
+            event2->fire();
+            int numVisitedRooms = event2->numVisitedRooms();
+            QVERIFY(numVisitedRooms > 1);
+            QVERIFY(numVisitedRooms < numRooms);
+            QVERIFY(event2->affectedCharacters().contains(m_characters[0]));
+            QVERIFY(!event2->affectedCharacters().contains(m_characters[3]));
+
+            event1->fire();
+            QCOMPARE(event1->numVisitedRooms(), numRooms);
+
+            // later events start with a clean slate, even if their visits are recycled
+            VisualEvent *event3 = new VisualEvent(corner, 0.5);
+            event3->setDescription("You see a faint glow.");
+            event3->fire();
+            QCOMPARE(event3->numVisitedRooms(), numVisitedRooms);
+        }
+
+        void testRoomGraph() {
+
+            Realm *realm = Realm::instance();
+            RoomGraph &graph = realm->roomGraph();
+
+            qint64 start = QDateTime::currentMSecsSinceEpoch();
+
+            graph.update();
+
+            qint64 end = QDateTime::currentMSecsSinceEpoch();
+            qDebug() << "Building room graph took " << (end - start) << "ms";
+
+            int numPortals = 0;
+            for (const GameObjectPtr &roomPtr : m_rooms) {
+                Room *room = roomPtr.cast<Room *>();
+                QCOMPARE(graph.edges(room).size(), room->portals().size());
+                numPortals += room->portals().size();
+            }
+            QCOMPARE(numPortals, 2 * (2 * 99 * 100 + 2 * 99 * 99));
+
+            // walk the entire grid the way events used to, and over the room graph
+            Room *origin = m_rooms[m_rooms.length() / 2].cast<Room *>();
+            const int numIterations = 10;
+
+            start = QDateTime::currentMSecsSinceEpoch();
+            for (int i = 0; i < numIterations; i++) {
+                QSet<Room *> visited;
+                QVector<Room *> queue;
+                queue.append(origin);
+                visited.insert(origin);
+                for (int j = 0; j < queue.size(); j++) {
+                    Room *room = queue[j];
+                    for (const GameObjectPtr &portalPtr : room->portals()) {
+                        Portal *portal = portalPtr.unsafeCast<Portal *>();
+                        Room *room1 = portal->room().unsafeCast<Room *>();
+                        Room *room2 = portal->room2().unsafeCast<Room *>();
+                        Room *oppositeRoom = (room == room1 ? room2 : room1);
+                        if (portal->canSeeThrough() && !visited.contains(oppositeRoom) &&
+                            portal->eventMultiplier(GameEventType::Visual) > 0.0) {
+                            visited.insert(oppositeRoom);
+                            queue.append(oppositeRoom);
+                        }
+                    }
+                }
+                QCOMPARE(queue.size(), 10000);
+            }
+            end = QDateTime::currentMSecsSinceEpoch();
+            qint64 portalTime = end - start;
+
+            start = QDateTime::currentMSecsSinceEpoch();
+            for (int i = 0; i < numIterations; i++) {
+                QSet<Room *> visited;
+                QVector<Room *> queue;
+                queue.append(origin);
+                visited.insert(origin);
+                for (int j = 0; j < queue.size(); j++) {
+                    for (const RoomEdge &edge : graph.edges(queue[j])) {
+                        if (edge.canSeeThrough() && !visited.contains(edge.oppositeRoom) &&
+                            edge.eventMultiplier(GameEventType::Visual) > 0.0) {
+                            visited.insert(edge.oppositeRoom);
+                            queue.append(edge.oppositeRoom);
+                        }
+                    }
+                }
+                QCOMPARE(queue.size(), 10000);
+            }
+            end = QDateTime::currentMSecsSinceEpoch();
+            qint64 graphTime = end - start;
+
+            qDebug() << "Walking the grid" << numIterations << "times took" << portalTime
+                     << "ms over portals and" << graphTime << "ms over the room graph";
+
+            start = QDateTime::currentMSecsSinceEpoch();
+            for (int i = 0; i < numIterations; i++) {
+                VisualEvent *event = new VisualEvent(origin, 100.0);
+                event->setDescription("You see a bright white flash.");
+                event->fire();
+                QCOMPARE(event->numVisitedRooms(), 10000);
+            }
+            end = QDateTime::currentMSecsSinceEpoch();
+            qDebug() << "Firing" << numIterations << "visual events took" << (end - start) << "ms";
+
+            // closing a portal patches its edges in place
+            Room *room = m_rooms[0].cast<Room *>();
+            Portal *portal = room->portals()[0].cast<Portal *>();
+            portal->setFlags(PortalFlags::NoFlags);
+            for (const RoomEdge &edge : graph.edges(room)) {
+                QCOMPARE(edge.canSeeThrough(), edge.portalId != portal->id());
+            }
+            portal->setFlags(PortalFlags::CanSeeThrough);
+            for (const RoomEdge &edge : graph.edges(room)) {
+                QVERIFY(edge.canSeeThrough());
+            }
+
+            // removing a portal rewrites the edges of both rooms
+            Room *oppositeRoom = portal->oppositeOf(room).cast<Room *>();
+            room->removePortal(portal);
+            oppositeRoom->removePortal(portal);
+            QCOMPARE(graph.edges(room).size(), room->portals().size());
+            QCOMPARE(graph.edges(oppositeRoom).size(), oppositeRoom->portals().size());
+            for (const RoomEdge &edge : graph.edges(room)) {
+                QVERIFY(edge.oppositeRoom != oppositeRoom);
+            }
+
+            room->addPortal(portal);
+            oppositeRoom->addPortal(portal);
+            QCOMPARE(graph.edges(room).size(), room->portals().size());
+            QCOMPARE(graph.edges(oppositeRoom).size(), oppositeRoom->portals().size());
+        }
+
+        void testLineOfSight() {
+
+            Realm *realm = Realm::instance();
+            LineOfSightCache &cache = realm->lineOfSightCache();
+            cache.clear();
+
+            Room *corner = m_rooms[0].cast<Room *>();
+            QVector<SightLine> sightLines = cache.sightLines(corner, 0.001);
+            QVERIFY(sightLines.size() > 1);
+            QCOMPARE(sightLines[0].room, corner);
+            QCOMPARE(sightLines[0].attenuation, 1.0);
+            for (int i = 1; i < sightLines.size(); i++) {
+                QVERIFY(sightLines[i].attenuation <= sightLines[i - 1].attenuation);
+                QVERIFY(sightLines[i].room != corner);
+            }
+
+            // cached results are reused, also for a higher minimum attenuation
+            QCOMPARE(cache.sightLines(corner, 0.01).size(), sightLines.size());
+            QCOMPARE(cache.numCachedSightLines(), sightLines.size());
+
+            // closing all portals of the corner leaves only the corner itself
+            for (const GameObjectPtr &portalPtr : corner->portals()) {
+                portalPtr.cast<Portal *>()->setFlags(PortalFlags::NoFlags);
+            }
+            QCOMPARE(cache.sightLines(corner, 0.001).size(), 1);
+
+            for (const GameObjectPtr &portalPtr : corner->portals()) {
+                portalPtr.cast<Portal *>()->setFlags(PortalFlags::CanSeeThrough);
+            }
+            QCOMPARE(cache.sightLines(corner, 0.001).size(), sightLines.size());
+
+            // repeated events from the same room only compute their sight lines once
+            Room *origin = m_rooms[m_rooms.length() / 2].cast<Room *>();
+            const int numIterations = 10;
+
+            qint64 start = QDateTime::currentMSecsSinceEpoch();
+            for (int i = 0; i < numIterations; i++) {
+                VisualEvent *event = new VisualEvent(origin, 100.0);
+                event->setDescription("You see a bright white flash.");
+                event->fire();
+                QCOMPARE(event->numVisitedRooms(), 10000);
+            }
+            qint64 end = QDateTime::currentMSecsSinceEpoch();
+            qDebug() << "Firing" << numIterations << "cached visual events took" << (end - start)
+                     << "ms";
+        }
+
+        void testVisibleRooms() {
+
+            Room *corner = m_rooms[0].cast<Room *>();
+            QVariantList rooms = corner->visibleRooms(100.0);
+            QVERIFY(!rooms.isEmpty());
+            for (const QVariant &variant : rooms) {
+                QVariantMap map = variant.toMap();
+                QVERIFY(map["room"].value<GameObjectPtr>() != corner);
+                QVERIFY(map["strength"].toDouble() >= 0.1);
+            }
+
+            QVERIFY(corner->visibleRooms(0.0).isEmpty());
+        }
+
+        void testDeletedPortal() {
+
+            Realm *realm = Realm::instance();
+            RoomGraph &graph = realm->roomGraph();
+            LineOfSightCache &cache = realm->lineOfSightCache();
+
+            // deleting a portal between two rooms of the grid removes the edges through it
+            Room *corner = m_rooms[0].cast<Room *>();
+            Room *neighbour = m_rooms[1].cast<Room *>();
+            Portal *portal = nullptr;
+            for (const GameObjectPtr &portalPtr : corner->portals()) {
+                if (portalPtr.cast<Portal *>()->oppositeOf(corner) == neighbour) {
+                    portal = portalPtr.cast<Portal *>();
+                }
+            }
+            QVERIFY(portal);
+            uint portalId = portal->id();
+            delete portal;
+
+            QCOMPARE(graph.edges(corner).size(), corner->portals().size());
+            for (const RoomEdge &edge : graph.edges(corner)) {
+                QVERIFY(edge.portalId != portalId);
+                QVERIFY(edge.oppositeRoom != neighbour);
+            }
+            QCOMPARE(graph.edges(neighbour).size(), neighbour->portals().size());
+            for (const RoomEdge &edge : graph.edges(neighbour)) {
+                QVERIFY(edge.portalId != portalId);
+                QVERIFY(edge.oppositeRoom != corner);
+            }
+
+            // two rooms that only see each other through a single portal
+            Room *roomA = new Room(realm);
+            roomA->setPosition(Point3D(0, 0, 1000));
+            Room *roomB = new Room(realm);
+            roomB->setPosition(Point3D(20, 0, 1000));
+            connectRooms(roomA, roomB);
+            Character *character = new Character(realm);
+            character->setName("Character E");
+            roomB->addCharacter(character);
+            character->setCurrentRoom(roomB);
+
+            QCOMPARE(cache.sightLines(roomA, 0.001).size(), 2);
+            QCOMPARE(roomA->visibleRooms(100.0).size(), 1);
+
+            VisualEvent *event = new VisualEvent(roomA, 100.0);
+            event->setDescription("You see a bright white flash.");
+            event->fire();
+            QCOMPARE(event->numVisitedRooms(), 2);
+            QVERIFY(event->affectedCharacters().contains(character));
+
+            delete roomA->portals()[0].cast<Portal *>();
+            QVERIFY(roomA->portals().isEmpty());
+            QVERIFY(roomB->portals().isEmpty());
+
+            // the cached sight lines are not reused for seeing through the deleted portal
+            QCOMPARE(cache.sightLines(roomA, 0.001).size(), 1);
+            QVERIFY(roomA->visibleRooms(100.0).isEmpty());
+
+            event = new VisualEvent(roomA, 100.0);
+            event->setDescription("You see a bright white flash.");
+            event->fire();
+            QCOMPARE(event->numVisitedRooms(), 1);
+            QVERIFY(!event->affectedCharacters().contains(character));
+            QCOMPARE(graph.edges(roomA).size(), 0);
+            QCOMPARE(graph.edges(roomB).size(), 0);
+
+            roomB->removeCharacter(character);
+            character->setDeleted();
+        }
+
     private:
         GameObjectPtrList m_rooms;
         GameObjectPtrList m_characters;
@@ -0,0 +1,17 @@
+include(../../../environment.pri)
+
+TARGET = json2snapshot
+
+TEMPLATE = app
+
+SOURCES += \
+    main.cpp \
+    ../../engine/binarysnapshot.cpp \
+    ../../engine/fileutil.cpp \
+
+HEADERS += \
+    ../../engine/binarysnapshot.h \
+    ../../engine/fileutil.h \
+
+INCLUDEPATH += \
+    $$PWD/../../engine \
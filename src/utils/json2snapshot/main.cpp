@@ -0,0 +1,65 @@
+#include <cstdio>
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QStringList>
+
+#include "binarysnapshot.h"
+
+
+/**
+ * Converts the per-object JSON files in a data directory into a binary snapshot, which is
+ * written to the snapshot/ subdirectory of the data directory.
+ *
+ * Usage: json2snapshot [data directory]
+ *
+ * The data directory defaults to PT_DATA_DIR.
+ */
+int main(int argc, char *argv[]) {
+
+    QCoreApplication application(argc, argv);
+
+    QStringList arguments = application.arguments();
+    QString dataDir = (arguments.size() > 1 ? arguments[1] : QString(qgetenv("PT_DATA_DIR")));
+    if (dataDir.isEmpty()) {
+        fprintf(stderr, "Usage: json2snapshot [data directory]\n");
+        return 1;
+    }
+
+    BinarySnapshotWriter writer;
+    int numObjects = 0;
+
+    QDir dir(dataDir);
+    for (const QString &fileName : dir.entryList(QDir::Files)) {
+        QStringList components = fileName.split('.');
+        bool validId;
+        uint id = components.last().toUInt(&validId);
+        if (components.length() != 2 || !validId || components[0] == "realm") {
+            continue;
+        }
+
+        QFile file(dir.filePath(fileName));
+        if (!file.open(QIODevice::ReadOnly)) {
+            fprintf(stderr, "Could not open %s\n", qPrintable(file.fileName()));
+            return 1;
+        }
+
+        writer.addObject(components[0], id, QString::fromUtf8(file.readAll()));
+        numObjects++;
+    }
+
+    if (!dir.exists("snapshot") && !dir.mkdir("snapshot")) {
+        fprintf(stderr, "Could not create %s\n", qPrintable(dir.filePath("snapshot")));
+        return 1;
+    }
+
+    QString path = dir.filePath("snapshot/realm.snapshot");
+    if (!writer.write(path)) {
+        fprintf(stderr, "Could not write %s\n", qPrintable(path));
+        return 1;
+    }
+
+    printf("Wrote %d objects to %s\n", numObjects, qPrintable(path));
+    return 0;
+}
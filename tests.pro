@@ -15,11 +15,17 @@ HEADERS += \
     src/tests/testcase.h \
     src/tests/test_container.h \
     src/tests/test_crashes.h \
+    src/tests/test_eventqueue.h \
     src/tests/test_floodevent.h \
     src/tests/test_help.h \
+    src/tests/test_messagebatch.h \
+    src/tests/test_metrics.h \
     src/tests/test_movement.h \
     src/tests/test_openandclose.h \
+    src/tests/test_playerloading.h \
+    src/tests/test_pointers.h \
     src/tests/test_serialization.h \
+    src/tests/test_timers.h \
     src/tests/test_visualevents.h \
 
 INCLUDEPATH += \